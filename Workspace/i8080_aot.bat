@@ -0,0 +1,3 @@
+@echo off
+xcopy ..\Debug\i8080.exe i8080.exe /y /q /i
+i8080.exe --loglevel 3 -l invaders.h 0 -l invaders.g 2048 -l invaders.f 4096 -l invaders.e 6144 --aot i8080_aot_invaders.c 0,8,10
@@ -0,0 +1,3 @@
+@echo off
+xcopy ..\Debug\i8080.exe i8080.exe /y /q /i
+i8080.exe --loglevel 3 --profile 20
@@ -1,3 +1,4 @@
+#pragma once
 /*
 
 i8080.h
@@ -6,15 +7,92 @@ CPU file
 
 */
 #include "i8080_util.h"
+#include "i8080_alu.h"
+#include "i8080_board.h"
+#include "i8080_hle.h"
+#include "i8080_memo.h"
 #include "log.h"
 
 #include <stdio.h>
 
+// Host pointer to the byte at address as the bus maps it. Only what a read sees on a page with no read handler, code decoded
+// through it is only run where i8080_busReadOnly holds
+I8080_INLINE const uint8_t* i8080_hostPointer(i8080State* state, uint16_t address) {
+	return state->bus->pages[address >> 8].read + (address & 0xFF);
+}
+
+// Reads the byte at address through the bus, the read handler of its page included. i8080op_readMemory without the memo recording
+I8080_INLINE uint8_t i8080_busRead(i8080State* state, uint16_t address) {
+	const i8080BusPage* page = &state->bus->pages[address >> 8];
+	return page->onRead == NULL ? page->read[address & 0xFF] : page->onRead(state, address);
+}
+
+// Instruction fetch at address. Returns the opcode there and reads only the operand bytes instructionParams gives it, leaving the others 0
+I8080_INLINE uint8_t i8080_fetchAt(i8080State* state, uint16_t address, uint8_t* byte1, uint8_t* byte2) {
+	const i8080BusPage* page = &state->bus->pages[address >> 8];
+	uint8_t opcode;
+	uint8_t length;
+
+	*byte1 = 0;
+	*byte2 = 0;
+	// The operands are on the page of the opcode unless it sits at the end of one, the address then carries into the next page or
+	// wraps to 0x0000. Those and pages with a read handler are read a byte at a time through the bus
+	if (page->onRead == NULL && (address & 0xFF) <= 0xFD) {
+		const uint8_t* code = page->read + (address & 0xFF);
+		opcode = code[0];
+		length = instructionParams[opcode][PARAMS_BYTE_LEN];
+		if (length > 1) {
+			*byte1 = code[1];
+			if (length > 2)
+				*byte2 = code[2];
+		}
+	}
+	else {
+		opcode = i8080_busRead(state, address);
+		length = instructionParams[opcode][PARAMS_BYTE_LEN];
+		if (length > 1) {
+			*byte1 = i8080_busRead(state, address + 1);
+			if (length > 2)
+				*byte2 = i8080_busRead(state, address + 2);
+		}
+	}
+	return opcode;
+}
+
+// Instruction fetch at the pc
+I8080_INLINE uint8_t i8080_fetch(i8080State* state, uint8_t* byte1, uint8_t* byte2) {
+	return i8080_fetchAt(state, state->pc, byte1, byte2);
+}
+
+// Allocates a state on a cache line of its own and runs init8080 on it, exiting if it cannot be allocated
+i8080State* i8080_createState(void);
+
+// Frees a state from i8080_createState with its memory, caches and debug block
+void i8080_destroyState(i8080State* state);
+
 // Process one cpu cycle of time length state->clockFreqMHz
 void i8080_cpuTick(i8080State* state);
 
-// Executes an opcode and changes the state accordingly. Massive switch statement function
-bool i8080_executeOpcode(i8080State* state, uint8_t opcode);
+// Runs whole instructions until at least cycleBudget clock cycles have been used, stopping early on HLT or a panic, timed as state->timing asks. Returns the cycles actually used, including the overshoot of the last instruction
+int i8080_run(i8080State* state, int cycleBudget);
+
+// Executes the instruction at the pc through the core selected in state->core. Returns the number of clock cycles it took. With state->traced set it also does the trace bookkeeping and runs the instrumented switch core
+int i8080_executeInstruction(i8080State* state);
+
+// Records the opcode about to execute at the pc in the opcode use table and instruction trace
+void i8080_traceInstruction(i8080State* state, uint8_t opcode);
+
+// Executes an opcode with the operand bytes i8080_fetch gave it and changes the state accordingly. Massive switch statement function, built from i8080_execute.h without tracing
+bool i8080_executeOpcode(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2);
+
+// The same switch built with a log_trace for every instruction
+bool i8080_executeOpcodeTraced(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2);
+
+// Reads the value of an input port
+uint8_t port_in(i8080State* state, uint8_t port);
+
+// Writes a value to an output port
+void port_out(i8080State* state, uint8_t port, uint8_t value);
 
 // Outputs to the log that we have an unimplemented opcode
 void unimplementedOpcode(i8080State* state, uint8_t opcode);
@@ -22,6 +100,23 @@ void unimplementedOpcode(i8080State* state, uint8_t opcode);
 // Check for interrupts
 void checkInterrupts(i8080State* state);
 
+// Looks for a short loop through the address that ends in a jump back and only reads registers and memory, and makes it the idle loop of the state
+void i8080_idleDetect(i8080State* state, uint16_t address);
+
+// For a pc on the idle loop head. If the last pass round the loop left the registers as they were, skips the whole passes that end before the budget runs out and the next interrupt is due, adding them to cyclesExecuted and interruptAccumulator. Returns the cycles skipped
+int i8080_idleSkip(i8080State* state, int cyclesUsed, int cycleBudget);
+
+// Fast forwards through the idle loop, for the run loops of the cores straight after checkInterrupts
+#define I8080_IDLE_CHECK(state, cyclesUsed, cycleBudget) \
+	if ((state)->pc == (state)->idle.head) \
+		(cyclesUsed) += i8080_idleSkip((state), (cyclesUsed), (cycleBudget))
+
+// Halts the processor as HLT does, until an interrupt puts it back in the mode it was in
+void i8080_halt(i8080State* state);
+
+// Sleeps a halted processor, whose interrupt timing is at accumulator, for up to cycleBudget cycles. Wakes it if the next frame interrupt comes within them, for the run loop to deliver. Returns the cycles slept, for the caller to add to its counts. A processor no interrupt can wake does not sleep at all
+int i8080_haltSleep(i8080State* state, unsigned int accumulator, int cycleBudget);
+
 // Causes the processor to panic and halt execution immediately
 void i8080_panic(i8080State* state);
 
@@ -34,6 +129,9 @@ uint8_t i8080op_readMemory(i8080State* state, uint16_t index);
 // Writes to memory at the index
 void i8080op_writeMemory(i8080State* state, uint16_t index, uint8_t value);
 
+// Returns the index actually backing a memory address once mirroring is applied
+uint16_t i8080op_mirrorAddress(i8080State* state, uint16_t index);
+
 // Sets the PC
 void i8080op_setPC(i8080State* state, uint16_t v);
 
@@ -62,29 +160,35 @@ void i8080op_executeInterrupt(i8080State* state, uint16_t address);
 uint16_t i8080op_getPSW(i8080State* state);
 
 // returns the 16 bit register BC
-uint16_t i8080op_getBC(i8080State* state);
+I8080_INLINE uint16_t i8080op_getBC(i8080State* state) { return state->bc; }
 
 // returns the 16 bit register DE
-uint16_t i8080op_getDE(i8080State* state);
+I8080_INLINE uint16_t i8080op_getDE(i8080State* state) { return state->de; }
 
 // returns the 16 bit register HL
-uint16_t i8080op_getHL(i8080State* state);
+I8080_INLINE uint16_t i8080op_getHL(i8080State* state) { return state->hl; }
 
 // Puts a value into BC
-void i8080op_putBC8(i8080State* state, uint8_t ubyte, uint8_t lbyte);
-void i8080op_putBC16(i8080State* state, uint16_t);
+I8080_INLINE void i8080op_putBC8(i8080State* state, uint8_t ubyte, uint8_t lbyte) { state->b = ubyte; state->c = lbyte; }
+I8080_INLINE void i8080op_putBC16(i8080State* state, uint16_t v) { state->bc = v; }
 
 // Puts a value into DE
-void i8080op_putDE8(i8080State* state, uint8_t ubyte, uint8_t lbyte);
-void i8080op_putDE16(i8080State* state, uint16_t);
+I8080_INLINE void i8080op_putDE8(i8080State* state, uint8_t ubyte, uint8_t lbyte) { state->d = ubyte; state->e = lbyte; }
+I8080_INLINE void i8080op_putDE16(i8080State* state, uint16_t v) { state->de = v; }
 
 // Puts a value into HL
-void i8080op_putHL8(i8080State* state, uint8_t ubyte, uint8_t lbyte);
-void i8080op_putHL16(i8080State* state, uint16_t);
+I8080_INLINE void i8080op_putHL8(i8080State* state, uint8_t ubyte, uint8_t lbyte) { state->h = ubyte; state->l = lbyte; }
+I8080_INLINE void i8080op_putHL16(i8080State* state, uint16_t v) { state->hl = v; }
 
 // Sets the Z, S, P flags accordingly
 void i8080op_setZSP(i8080State* state, uint8_t v);
 
+// Builds the s, z, p and ac flags left by the last ALU instruction of a handler core. Returns the now up to date flags
+flagRegister* i8080op_resolveFlags(i8080State* state);
+
+// The flags of the state with any deferred update applied. Reading s, z, p or ac inside a run has to go through this
+#define I8080_FLAGS(state) ((state)->lazyFlags != LAZY_NONE ? i8080op_resolveFlags(state) : &(state)->f)
+
 // Uses an 8 bit var to reconstruct the flags
 void i8080op_putFlags(i8080State* state, uint8_t fv);
 
@@ -104,4 +208,16 @@ uint8_t i8080op_addCarry8(i8080State* state, uint8_t a, uint8_t b);
 uint16_t i8080op_subCarry16(i8080State* state, uint16_t a, uint16_t b);
 
 // Subtracts two 8 bit numbers and sets the carry flag as appropriate
-uint8_t i8080op_subCarry8(i8080State* state, uint8_t a, uint8_t b);
\ No newline at end of file
+uint8_t i8080op_subCarry8(i8080State* state, uint8_t a, uint8_t b);
+
+// ADD/ADC of v and the carry to A, setting every flag. Reads the ALU tables when built with I8080_ALU_TABLES
+void i8080op_aluAdd(i8080State* state, uint8_t v, uint8_t carry);
+
+// SUB/SBB of v and the borrow from A, setting every flag. Reads the ALU tables when built with I8080_ALU_TABLES
+void i8080op_aluSub(i8080State* state, uint8_t v, uint8_t borrow);
+
+// CMP of v with A, setting every flag and leaving A alone. Reads the ALU tables when built with I8080_ALU_TABLES
+void i8080op_aluCmp(i8080State* state, uint8_t v);
+
+// DAA of A, setting the ac and c flags. Reads the ALU tables when built with I8080_ALU_TABLES
+void i8080op_aluDaa(i8080State* state);
\ No newline at end of file
@@ -7,6 +7,9 @@ Main file
 */
 
 #include "i8080_test.h"
+#include "i8080_bench.h"
+#include "i8080_jit.h"
+#include "i8080_aot.h"
 #include "i8080.h"
 
 #include "log.h"
@@ -34,8 +37,6 @@ void renderStateInfo(i8080State* state, float frameTimeMillis);
 void updateVideoBuffer(i8080State* state, sfImage* img);
 // Process the switches in the program args
 void processSwitches(i8080State* state, int argc, char** argv);
-// Processes the external shift register
-void processExternShiftRegister(i8080State* state);
 
 // var defs
 sfRenderWindow* window = NULL; // window handle
@@ -44,12 +45,9 @@ sfFont* font = NULL;
 sfSprite* videoSprite = NULL;
 sfImage* videoImg = NULL;
 
-uint8_t shift0 = 0;
-uint8_t shift1 = 0;
-uint8_t shiftOffset = 0;
-
 bool shouldClose = false;
 bool showStats = false;
+bool traceLog = false; // --loglevel 0, every instruction goes to the log so the traced core always runs
 
 #define TEXT_SIZE 14
 
@@ -68,19 +66,14 @@ int main(int argc, char** argv) {
 	log_set_level(LOG_INFO);
 
 	// Init the 8080
-	i8080State* state = malloc(sizeof(i8080State));
-	if (state == NULL) {
-		log_fatal("Failed to allocate space for i8080 state");
-	}
-
-	init8080(state);
+	i8080State* state = i8080_createState();
 	
 	processSwitches(state, argc, argv);
 
 	// Init the graphics
 	log_info("--- Init graphics ---");
-	log_info("videoMemory: %04X, dimensions (%i, %i)", state->vid.startAddress, state->vid.width, state->vid.height);
-	initGraphics(state->vid.width, state->vid.height);
+	log_info("videoMemory: %04X, dimensions (%i, %i)", state->debug->vid.startAddress, state->debug->vid.width, state->debug->vid.height);
+	initGraphics(state->debug->vid.width, state->debug->vid.height);
 	log_info("-- Graphics init complete ---");
 
 	// Create the timer
@@ -90,14 +83,11 @@ int main(int argc, char** argv) {
 	// Timing variables
 	float elapsedTime = 0;
 	float cycle_accumulator = 0;
+	int cycleOvershoot = 0;
 
-	log_info("Initial pc: %04X", state->pc);
+	log_info("Initial pc: %04X, board %s", state->pc, state->bus->board->name);
 	state->mode = MODE_PAUSED;
 
-	// Set the inPort values needed
-	state->inPorts[1] = 0x00;
-	state->inPorts[2] = 0x80;
-
 	// Do emulation
 	while (!shouldClose) {
 		// check events
@@ -112,17 +102,15 @@ int main(int argc, char** argv) {
 		elapsedTime = (float)sfTime_asMicroseconds(time) / 1000.0f;
 		cycle_accumulator += elapsedTime;
 
-		unsigned long cyclesPerFrame = state->clockFreqMHz * MHZ * (elapsedTime / 1000.0f);
+		int cyclesPerFrame = state->clockFreqMHz * MHZ * (elapsedTime / 1000.0f);
 		
-		// Loop only if we are in normal mode
-		while (cyclesPerFrame > 0 && state->mode == MODE_NORMAL) {
-			i8080_cpuTick(state);
-			cyclesPerFrame--;
+		// Run only if we are in normal mode, or halted and sleeping until an interrupt wakes the processor. Whatever the last instruction overshot the frame by comes out of the next frame
+		if (state->mode == MODE_NORMAL || state->mode == MODE_HLT) {
+			cycleOvershoot = i8080_run(state, cyclesPerFrame - cycleOvershoot) - (cyclesPerFrame - cycleOvershoot);
+			if (cycleOvershoot < 0)
+				cycleOvershoot = 0;
 		}
 
-		// Process the shift register specific to space invaders
-		processExternShiftRegister(state);
-		
 		// Update the video buffer
 		updateVideoBuffer(state, videoImg);
 
@@ -143,7 +131,7 @@ int main(int argc, char** argv) {
 		sfRenderWindow_display(window);
 	}
 
-	// Output the opcodes that were used by the program
+	// Output the opcodes that were used by the program, counted while the traced core ran
 	FILE* fp = fopen("i8080_opcodeUse.log", "w");
 	if (fp == NULL) {
 		log_error("Unable to output opcodeUse table: failed to get file handle");
@@ -152,8 +140,8 @@ int main(int argc, char** argv) {
 		int codesUsed = 0;
 		fprintf(fp, "Opcode use table\n------------------------------------------\n");
 		for (int i = 0; i < 0x100; i++) {
-			if (state->opcodeUse[i] == 1) {
-				fprintf(fp, "%02X: %s\n", i, i8080_decompile(i));
+			if (state->debug->opcodeUse[i] != 0) {
+				fprintf(fp, "%02X: %-10s %u\n", i, i8080_decompile(i), state->debug->opcodeUse[i]);
 				codesUsed++;
 			}
 		}
@@ -162,6 +150,18 @@ int main(int argc, char** argv) {
 		fclose(fp);
 	}
 
+	// Output what the memoisation found out about the routines called
+	if (state->memo != MEMO_OFF) {
+		fp = fopen("i8080_memo.log", "w");
+		if (fp == NULL) {
+			log_error("Unable to output the memoised routines: failed to get file handle");
+		}
+		else {
+			i8080_memoReport(state, fp);
+			fclose(fp);
+		}
+	}
+
 	// Destroy the timer
 	sfClock_destroy(timer);
 
@@ -169,8 +169,7 @@ int main(int argc, char** argv) {
 	closeGraphics();
 
 	// Free the memory
-	free(state->memory);
-	free(state);
+	i8080_destroyState(state);
 
 	// Close the log file
 	fclose(logFile);
@@ -202,6 +201,9 @@ void renderStateInfo(i8080State* state, float frameTimeMillis) {
 	sfText_setString(renderText, ""); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY;
 	sfText_setString(renderText, "Current mode:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace / 1.5;
 	sfText_setString(renderText, getModeStr(state->mode)); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY;
+	pos.x -= xSpace / 1.5;
+	sfText_setString(renderText, "Current core:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace / 1.5;
+	sfText_setString(renderText, getCoreStr(state->core)); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY;
 
 	if(showStats) {
 		#define X_INIT_POS 16
@@ -262,6 +264,18 @@ void renderStateInfo(i8080State* state, float frameTimeMillis) {
 		sfText_setString(renderText, "Cycles executed:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
 		_ultoa(state->cyclesExecuted, buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
 
+		sfText_setString(renderText, "Idle cycles skipped:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
+		_ultoa(state->idle.skippedCycles, buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
+
+		sfText_setString(renderText, "HLE cycles:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
+		_ultoa(i8080_hleCycles(state), buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
+
+		sfText_setString(renderText, "Memo cycles saved:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
+		_ultoa(i8080_memoCyclesSaved(state), buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
+
+		sfText_setString(renderText, "Timing:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
+		sfText_setString(renderText, getTimingStr(state->timing)); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
+
 		pos.y += incY;
 		uint8_t opcode = i8080op_readMemory(state, state->pc);
 		sfText_setString(renderText, "Instruction:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
@@ -281,11 +295,11 @@ void renderStateInfo(i8080State* state, float frameTimeMillis) {
 
 		pos.y += incY;
 		sfText_setString(renderText, "Video Memory Loc:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
-		_itoa(state->vid.startAddress, buf, 16); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
+		_itoa(state->debug->vid.startAddress, buf, 16); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
 
 		sfText_setString(renderText, "Video Memory Dims:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
-		_itoa(state->vid.width, buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace / 4;
-		_itoa(state->vid.height, buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
+		_itoa(state->debug->vid.width, buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace / 4;
+		_itoa(state->debug->vid.height, buf, 10); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY; pos.x = X_INIT_POS;
 
 		pos.y += incY;
 		sfText_setString(renderText, "Extern shift reg:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace;
@@ -352,13 +366,13 @@ void renderStateInfo(i8080State* state, float frameTimeMillis) {
 		pos.x = X_POS_VRAM_COL;
 		pos.y = (10) + 4;
 
-		uint32_t tPixels = state->vid.width * state->vid.height;
+		uint32_t tPixels = state->debug->vid.width * state->debug->vid.height;
 
 		sfText_setString(renderText, "VRAM:"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.y += incY;
 		for (uint32_t i = 1; i <= tPixels; i++) {
 			//log_info("vram %i at %f,%f", i, pos.x, pos.y);
-			//_itoa(i8080op_readMemory(state, i - 1 + state->vid.startAddress), buf, 16); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
-			sfText_setString(renderText, i8080op_readMemory(state, i - 1 + state->vid.startAddress) ? "1": "0"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
+			//_itoa(i8080op_readMemory(state, i - 1 + state->debug->vid.startAddress), buf, 16); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
+			sfText_setString(renderText, i8080op_readMemory(state, i - 1 + state->debug->vid.startAddress) ? "1": "0"); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
 			if (i % 32 == 0) {
 				pos.x = X_POS_VRAM_COL;
 				pos.y += incY / 2;
@@ -382,7 +396,7 @@ void renderStateInfo(i8080State* state, float frameTimeMillis) {
 		// Print the last instructions
 		int maxInstructionTrace = INSTRUCTION_TRACE_LEN > 10 ? 10 : INSTRUCTION_TRACE_LEN;
 		for (int i = 0; i < maxInstructionTrace; i++) {
-			sprintf(buf, "{-%i}[PC:%04X] %s(%02X) (TS:%04X) B1:%02X B2:%02X", i, state->previousInstructions[i].pc, state->previousInstructions[i].statusString, state->previousInstructions[i].opcode, state->previousInstructions[i].topStack, state->previousInstructions[i].b1, state->previousInstructions[i].b2);
+			sprintf(buf, "{-%i}[PC:%04X] %s(%02X) (TS:%04X) B1:%02X B2:%02X", i, state->debug->previousInstructions[i].pc, state->debug->previousInstructions[i].statusString, state->debug->previousInstructions[i].opcode, state->debug->previousInstructions[i].topStack, state->debug->previousInstructions[i].b1, state->debug->previousInstructions[i].b2);
 			sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
 			pos.y += incY;
 		}
@@ -394,7 +408,7 @@ void renderStateInfo(i8080State* state, float frameTimeMillis) {
 		pos.y += incY;
 		for (int i = 0; i < NUMBER_OF_PORTS; i++) {
 			_itoa(i, buf, 16); sfText_setString(renderText, buf); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL); pos.x += xSpace / 4;
-			sfText_setString(renderText, state->outPorts[i].buffer); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
+			sfText_setString(renderText, state->debug->outPortHistory[i]); sfText_setPosition(renderText, pos); sfRenderWindow_drawText(window, renderText, NULL);
 			pos.y += incY; pos.x = X_POS_INST_TRC_COL;
 		}
 	}
@@ -406,9 +420,9 @@ void updateVideoBuffer(i8080State* state, sfImage* img) {
 	sfColor on = sfColor_fromRGB(255, 255, 255);
 	sfColor off = sfColor_fromRGB(0, 0, 0);
 
-	for (int y = 0; y < state->vid.height; y++) {
-		for (int xByte = 0; xByte < state->vid.width / 8; xByte++) {
-			uint8_t byte = i8080op_readMemory(state, state->vid.startAddress + xByte + (y * (state->vid.width / 8)));
+	for (int y = 0; y < state->debug->vid.height; y++) {
+		for (int xByte = 0; xByte < state->debug->vid.width / 8; xByte++) {
+			uint8_t byte = i8080op_readMemory(state, state->debug->vid.startAddress + xByte + (y * (state->debug->vid.width / 8)));
 			for (int xBit = 0; xBit < 8; xBit++) {
 				unsigned int bit = byte >> (7 - xBit) & 1;
 				sfImage_setPixel(img, (xByte * 8) + (8 - xBit), y, bit ? on : off);
@@ -417,23 +431,6 @@ void updateVideoBuffer(i8080State* state, sfImage* img) {
 	}
 }
 
-void processExternShiftRegister(i8080State* state) {
-	// Get the value from the shift offset select
-	if (state->outPorts[2].portFilled == true) {
-		state->outPorts[2].portFilled = false;
-		shiftOffset = state->outPorts[2].val & 0x7;
-	}
-	// Get the shift register input
-	if (state->outPorts[4].portFilled == true) {
-		state->outPorts[4].portFilled = false;
-		shift0 = shift1;
-		shift1 = state->outPorts[4].val;
-	}
-	// Output the value to the in port
-	uint16_t v = (shift1 << 8) | shift0;
-	state->inPorts[3] = ((v >> (8 - shiftOffset)) & 0xff);
-}
-
 void handleEvent(const sfEvent* evt, i8080State* state) {
 	switch (evt->type) {
 	case sfEvtClosed:
@@ -444,7 +441,7 @@ void handleEvent(const sfEvent* evt, i8080State* state) {
 	case sfEvtKeyPressed:
 		switch (evt->key.code) {
 		case sfKeyBackspace:
-			state->mode = MODE_HLT;
+			i8080_halt(state);
 			break;
 		case sfKeyP:
 			state->mode = MODE_PAUSED;
@@ -455,20 +452,21 @@ void handleEvent(const sfEvent* evt, i8080State* state) {
 		case sfKeyS:
 			// Step
 			state->mode = MODE_PAUSED;
-			state->waitCycles = 0;
-			i8080_cpuTick(state);
+			i8080_run(state, 1);
 			break;
 		case sfKeyF1:
 			state->mode = MODE_PAUSED;
 			i8080_dump(state);
 			break;
 		case sfKeyF2:
+			// The stats view shows the instruction trace, so it runs the traced core while it is open
 			if (evt->key.shift) {
 				showStats = false;
 			}
 			else {
 				showStats = true;
 			}
+			state->traced = showStats || traceLog;
 			break;
 		case sfKeyEscape:
 			shouldClose = true;
@@ -553,6 +551,20 @@ void processSwitches(i8080State* state, int argc, char** argv) {
 					exit(-1);
 				}
 			}
+			else if (strcmp("--board", argv[i]) == 0) {
+				// Before the switches that load files or set the video, the board puts in its own
+				if ((i + 1) < argc) {
+					const i8080Board* board = i8080_boardFind(argv[i + 1]);
+					if (board == NULL)
+						log_error("Invalid switch %s: expected invaders, cpm or bare, got '%s'", argv[i], argv[i + 1]);
+					else
+						i8080_boardAttach(state, board);
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
 			else if (strcmp("-s", argv[i]) == 0 || strcmp("--speed", argv[i]) == 0) {
 				if ((i + 1) < argc) {
 					float tgtFreq = atof(argv[i + 1]);
@@ -576,7 +588,7 @@ void processSwitches(i8080State* state, int argc, char** argv) {
 						exit(-1);
 					}
 					else {
-						state->vid.startAddress = tgtAddress;
+						state->debug->vid.startAddress = tgtAddress;
 					}
 				}
 				else {
@@ -593,8 +605,8 @@ void processSwitches(i8080State* state, int argc, char** argv) {
 						exit(-1);
 					}
 					else {
-						state->vid.width = x;
-						state->vid.height = y;
+						state->debug->vid.width = x;
+						state->debug->vid.height = y;
 					}
 				}
 				else {
@@ -607,6 +619,8 @@ void processSwitches(i8080State* state, int argc, char** argv) {
 					uint16_t val = atoi(argv[i + 1]);
 					if (val >= 0 && val < 6)
 						log_set_level(val);
+					traceLog = val == LOG_TRACE;
+					state->traced = traceLog;
 				}
 				else {
 					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
@@ -617,6 +631,121 @@ void processSwitches(i8080State* state, int argc, char** argv) {
 				i8080_testProtocol(state);
 				exit(0);
 			}
+			else if (strcmp("--bench", argv[i]) == 0) {
+				i8080_benchProtocol(state);
+				exit(0);
+			}
+			else if (strcmp("--profile", argv[i]) == 0) {
+				if ((i + 1) < argc) {
+					i8080_profileProtocol(state, atoi(argv[i + 1]));
+					exit(0);
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
+			else if (strcmp("--aot", argv[i]) == 0) {
+				// Translate the ROMs loaded so far into C and exit
+				if ((i + 2) < argc) {
+					uint16_t entryPoints[64];
+					int entryCount = 0;
+					char* entry = argv[i + 2];
+					while (*entry != '\0' && entryCount < 64) {
+						char* end;
+						entryPoints[entryCount++] = strtol(entry, &end, 16);
+						if (end == entry || (*end != ',' && *end != '\0')) {
+							log_fatal("Invalid switch '%s': entry points must be hex addresses separated by commas", argv[i]);
+							exit(-1);
+						}
+						entry = *end == ',' ? end + 1 : end;
+					}
+					exit(i8080_aotTranslate(state, entryPoints, entryCount, argv[i + 1], "i8080_aotRun") ? 0 : -1);
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires two arguments!", argv[i]);
+					exit(-1);
+				}
+			}
+			else if (strcmp("--idleskip", argv[i]) == 0) {
+				if ((i + 1) < argc) {
+					if (strcmp("on", argv[i + 1]) == 0 || strcmp("off", argv[i + 1]) == 0)
+						state->idle.enabled = strcmp("on", argv[i + 1]) == 0;
+					else
+						log_error("Invalid switch %s: expected on or off, got '%s'", argv[i], argv[i + 1]);
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
+			else if (strcmp("--hle", argv[i]) == 0) {
+				if ((i + 1) < argc) {
+					int hle;
+					for (hle = HLE_OFF; hle <= HLE_VERIFY; hle++) {
+						if (strcmp(getHleStr(hle), argv[i + 1]) == 0)
+							break;
+					}
+					if (hle > HLE_VERIFY)
+						log_error("Invalid switch %s: expected on, off or verify, got '%s'", argv[i], argv[i + 1]);
+					else
+						state->hle = hle;
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
+			else if (strcmp("--memo", argv[i]) == 0) {
+				if ((i + 1) < argc) {
+					int memo;
+					for (memo = MEMO_OFF; memo <= MEMO_ON; memo++) {
+						if (strcmp(getMemoStr(memo), argv[i + 1]) == 0)
+							break;
+					}
+					if (memo > MEMO_ON)
+						log_error("Invalid switch %s: expected off, profile or on, got '%s'", argv[i], argv[i + 1]);
+					else
+						state->memo = memo;
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
+			else if (strcmp("--timing", argv[i]) == 0) {
+				if ((i + 1) < argc) {
+					if (strcmp(getTimingStr(TIMING_FAST), argv[i + 1]) == 0)
+						state->timing = TIMING_FAST;
+					else if (strcmp(getTimingStr(TIMING_ACCURATE), argv[i + 1]) == 0)
+						state->timing = TIMING_ACCURATE;
+					else
+						log_error("Invalid switch %s: expected fast or accurate, got '%s'", argv[i], argv[i + 1]);
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
+			else if (strcmp("--core", argv[i]) == 0) {
+				if ((i + 1) < argc) {
+					int core;
+					for (core = 0; core < CORE_COUNT; core++) {
+						if (strcmp(getCoreStr(core), argv[i + 1]) == 0)
+							break;
+					}
+					if (core == CORE_COUNT) {
+						log_error("Invalid switch %s: unknown core '%s'", argv[i], argv[i + 1]);
+					}
+					else {
+						state->core = core;
+					}
+				}
+				else {
+					log_fatal("Invalid switch '%s': requires one argument!", argv[i]);
+					exit(-1);
+				}
+			}
 		}
 	}
 	else {
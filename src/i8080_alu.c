@@ -0,0 +1,72 @@
+/*
+
+i8080_alu.c
+
+Table driven ALU. The reference functions give the exact results of the computed path, the tables are filled from them
+
+*/
+
+#include "i8080_alu.h"
+
+i8080AluTables* i8080_aluTables = NULL;
+
+uint16_t i8080alu_add(uint8_t a, uint8_t v, uint8_t carry) {
+	uint8_t r = v + carry;
+	uint16_t sum = (uint16_t)a + r;
+	uint8_t result = (uint8_t)sum;
+	uint8_t flags = FLAG_ONE | i8080_zspTable[result];
+	if (sum > 0xFF)
+		flags |= FLAG_C;
+	if ((result & 0xF) == 0)
+		flags |= FLAG_AC;
+	return ((uint16_t)flags << 8) | result;
+}
+
+uint16_t i8080alu_sub(uint8_t a, uint8_t v, uint8_t borrow) {
+	uint8_t l = a - borrow;
+	uint8_t result = l - v;
+	uint8_t flags = FLAG_ONE | i8080_zspTable[result];
+	if (l < v)
+		flags |= FLAG_C;
+	if ((result & 0xF) != 0)
+		flags |= FLAG_AC;
+	return ((uint16_t)flags << 8) | result;
+}
+
+uint16_t i8080alu_daa(uint8_t a, uint8_t c, uint8_t ac) {
+	if ((a & 0xF) > 0x9 || ac)
+		a = a + 6;
+	uint8_t flags = (a & 0xF) == 0 ? FLAG_AC : 0;
+	if (c) {
+		if (a + 0x60 > 0xFF)
+			flags |= FLAG_C;
+		a = a + 0x60;
+	}
+	return ((uint16_t)flags << 8) | a;
+}
+
+bool i8080_buildAluTables(void) {
+	if (i8080_aluTables != NULL)
+		return true;
+
+	i8080AluTables* tables = malloc(sizeof(i8080AluTables));
+	if (tables == NULL) {
+		log_error("Failed to allocate memory for the ALU tables");
+		return false;
+	}
+
+	for (int carry = 0; carry < 2; carry++) {
+		for (int a = 0; a < 0x100; a++) {
+			for (int v = 0; v < 0x100; v++) {
+				tables->add[carry][a][v] = i8080alu_add(a, v, carry);
+				tables->sub[carry][a][v] = i8080alu_sub(a, v, carry);
+			}
+			tables->daa[carry][0][a] = i8080alu_daa(a, carry, 0);
+			tables->daa[carry][1][a] = i8080alu_daa(a, carry, 1);
+		}
+	}
+
+	i8080_aluTables = tables;
+	log_info("Init: ALU tables built, %i KB", (int)(sizeof(i8080AluTables) / 1024));
+	return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+/*
+
+i8080_alu.h
+
+Table driven ALU. ADD/ADC, SUB/SBB/CMP and DAA are looked up by their inputs instead of being worked out flag by flag.
+Define I8080_ALU_TABLES in the preprocessor definitions of the project to have the cores use the tables, otherwise they
+keep computing the result and flags. The tables are built from the same reference functions either way
+
+*/
+
+#include "i8080_util.h"
+
+#include <stdlib.h>
+
+// An entry holds the 8 bit result in the low byte and the flag byte in the high byte
+#define ALU_RESULT(entry) ((uint8_t)(entry))
+#define ALU_FLAGS(entry) ((uint8_t)((entry) >> 8))
+
+typedef struct i8080AluTables {
+	uint16_t add[2][0x100][0x100]; // [carry in][a][operand], every flag of the PSW
+	uint16_t sub[2][0x100][0x100]; // [borrow in][a][operand], every flag of the PSW. CMP clears ac and keeps a
+	uint16_t daa[2][2][0x100]; // [c][ac][a], only the ac and c bits of the flags
+} i8080AluTables;
+
+// Built by i8080_buildAluTables, NULL until then
+extern i8080AluTables* i8080_aluTables;
+
+// Builds the tables if they are not already. Returns false if they could not be allocated
+bool i8080_buildAluTables(void);
+
+// Reference ADD/ADC, the operand and carry are added first as ADC always has
+uint16_t i8080alu_add(uint8_t a, uint8_t v, uint8_t carry);
+
+// Reference SUB/SBB, the borrow is taken from a first as SBB always has
+uint16_t i8080alu_sub(uint8_t a, uint8_t v, uint8_t borrow);
+
+// Reference DAA, the second correction only looks at the carry as the interpreter always has
+uint16_t i8080alu_daa(uint8_t a, uint8_t c, uint8_t ac);
@@ -0,0 +1,262 @@
+/*
+
+i8080_aot.c
+
+Ahead of time translation of a ROM set into C. Every basic block reachable from the entry points becomes a labelled run of
+statements in one function, static jumps between blocks become gotos and computed ones go through a switch on the pc
+
+*/
+
+#include "i8080_aot.h"
+#include "i8080_blockcache.h"
+
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+// Starts the fingerprint line a translation ends with
+#define AOT_HASH_MARK "Hash = 0x"
+
+// Names of the registers in the low 3 bits of an opcode, NULL for memory
+static const char* aotRegisterNames[8] = { "b", "c", "d", "e", "h", "l", NULL, "a" };
+
+// Returns if the opcode changes the flow of control, which ends a block
+static bool aotEndsBlock(uint8_t opcode) {
+	return (i8080_opcodeInfo[opcode].kind & OPK_JUMP) != 0;
+}
+
+// Returns if execution can carry on at the instruction after the block ending opcode, right away or once a call returns
+static bool aotFallsThrough(uint8_t opcode) {
+	uint16_t kind = i8080_opcodeInfo[opcode].kind;
+	return !(kind & OPK_JUMP) || (kind & (OPK_CONDITIONAL | OPK_CALL));
+}
+
+// Returns the static target of a jump, call or restart, -1 if it has none
+static int aotJumpTarget(uint8_t opcode, uint8_t byte1, uint8_t byte2) {
+	const i8080OpcodeInfo* info = &i8080_opcodeInfo[opcode];
+	if ((info->kind & OPK_JUMP) && info->format == OPFMT_ADDRESS)
+		return (byte2 << 8) | byte1;
+	// RST n calls the address n * 8 held in the opcode itself
+	if (info->kind & OPK_CALL)
+		return opcode & 0x38;
+	return -1;
+}
+
+// Writes C for the instruction if it only moves data between registers. Returns false if it needs its handler
+static bool aotEmitInline(FILE* out, uint8_t opcode, uint8_t byte1, uint8_t byte2) {
+	if (opcode == NOP)
+		return true;
+
+	// MOV r,r
+	if (opcode >= MOV_BB && opcode <= MOV_AA && opcode != HLT) {
+		const char* dst = aotRegisterNames[(opcode >> 3) & 7];
+		const char* src = aotRegisterNames[opcode & 7];
+		if (dst == NULL || src == NULL)
+			return false;
+		if (dst != src)
+			fprintf(out, "\tstate->%s = state->%s;\n", dst, src);
+		return true;
+	}
+
+	switch (opcode) {
+	case MVI_B: case MVI_C: case MVI_D: case MVI_E: case MVI_H: case MVI_L: case MVI_A:
+		fprintf(out, "\tstate->%s = 0x%02X;\n", aotRegisterNames[(opcode >> 3) & 7], byte1);
+		return true;
+	case LXI_B: fprintf(out, "\tstate->bc = 0x%02X%02X;\n", byte2, byte1); return true;
+	case LXI_D: fprintf(out, "\tstate->de = 0x%02X%02X;\n", byte2, byte1); return true;
+	case LXI_H: fprintf(out, "\tstate->hl = 0x%02X%02X;\n", byte2, byte1); return true;
+	case INX_B: fprintf(out, "\tstate->bc++;\n"); return true;
+	case INX_D: fprintf(out, "\tstate->de++;\n"); return true;
+	case INX_H: fprintf(out, "\tstate->hl++;\n"); return true;
+	case DCX_B: fprintf(out, "\tstate->bc--;\n"); return true;
+	case DCX_D: fprintf(out, "\tstate->de--;\n"); return true;
+	case DCX_H: fprintf(out, "\tstate->hl--;\n"); return true;
+	case XCHG: fprintf(out, "\t{ uint16_t t = state->de; state->de = state->hl; state->hl = t; }\n"); return true;
+	case CMA: fprintf(out, "\tstate->a = ~state->a;\n"); return true;
+	case STC: fprintf(out, "\tstate->f.psw |= FLAG_C;\n"); return true;
+	case CMC: fprintf(out, "\tstate->f.psw ^= FLAG_C;\n"); return true;
+	}
+
+	return false;
+}
+
+// Returns the number of instructions in the block starting at pc, 0 if its first instruction runs past the end of the ROM
+static int aotBlockLength(i8080State* state, uint16_t pc) {
+	int count = 0;
+	while (count < BLOCK_MAX_INSTRUCTIONS) {
+		uint8_t opcode = state->memory[pc];
+		if (pc + i8080_getInstructionLength(opcode) > i8080_ROM_SIZE)
+			break;
+		count++;
+		pc += i8080_getInstructionLength(opcode);
+		if (aotEndsBlock(opcode))
+			break;
+	}
+	return count;
+}
+
+// Writes the block starting at pc as a label followed by its instructions and the jumps to the blocks after it
+static void aotEmitBlock(FILE* out, i8080State* state, uint16_t pc, const bool* blockStarts) {
+	int count = aotBlockLength(state, pc);
+
+	// Every instruction but the last has a fixed cycle count
+	int bodyCycles = 0;
+	uint16_t address = pc;
+	for (int i = 0; i < count - 1; i++) {
+		bodyCycles += i8080_getInstructionClockCycles(state->memory[address]);
+		address += i8080_getInstructionLength(state->memory[address]);
+	}
+
+	fprintf(out, "\nblock_%04X:\n\tAOT_GUARD(%i);\n", pc, bodyCycles);
+
+	int cycles = 0;
+	uint16_t lastAddress = pc;
+	address = pc;
+	for (int i = 0; i < count; i++) {
+		uint8_t opcode = state->memory[address];
+		uint8_t byte1 = state->memory[address + 1];
+		uint8_t byte2 = state->memory[address + 2];
+		uint16_t next = address + i8080_getInstructionLength(opcode);
+
+		// The last instruction always goes through its handler so the pc, rx and tx end up as the interpreter leaves them
+		if (i == count - 1 || !aotEmitInline(out, opcode, byte1, byte2)) {
+			fprintf(out, "\tAOT_OP(0x%04X, 0x%02X, 0x%02X, 0x%02X, 0x%04X); // %s\n", address, opcode, byte1, byte2, next, i8080_decompile(opcode));
+			if (i < count - 1)
+				fprintf(out, "\tAOT_CHECK(%i);\n", cycles + i8080_getInstructionClockCycles(opcode));
+		}
+		cycles += i8080_getInstructionClockCycles(opcode);
+		lastAddress = address;
+		address = next;
+	}
+	uint8_t last = state->memory[lastAddress];
+
+	fprintf(out, "\tblockCycles = %i + ((result & OPRESULT_FAILED) ? %i : %i);\n\tAOT_NEXT();\n", bodyCycles,
+		i8080_getFailedInstructionClockCycles(last), i8080_getInstructionClockCycles(last));
+
+	// Jumps straight to the translated blocks the pc can statically reach
+	int target = aotJumpTarget(last, state->memory[lastAddress + 1], state->memory[lastAddress + 2]);
+	if (target >= 0 && target < i8080_ROM_SIZE && blockStarts[target])
+		fprintf(out, "\tif (state->pc == 0x%04X && state->mode == MODE_NORMAL) goto block_%04X;\n", target, target);
+	if (aotFallsThrough(last) && address < i8080_ROM_SIZE && blockStarts[address] && address != target)
+		fprintf(out, "\tif (state->pc == 0x%04X && state->mode == MODE_NORMAL) goto block_%04X;\n", address, address);
+	fprintf(out, "\tgoto dispatch;\n");
+}
+
+bool i8080_aotTranslate(i8080State* state, const uint16_t* entryPoints, int entryCount, const char* path, const char* function) {
+	bool* blockStarts = calloc(i8080_ROM_SIZE, sizeof(bool));
+	uint16_t* pending = malloc(i8080_ROM_SIZE * sizeof(uint16_t));
+	if (blockStarts == NULL || pending == NULL) {
+		log_fatal("Failed to allocate memory for the AOT translation");
+		exit(-1);
+	}
+
+	// Walk every block reachable from the entry points, queueing the blocks its jumps, calls and returns lead to
+	int pendingCount = 0;
+	for (int i = 0; i < entryCount; i++) {
+		if (entryPoints[i] < i8080_ROM_SIZE && !blockStarts[entryPoints[i]]) {
+			blockStarts[entryPoints[i]] = true;
+			pending[pendingCount++] = entryPoints[i];
+		}
+		else if (entryPoints[i] >= i8080_ROM_SIZE) {
+			log_error("AOT entry point %04X is outside of the ROM, ignored", entryPoints[i]);
+		}
+	}
+
+	int blockCount = 0;
+	while (pendingCount > 0) {
+		uint16_t pc = pending[--pendingCount];
+		int count = aotBlockLength(state, pc);
+		if (count == 0) {
+			blockStarts[pc] = false;
+			continue;
+		}
+		blockCount++;
+
+		for (int i = 0; i < count - 1; i++)
+			pc += i8080_getInstructionLength(state->memory[pc]);
+		uint8_t last = state->memory[pc];
+		uint16_t next = pc + i8080_getInstructionLength(last);
+
+		int successors[2] = { aotJumpTarget(last, state->memory[pc + 1], state->memory[pc + 2]), -1 };
+		if (aotFallsThrough(last))
+			successors[1] = next;
+		for (int i = 0; i < 2; i++) {
+			if (successors[i] >= 0 && successors[i] < i8080_ROM_SIZE && !blockStarts[successors[i]]) {
+				blockStarts[successors[i]] = true;
+				pending[pendingCount++] = successors[i];
+			}
+		}
+	}
+
+	FILE* out = fopen(path, "w+b");
+	if (out == NULL) {
+		log_error("Failed to open '%s' for writing", path);
+		free(blockStarts);
+		free(pending);
+		return false;
+	}
+
+	fprintf(out, "/*\n\n%s\n\nGenerated by i8080 --aot, %i blocks from the entry points", path, blockCount);
+	for (int i = 0; i < entryCount; i++)
+		fprintf(out, " %04X", entryPoints[i]);
+	fprintf(out, ". Do not edit\n\n*/\n\n");
+	long codeStart = ftell(out);
+	fprintf(out, "#include \"i8080_aot.h\"\n\n");
+
+	fprintf(out, "int %s(i8080State* state, int cycleBudget) {\n\tint cyclesUsed = 0;\n\tint blockCycles = 0;\n\tuint8_t result = OPRESULT_OK;\n\n", function);
+	fprintf(out, "\tif (cycleBudget <= 0)\n\t\treturn 0;\n\tcheckInterrupts(state);\n\n");
+
+	// Computed jumps, returns, interrupts and the first block all land here
+	fprintf(out, "dispatch:\n\tif (state->mode == MODE_NORMAL) {\n\t\tswitch (state->pc) {\n");
+	for (int pc = 0; pc < i8080_ROM_SIZE; pc++) {
+		if (blockStarts[pc])
+			fprintf(out, "\t\tcase 0x%04X: goto block_%04X;\n", pc, pc);
+	}
+	fprintf(out, "\t\t}\n\t}\n\n");
+
+	// Anything not translated, or a block that does not fit the budget, runs one instruction through the interpreter
+	fprintf(out, "step:\n\tAOT_STEP();\n\tAOT_NEXT();\n\tgoto dispatch;\n\n");
+	fprintf(out, "halted:\n\tcyclesUsed += blockCycles;\n\tstate->cyclesExecuted += blockCycles;\n\tstate->interruptAccumulator += blockCycles;\n\ti8080op_resolveFlags(state);\n\treturn cyclesUsed;\n");
+
+	for (int pc = 0; pc < i8080_ROM_SIZE; pc++) {
+		if (blockStarts[pc])
+			aotEmitBlock(out, state, pc, blockStarts);
+	}
+	fprintf(out, "}\n");
+
+	// The fingerprint covers the code, not the comment above it with the path it was written to
+	uint32_t hash = FNV_OFFSET_BASIS;
+	fseek(out, codeStart, SEEK_SET);
+	for (int c = fgetc(out); c != EOF; c = fgetc(out)) {
+		hash ^= (uint8_t)c;
+		hash *= FNV_PRIME;
+	}
+	fseek(out, 0, SEEK_END);
+	fprintf(out, "\nconst uint32_t %s" AOT_HASH_MARK "%08X;\n", function, hash);
+
+	fclose(out);
+	free(blockStarts);
+	free(pending);
+
+	log_info("Translated %i blocks into '%s'", blockCount, path);
+	return true;
+}
+
+bool i8080_aotReadHash(const char* path, uint32_t* hash) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL)
+		return false;
+
+	// The fingerprint is on the last line
+	char line[256];
+	unsigned int value = 0;
+	bool found = false;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		char* mark = strstr(line, AOT_HASH_MARK);
+		found = mark != NULL && sscanf(mark + strlen(AOT_HASH_MARK), "%8X", &value) == 1;
+	}
+	fclose(file);
+	*hash = value;
+	return found;
+}
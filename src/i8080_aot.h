@@ -0,0 +1,58 @@
+#pragma once
+/*
+
+i8080_aot.h
+
+Ahead of time translation of a ROM set into a C file with the basic blocks reachable from a list of entry points.
+The generated file includes this header and links against the same state, memory and port functions as the emulator.
+It ends with a fingerprint of its code, so a build can tell whether the file it links is what the generator gives today:
+the test protocol keeps i8080_aot_test.c, the translation of the utilTest_memoProgram code, in step with both the
+generator and the switch core
+
+*/
+
+#include "i8080_dispatch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Translates the code in the ROM area (0x0000-0x1FFF) of state->memory reachable from the entry points into a C file at
+// path, defining the run function under the name given and <function>Hash, the FNV-1a of the file from its first #include
+// on. Returns false if nothing could be written
+bool i8080_aotTranslate(i8080State* state, const uint16_t* entryPoints, int entryCount, const char* path, const char* function);
+
+// The fingerprint a translation ends with, read back from the file at path. Returns false if the file has none
+bool i8080_aotReadHash(const char* path, uint32_t* hash);
+
+// Defined by the file --aot generates only. Runs from the pc until at least cycleBudget cycles have been used, stopping
+// early on HLT or a panic, and returns the cycles used including the overshoot of the last instruction, with the flags
+// resolved: the contract of i8080_runThreaded. Translated blocks run in normal mode, anything else is single stepped. Unlike
+// i8080_run it does not finish the waitCycles of i8080_cpuTick, sleep through a halt or skip idle loops, HLE or memoised calls
+int i8080_aotRun(i8080State* state, int cycleBudget);
+
+/* Used by the generated code, which keeps cyclesUsed, blockCycles and result as locals */
+// Runs one instruction at address through its handler, leaving the pc at nextAddress unless the handler moved it
+#define AOT_OP(address, opcode, byte1, byte2, nextAddress) \
+	state->pc = address; state->f.rx = false; state->f.tx = false; \
+	result = i8080_opHandlers[opcode](state, opcode, byte1, byte2); \
+	if (!(result & OPRESULT_JUMPED)) state->pc = nextAddress
+
+// Runs the instruction at the pc through its handler as the blocks do, whatever core the state is set to, since the switch
+// core does not keep the deferred flags the handlers leave
+#define AOT_STEP() \
+	{ uint8_t opcode, byte1, byte2; opcode = i8080_fetch(state, &byte1, &byte2); \
+	blockCycles = i8080_dispatchOpcode(state, opcode, byte1, byte2) ? i8080_getInstructionClockCycles(opcode) : i8080_getFailedInstructionClockCycles(opcode); }
+
+// Leaves the block with the cycles used so far if the last instruction halted the processor
+#define AOT_CHECK(cycles) \
+	if (state->mode == MODE_HLT || state->mode == MODE_PANIC) { blockCycles = cycles; goto halted; }
+
+// Single steps instead of running the block if an instruction but the last could reach the end of the budget or the next interrupt
+#define AOT_GUARD(bodyCycles) \
+	if (cyclesUsed + bodyCycles >= cycleBudget || state->interruptAccumulator + bodyCycles >= state->bus->board->interruptPeriod) goto step
+
+// Accounts for the block just run and returns once the budget is used up, otherwise checks for interrupts before the next block
+#define AOT_NEXT() \
+	cyclesUsed += blockCycles; state->cyclesExecuted += blockCycles; state->interruptAccumulator += blockCycles; \
+	if (state->mode == MODE_HLT || state->mode == MODE_PANIC || cyclesUsed >= cycleBudget) { i8080op_resolveFlags(state); return cyclesUsed; } \
+	checkInterrupts(state)
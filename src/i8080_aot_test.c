@@ -0,0 +1,736 @@
+/*
+
+i8080_aot_test.c
+
+Generated by i8080 --aot, 70 blocks from the entry points 0100 0008 0010. Do not edit
+
+*/
+
+#include "i8080_aot.h"
+
+int i8080_aotTestRun(i8080State* state, int cycleBudget) {
+	int cyclesUsed = 0;
+	int blockCycles = 0;
+	uint8_t result = OPRESULT_OK;
+
+	if (cycleBudget <= 0)
+		return 0;
+	checkInterrupts(state);
+
+dispatch:
+	if (state->mode == MODE_NORMAL) {
+		switch (state->pc) {
+		case 0x0008: goto block_0008;
+		case 0x0010: goto block_0010;
+		case 0x0040: goto block_0040;
+		case 0x0100: goto block_0100;
+		case 0x0104: goto block_0104;
+		case 0x0107: goto block_0107;
+		case 0x010A: goto block_010A;
+		case 0x010D: goto block_010D;
+		case 0x0117: goto block_0117;
+		case 0x0123: goto block_0123;
+		case 0x0143: goto block_0143;
+		case 0x0163: goto block_0163;
+		case 0x0183: goto block_0183;
+		case 0x01A3: goto block_01A3;
+		case 0x01C3: goto block_01C3;
+		case 0x01E3: goto block_01E3;
+		case 0x0203: goto block_0203;
+		case 0x0223: goto block_0223;
+		case 0x0243: goto block_0243;
+		case 0x0263: goto block_0263;
+		case 0x0283: goto block_0283;
+		case 0x02A3: goto block_02A3;
+		case 0x02C3: goto block_02C3;
+		case 0x02E3: goto block_02E3;
+		case 0x0303: goto block_0303;
+		case 0x0323: goto block_0323;
+		case 0x0343: goto block_0343;
+		case 0x0363: goto block_0363;
+		case 0x0383: goto block_0383;
+		case 0x03A3: goto block_03A3;
+		case 0x03C3: goto block_03C3;
+		case 0x03E3: goto block_03E3;
+		case 0x0403: goto block_0403;
+		case 0x0423: goto block_0423;
+		case 0x0443: goto block_0443;
+		case 0x0463: goto block_0463;
+		case 0x0483: goto block_0483;
+		case 0x04A3: goto block_04A3;
+		case 0x04C3: goto block_04C3;
+		case 0x04E3: goto block_04E3;
+		case 0x0503: goto block_0503;
+		case 0x0523: goto block_0523;
+		case 0x0543: goto block_0543;
+		case 0x0563: goto block_0563;
+		case 0x0583: goto block_0583;
+		case 0x05A3: goto block_05A3;
+		case 0x05C3: goto block_05C3;
+		case 0x05E3: goto block_05E3;
+		case 0x0603: goto block_0603;
+		case 0x0623: goto block_0623;
+		case 0x0643: goto block_0643;
+		case 0x0663: goto block_0663;
+		case 0x0683: goto block_0683;
+		case 0x06A3: goto block_06A3;
+		case 0x06C3: goto block_06C3;
+		case 0x06E3: goto block_06E3;
+		case 0x0703: goto block_0703;
+		case 0x0723: goto block_0723;
+		case 0x0743: goto block_0743;
+		case 0x0763: goto block_0763;
+		case 0x0783: goto block_0783;
+		case 0x07A3: goto block_07A3;
+		case 0x07C3: goto block_07C3;
+		case 0x07E3: goto block_07E3;
+		case 0x0800: goto block_0800;
+		case 0x0805: goto block_0805;
+		case 0x0809: goto block_0809;
+		case 0x0810: goto block_0810;
+		case 0x0820: goto block_0820;
+		case 0x0830: goto block_0830;
+		}
+	}
+
+step:
+	AOT_STEP();
+	AOT_NEXT();
+	goto dispatch;
+
+halted:
+	cyclesUsed += blockCycles;
+	state->cyclesExecuted += blockCycles;
+	state->interruptAccumulator += blockCycles;
+	i8080op_resolveFlags(state);
+	return cyclesUsed;
+
+block_0008:
+	AOT_GUARD(0);
+	AOT_OP(0x0008, 0xC3, 0x40, 0x00, 0x000B); // JMP
+	blockCycles = 0 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	if (state->pc == 0x0040 && state->mode == MODE_NORMAL) goto block_0040;
+	goto dispatch;
+
+block_0010:
+	AOT_GUARD(0);
+	AOT_OP(0x0010, 0xC3, 0x40, 0x00, 0x0013); // JMP
+	blockCycles = 0 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	if (state->pc == 0x0040 && state->mode == MODE_NORMAL) goto block_0040;
+	goto dispatch;
+
+block_0040:
+	AOT_GUARD(56);
+	AOT_OP(0x0040, 0xF5, 0x3A, 0xF0, 0x0041); // PUSH PSW
+	AOT_CHECK(11);
+	AOT_OP(0x0041, 0x3A, 0xF0, 0x20, 0x0044); // LDA
+	AOT_CHECK(24);
+	AOT_OP(0x0044, 0x3C, 0x32, 0xF0, 0x0045); // INR A
+	AOT_CHECK(29);
+	AOT_OP(0x0045, 0x32, 0xF0, 0x20, 0x0048); // STA
+	AOT_CHECK(42);
+	AOT_OP(0x0048, 0xF1, 0xFB, 0xC9, 0x0049); // POP PSW
+	AOT_CHECK(52);
+	AOT_OP(0x0049, 0xFB, 0xC9, 0x00, 0x004A); // EI
+	AOT_CHECK(56);
+	AOT_OP(0x004A, 0xC9, 0x00, 0x00, 0x004B); // RET
+	blockCycles = 56 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	goto dispatch;
+
+block_0100:
+	AOT_GUARD(14);
+	AOT_OP(0x0100, 0x31, 0x00, 0x24, 0x0103); // LXI SP
+	AOT_CHECK(10);
+	AOT_OP(0x0103, 0xFB, 0xCD, 0x30, 0x0104); // EI
+	AOT_CHECK(14);
+	AOT_OP(0x0104, 0xCD, 0x30, 0x08, 0x0107); // CALL
+	blockCycles = 14 + ((result & OPRESULT_FAILED) ? 0 : 17);
+	AOT_NEXT();
+	if (state->pc == 0x0830 && state->mode == MODE_NORMAL) goto block_0830;
+	if (state->pc == 0x0107 && state->mode == MODE_NORMAL) goto block_0107;
+	goto dispatch;
+
+block_0104:
+	AOT_GUARD(0);
+	AOT_OP(0x0104, 0xCD, 0x30, 0x08, 0x0107); // CALL
+	blockCycles = 0 + ((result & OPRESULT_FAILED) ? 0 : 17);
+	AOT_NEXT();
+	if (state->pc == 0x0830 && state->mode == MODE_NORMAL) goto block_0830;
+	if (state->pc == 0x0107 && state->mode == MODE_NORMAL) goto block_0107;
+	goto dispatch;
+
+block_0107:
+	AOT_GUARD(0);
+	AOT_OP(0x0107, 0xCD, 0x00, 0x08, 0x010A); // CALL
+	blockCycles = 0 + ((result & OPRESULT_FAILED) ? 0 : 17);
+	AOT_NEXT();
+	if (state->pc == 0x0800 && state->mode == MODE_NORMAL) goto block_0800;
+	if (state->pc == 0x010A && state->mode == MODE_NORMAL) goto block_010A;
+	goto dispatch;
+
+block_010A:
+	AOT_GUARD(0);
+	AOT_OP(0x010A, 0xCD, 0x20, 0x08, 0x010D); // CALL
+	blockCycles = 0 + ((result & OPRESULT_FAILED) ? 0 : 17);
+	AOT_NEXT();
+	if (state->pc == 0x0820 && state->mode == MODE_NORMAL) goto block_0820;
+	if (state->pc == 0x010D && state->mode == MODE_NORMAL) goto block_010D;
+	goto dispatch;
+
+block_010D:
+	AOT_GUARD(31);
+	AOT_OP(0x010D, 0x3A, 0x02, 0x20, 0x0110); // LDA
+	AOT_CHECK(13);
+	AOT_OP(0x0110, 0x3C, 0x32, 0x02, 0x0111); // INR A
+	AOT_CHECK(18);
+	AOT_OP(0x0111, 0x32, 0x02, 0x20, 0x0114); // STA
+	AOT_CHECK(31);
+	AOT_OP(0x0114, 0xC2, 0x04, 0x01, 0x0117); // JNZ
+	blockCycles = 31 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	if (state->pc == 0x0104 && state->mode == MODE_NORMAL) goto block_0104;
+	if (state->pc == 0x0117 && state->mode == MODE_NORMAL) goto block_0117;
+	goto dispatch;
+
+block_0117:
+	AOT_GUARD(38);
+	AOT_OP(0x0117, 0x3A, 0x03, 0x20, 0x011A); // LDA
+	AOT_CHECK(13);
+	AOT_OP(0x011A, 0x3C, 0x32, 0x03, 0x011B); // INR A
+	AOT_CHECK(18);
+	AOT_OP(0x011B, 0x32, 0x03, 0x20, 0x011E); // STA
+	AOT_CHECK(31);
+	AOT_OP(0x011E, 0xFE, 0x08, 0xC2, 0x0120); // CPI
+	AOT_CHECK(38);
+	AOT_OP(0x0120, 0xC2, 0x04, 0x01, 0x0123); // JNZ
+	blockCycles = 38 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	if (state->pc == 0x0104 && state->mode == MODE_NORMAL) goto block_0104;
+	if (state->pc == 0x0123 && state->mode == MODE_NORMAL) goto block_0123;
+	goto dispatch;
+
+block_0123:
+	AOT_GUARD(127);
+	AOT_OP(0x0123, 0xF3, 0x76, 0x00, 0x0124); // DI
+	AOT_CHECK(4);
+	AOT_OP(0x0124, 0x76, 0x00, 0x00, 0x0125); // HLT
+	AOT_CHECK(11);
+	AOT_OP(0x0142, 0x00, 0x00, 0x00, 0x0143); // NOP
+	blockCycles = 127 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0143 && state->mode == MODE_NORMAL) goto block_0143;
+	goto dispatch;
+
+block_0143:
+	AOT_GUARD(124);
+	AOT_OP(0x0162, 0x00, 0x00, 0x00, 0x0163); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0163 && state->mode == MODE_NORMAL) goto block_0163;
+	goto dispatch;
+
+block_0163:
+	AOT_GUARD(124);
+	AOT_OP(0x0182, 0x00, 0x00, 0x00, 0x0183); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0183 && state->mode == MODE_NORMAL) goto block_0183;
+	goto dispatch;
+
+block_0183:
+	AOT_GUARD(124);
+	AOT_OP(0x01A2, 0x00, 0x00, 0x00, 0x01A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x01A3 && state->mode == MODE_NORMAL) goto block_01A3;
+	goto dispatch;
+
+block_01A3:
+	AOT_GUARD(124);
+	AOT_OP(0x01C2, 0x00, 0x00, 0x00, 0x01C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x01C3 && state->mode == MODE_NORMAL) goto block_01C3;
+	goto dispatch;
+
+block_01C3:
+	AOT_GUARD(124);
+	AOT_OP(0x01E2, 0x00, 0x00, 0x00, 0x01E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x01E3 && state->mode == MODE_NORMAL) goto block_01E3;
+	goto dispatch;
+
+block_01E3:
+	AOT_GUARD(124);
+	AOT_OP(0x0202, 0x00, 0x00, 0x00, 0x0203); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0203 && state->mode == MODE_NORMAL) goto block_0203;
+	goto dispatch;
+
+block_0203:
+	AOT_GUARD(124);
+	AOT_OP(0x0222, 0x00, 0x00, 0x00, 0x0223); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0223 && state->mode == MODE_NORMAL) goto block_0223;
+	goto dispatch;
+
+block_0223:
+	AOT_GUARD(124);
+	AOT_OP(0x0242, 0x00, 0x00, 0x00, 0x0243); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0243 && state->mode == MODE_NORMAL) goto block_0243;
+	goto dispatch;
+
+block_0243:
+	AOT_GUARD(124);
+	AOT_OP(0x0262, 0x00, 0x00, 0x00, 0x0263); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0263 && state->mode == MODE_NORMAL) goto block_0263;
+	goto dispatch;
+
+block_0263:
+	AOT_GUARD(124);
+	AOT_OP(0x0282, 0x00, 0x00, 0x00, 0x0283); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0283 && state->mode == MODE_NORMAL) goto block_0283;
+	goto dispatch;
+
+block_0283:
+	AOT_GUARD(124);
+	AOT_OP(0x02A2, 0x00, 0x00, 0x00, 0x02A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x02A3 && state->mode == MODE_NORMAL) goto block_02A3;
+	goto dispatch;
+
+block_02A3:
+	AOT_GUARD(124);
+	AOT_OP(0x02C2, 0x00, 0x00, 0x00, 0x02C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x02C3 && state->mode == MODE_NORMAL) goto block_02C3;
+	goto dispatch;
+
+block_02C3:
+	AOT_GUARD(124);
+	AOT_OP(0x02E2, 0x00, 0x00, 0x00, 0x02E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x02E3 && state->mode == MODE_NORMAL) goto block_02E3;
+	goto dispatch;
+
+block_02E3:
+	AOT_GUARD(124);
+	AOT_OP(0x0302, 0x00, 0x00, 0x00, 0x0303); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0303 && state->mode == MODE_NORMAL) goto block_0303;
+	goto dispatch;
+
+block_0303:
+	AOT_GUARD(124);
+	AOT_OP(0x0322, 0x00, 0x00, 0x00, 0x0323); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0323 && state->mode == MODE_NORMAL) goto block_0323;
+	goto dispatch;
+
+block_0323:
+	AOT_GUARD(124);
+	AOT_OP(0x0342, 0x00, 0x00, 0x00, 0x0343); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0343 && state->mode == MODE_NORMAL) goto block_0343;
+	goto dispatch;
+
+block_0343:
+	AOT_GUARD(124);
+	AOT_OP(0x0362, 0x00, 0x00, 0x00, 0x0363); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0363 && state->mode == MODE_NORMAL) goto block_0363;
+	goto dispatch;
+
+block_0363:
+	AOT_GUARD(124);
+	AOT_OP(0x0382, 0x00, 0x00, 0x00, 0x0383); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0383 && state->mode == MODE_NORMAL) goto block_0383;
+	goto dispatch;
+
+block_0383:
+	AOT_GUARD(124);
+	AOT_OP(0x03A2, 0x00, 0x00, 0x00, 0x03A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x03A3 && state->mode == MODE_NORMAL) goto block_03A3;
+	goto dispatch;
+
+block_03A3:
+	AOT_GUARD(124);
+	AOT_OP(0x03C2, 0x00, 0x00, 0x00, 0x03C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x03C3 && state->mode == MODE_NORMAL) goto block_03C3;
+	goto dispatch;
+
+block_03C3:
+	AOT_GUARD(124);
+	AOT_OP(0x03E2, 0x00, 0x00, 0x00, 0x03E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x03E3 && state->mode == MODE_NORMAL) goto block_03E3;
+	goto dispatch;
+
+block_03E3:
+	AOT_GUARD(124);
+	AOT_OP(0x0402, 0x00, 0x00, 0x00, 0x0403); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0403 && state->mode == MODE_NORMAL) goto block_0403;
+	goto dispatch;
+
+block_0403:
+	AOT_GUARD(124);
+	AOT_OP(0x0422, 0x00, 0x00, 0x00, 0x0423); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0423 && state->mode == MODE_NORMAL) goto block_0423;
+	goto dispatch;
+
+block_0423:
+	AOT_GUARD(124);
+	AOT_OP(0x0442, 0x00, 0x00, 0x00, 0x0443); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0443 && state->mode == MODE_NORMAL) goto block_0443;
+	goto dispatch;
+
+block_0443:
+	AOT_GUARD(124);
+	AOT_OP(0x0462, 0x00, 0x00, 0x00, 0x0463); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0463 && state->mode == MODE_NORMAL) goto block_0463;
+	goto dispatch;
+
+block_0463:
+	AOT_GUARD(124);
+	AOT_OP(0x0482, 0x00, 0x00, 0x00, 0x0483); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0483 && state->mode == MODE_NORMAL) goto block_0483;
+	goto dispatch;
+
+block_0483:
+	AOT_GUARD(124);
+	AOT_OP(0x04A2, 0x00, 0x00, 0x00, 0x04A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x04A3 && state->mode == MODE_NORMAL) goto block_04A3;
+	goto dispatch;
+
+block_04A3:
+	AOT_GUARD(124);
+	AOT_OP(0x04C2, 0x00, 0x00, 0x00, 0x04C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x04C3 && state->mode == MODE_NORMAL) goto block_04C3;
+	goto dispatch;
+
+block_04C3:
+	AOT_GUARD(124);
+	AOT_OP(0x04E2, 0x00, 0x00, 0x00, 0x04E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x04E3 && state->mode == MODE_NORMAL) goto block_04E3;
+	goto dispatch;
+
+block_04E3:
+	AOT_GUARD(124);
+	AOT_OP(0x0502, 0x00, 0x00, 0x00, 0x0503); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0503 && state->mode == MODE_NORMAL) goto block_0503;
+	goto dispatch;
+
+block_0503:
+	AOT_GUARD(124);
+	AOT_OP(0x0522, 0x00, 0x00, 0x00, 0x0523); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0523 && state->mode == MODE_NORMAL) goto block_0523;
+	goto dispatch;
+
+block_0523:
+	AOT_GUARD(124);
+	AOT_OP(0x0542, 0x00, 0x00, 0x00, 0x0543); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0543 && state->mode == MODE_NORMAL) goto block_0543;
+	goto dispatch;
+
+block_0543:
+	AOT_GUARD(124);
+	AOT_OP(0x0562, 0x00, 0x00, 0x00, 0x0563); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0563 && state->mode == MODE_NORMAL) goto block_0563;
+	goto dispatch;
+
+block_0563:
+	AOT_GUARD(124);
+	AOT_OP(0x0582, 0x00, 0x00, 0x00, 0x0583); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0583 && state->mode == MODE_NORMAL) goto block_0583;
+	goto dispatch;
+
+block_0583:
+	AOT_GUARD(124);
+	AOT_OP(0x05A2, 0x00, 0x00, 0x00, 0x05A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x05A3 && state->mode == MODE_NORMAL) goto block_05A3;
+	goto dispatch;
+
+block_05A3:
+	AOT_GUARD(124);
+	AOT_OP(0x05C2, 0x00, 0x00, 0x00, 0x05C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x05C3 && state->mode == MODE_NORMAL) goto block_05C3;
+	goto dispatch;
+
+block_05C3:
+	AOT_GUARD(124);
+	AOT_OP(0x05E2, 0x00, 0x00, 0x00, 0x05E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x05E3 && state->mode == MODE_NORMAL) goto block_05E3;
+	goto dispatch;
+
+block_05E3:
+	AOT_GUARD(124);
+	AOT_OP(0x0602, 0x00, 0x00, 0x00, 0x0603); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0603 && state->mode == MODE_NORMAL) goto block_0603;
+	goto dispatch;
+
+block_0603:
+	AOT_GUARD(124);
+	AOT_OP(0x0622, 0x00, 0x00, 0x00, 0x0623); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0623 && state->mode == MODE_NORMAL) goto block_0623;
+	goto dispatch;
+
+block_0623:
+	AOT_GUARD(124);
+	AOT_OP(0x0642, 0x00, 0x00, 0x00, 0x0643); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0643 && state->mode == MODE_NORMAL) goto block_0643;
+	goto dispatch;
+
+block_0643:
+	AOT_GUARD(124);
+	AOT_OP(0x0662, 0x00, 0x00, 0x00, 0x0663); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0663 && state->mode == MODE_NORMAL) goto block_0663;
+	goto dispatch;
+
+block_0663:
+	AOT_GUARD(124);
+	AOT_OP(0x0682, 0x00, 0x00, 0x00, 0x0683); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0683 && state->mode == MODE_NORMAL) goto block_0683;
+	goto dispatch;
+
+block_0683:
+	AOT_GUARD(124);
+	AOT_OP(0x06A2, 0x00, 0x00, 0x00, 0x06A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x06A3 && state->mode == MODE_NORMAL) goto block_06A3;
+	goto dispatch;
+
+block_06A3:
+	AOT_GUARD(124);
+	AOT_OP(0x06C2, 0x00, 0x00, 0x00, 0x06C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x06C3 && state->mode == MODE_NORMAL) goto block_06C3;
+	goto dispatch;
+
+block_06C3:
+	AOT_GUARD(124);
+	AOT_OP(0x06E2, 0x00, 0x00, 0x00, 0x06E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x06E3 && state->mode == MODE_NORMAL) goto block_06E3;
+	goto dispatch;
+
+block_06E3:
+	AOT_GUARD(124);
+	AOT_OP(0x0702, 0x00, 0x00, 0x00, 0x0703); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0703 && state->mode == MODE_NORMAL) goto block_0703;
+	goto dispatch;
+
+block_0703:
+	AOT_GUARD(124);
+	AOT_OP(0x0722, 0x00, 0x00, 0x00, 0x0723); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0723 && state->mode == MODE_NORMAL) goto block_0723;
+	goto dispatch;
+
+block_0723:
+	AOT_GUARD(124);
+	AOT_OP(0x0742, 0x00, 0x00, 0x00, 0x0743); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0743 && state->mode == MODE_NORMAL) goto block_0743;
+	goto dispatch;
+
+block_0743:
+	AOT_GUARD(124);
+	AOT_OP(0x0762, 0x00, 0x00, 0x00, 0x0763); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0763 && state->mode == MODE_NORMAL) goto block_0763;
+	goto dispatch;
+
+block_0763:
+	AOT_GUARD(124);
+	AOT_OP(0x0782, 0x00, 0x00, 0x00, 0x0783); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x0783 && state->mode == MODE_NORMAL) goto block_0783;
+	goto dispatch;
+
+block_0783:
+	AOT_GUARD(124);
+	AOT_OP(0x07A2, 0x00, 0x00, 0x00, 0x07A3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x07A3 && state->mode == MODE_NORMAL) goto block_07A3;
+	goto dispatch;
+
+block_07A3:
+	AOT_GUARD(124);
+	AOT_OP(0x07C2, 0x00, 0x00, 0x00, 0x07C3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x07C3 && state->mode == MODE_NORMAL) goto block_07C3;
+	goto dispatch;
+
+block_07C3:
+	AOT_GUARD(124);
+	AOT_OP(0x07E2, 0x00, 0x00, 0x00, 0x07E3); // NOP
+	blockCycles = 124 + ((result & OPRESULT_FAILED) ? 0 : 4);
+	AOT_NEXT();
+	if (state->pc == 0x07E3 && state->mode == MODE_NORMAL) goto block_07E3;
+	goto dispatch;
+
+block_07E3:
+	AOT_GUARD(137);
+	AOT_OP(0x0800, 0xE5, 0x21, 0x10, 0x0801); // PUSH H
+	AOT_CHECK(127);
+	state->hl = 0x2010;
+	AOT_OP(0x0804, 0x5E, 0x83, 0xCD, 0x0805); // MOV E,M
+	blockCycles = 137 + ((result & OPRESULT_FAILED) ? 0 : 7);
+	AOT_NEXT();
+	if (state->pc == 0x0805 && state->mode == MODE_NORMAL) goto block_0805;
+	goto dispatch;
+
+block_0800:
+	AOT_GUARD(32);
+	AOT_OP(0x0800, 0xE5, 0x21, 0x10, 0x0801); // PUSH H
+	AOT_CHECK(11);
+	state->hl = 0x2010;
+	AOT_OP(0x0804, 0x5E, 0x83, 0xCD, 0x0805); // MOV E,M
+	AOT_CHECK(28);
+	AOT_OP(0x0805, 0x83, 0xCD, 0x10, 0x0806); // ADD A,E
+	AOT_CHECK(32);
+	AOT_OP(0x0806, 0xCD, 0x10, 0x08, 0x0809); // CALL
+	blockCycles = 32 + ((result & OPRESULT_FAILED) ? 0 : 17);
+	AOT_NEXT();
+	if (state->pc == 0x0810 && state->mode == MODE_NORMAL) goto block_0810;
+	if (state->pc == 0x0809 && state->mode == MODE_NORMAL) goto block_0809;
+	goto dispatch;
+
+block_0805:
+	AOT_GUARD(4);
+	AOT_OP(0x0805, 0x83, 0xCD, 0x10, 0x0806); // ADD A,E
+	AOT_CHECK(4);
+	AOT_OP(0x0806, 0xCD, 0x10, 0x08, 0x0809); // CALL
+	blockCycles = 4 + ((result & OPRESULT_FAILED) ? 0 : 17);
+	AOT_NEXT();
+	if (state->pc == 0x0810 && state->mode == MODE_NORMAL) goto block_0810;
+	if (state->pc == 0x0809 && state->mode == MODE_NORMAL) goto block_0809;
+	goto dispatch;
+
+block_0809:
+	AOT_GUARD(23);
+	AOT_OP(0x0809, 0x32, 0x11, 0x20, 0x080C); // STA
+	AOT_CHECK(13);
+	AOT_OP(0x080C, 0xE1, 0xC9, 0x00, 0x080D); // POP H
+	AOT_CHECK(23);
+	AOT_OP(0x080D, 0xC9, 0x00, 0x00, 0x080E); // RET
+	blockCycles = 23 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	goto dispatch;
+
+block_0810:
+	AOT_GUARD(11);
+	AOT_OP(0x0810, 0x07, 0xEE, 0x5A, 0x0811); // RLC
+	AOT_CHECK(4);
+	AOT_OP(0x0811, 0xEE, 0x5A, 0xC9, 0x0813); // XRI
+	AOT_CHECK(11);
+	AOT_OP(0x0813, 0xC9, 0x00, 0x00, 0x0814); // RET
+	blockCycles = 11 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	goto dispatch;
+
+block_0820:
+	AOT_GUARD(10);
+	AOT_OP(0x0820, 0xDB, 0x01, 0xC9, 0x0822); // IN
+	AOT_CHECK(10);
+	AOT_OP(0x0822, 0xC9, 0x00, 0x00, 0x0823); // RET
+	blockCycles = 10 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	goto dispatch;
+
+block_0830:
+	AOT_GUARD(38);
+	AOT_OP(0x0830, 0x3A, 0x00, 0x20, 0x0833); // LDA
+	AOT_CHECK(13);
+	AOT_OP(0x0833, 0x3C, 0x32, 0x00, 0x0834); // INR A
+	AOT_CHECK(18);
+	AOT_OP(0x0834, 0x32, 0x00, 0x20, 0x0837); // STA
+	AOT_CHECK(31);
+	AOT_OP(0x0837, 0xE6, 0x03, 0xC9, 0x0839); // ANI
+	AOT_CHECK(38);
+	AOT_OP(0x0839, 0xC9, 0x00, 0x00, 0x083A); // RET
+	blockCycles = 38 + ((result & OPRESULT_FAILED) ? 0 : 10);
+	AOT_NEXT();
+	goto dispatch;
+}
+
+const uint32_t i8080_aotTestRunHash = 0x56FED288;
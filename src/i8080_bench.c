@@ -0,0 +1,896 @@
+/*
+
+i8080_bench.c
+
+Benchmark protocol. Runs fixed workloads on every core and reports the emulated speed
+
+*/
+
+#include "i8080_bench.h"
+
+#define BENCH_INVADERS 0
+#define BENCH_CPUTEST 1
+#define BENCH_8080PRE 2
+#define BENCH_WORKLOAD_COUNT 3
+
+// Emulated clock cycles each workload is run for, 10 seconds of a 2MHz 8080
+#define BENCH_CYCLES 20000000
+// Cycles handed to i8080_run per call, roughly a frame
+#define BENCH_SLICE 33333
+// Runs of each workload per core, the fastest is reported
+#define BENCH_REPEATS 3
+// ALU results each way of building the flags is timed over
+#define BENCH_ALU_OPS 20000000
+// Most ALU instructions recorded from a workload for the ALU table replay
+#define BENCH_ALU_TRACE 0x400000
+// Bytes in a cache line, for the share of the ALU tables a workload touches
+#define BENCH_CACHE_LINE 64
+// Frames, of BENCH_SLICE cycles, each machine of the wide core bench is run for
+#define BENCH_WIDE_FRAMES 300
+// Quanta, of BENCH_SLICE cycles, each processor of the system bench is run for
+#define BENCH_SYSTEM_QUANTA 600
+
+#define ALU_TRACE_ADD 0
+#define ALU_TRACE_SUB 1
+#define ALU_TRACE_CMP 2
+#define ALU_TRACE_DAA 3
+
+const char* benchWorkloadNames[BENCH_WORKLOAD_COUNT] = { "invaders", "cputest", "8080pre" };
+
+void i8080_benchProtocol(i8080State* state) {
+	FILE* benchLog = fopen("i8080_bench.log", "w");
+	if (benchLog == NULL) {
+		log_error("Failed to open 'i8080_bench.log' for writing");
+		return;
+	}
+
+	init8080(state);
+	state->idle.enabled = false; // the cores are timed running every instruction, utilBench_idleSkip times the skip
+	state->hle = HLE_OFF; // and utilBench_hle the native routines
+	state->memo = MEMO_OFF; // and utilBench_memo the replayed calls
+
+	fprintf(benchLog, "i8080 Bench protocol.\n");
+	fprintf(benchLog, "State: %d bytes over %d cache lines, debug block %d bytes allocated apart\n",
+		(int)sizeof(i8080State), (int)(sizeof(i8080State) / I8080_CACHE_LINE), (int)sizeof(i8080Debug));
+
+	utilBench_zspCost(benchLog);
+#ifdef I8080_ALU_TABLES
+	fprintf(benchLog, "Cores built with I8080_ALU_TABLES, ADD/SUB/CMP/DAA read the ALU tables\n");
+#else
+	fprintf(benchLog, "Cores built without I8080_ALU_TABLES, ADD/SUB/CMP/DAA are computed\n");
+#endif
+	utilBench_aluReplay(benchLog, state, BENCH_INVADERS);
+	utilBench_aluReplay(benchLog, state, BENCH_CPUTEST);
+
+	for (int workload = 0; workload < BENCH_WORKLOAD_COUNT; workload++) {
+		fprintf(benchLog, "\n--- workload %s ---\n", benchWorkloadNames[workload]);
+
+		// Final state of the switch core, the other cores must finish in exactly the same place
+		uint16_t refPc = 0;
+		uint16_t refPsw = 0;
+		unsigned long refCycles = 0;
+
+		for (int core = 0; core < CORE_COUNT; core++) {
+			float elapsedTimeMs = 0;
+			bool loaded = true;
+			for (int repeat = 0; repeat < BENCH_REPEATS && loaded; repeat++) {
+				loaded = utilBench_loadWorkload(state, workload);
+				state->core = core;
+
+				sfClock* timer = sfClock_create();
+				while (loaded && state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+					i8080_run(state, BENCH_SLICE);
+				}
+				float runTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) / 1000.0f;
+				sfClock_destroy(timer);
+
+				if (repeat == 0 || runTimeMs < elapsedTimeMs)
+					elapsedTimeMs = runTimeMs;
+			}
+			if (!loaded) {
+				fprintf(benchLog, "Workload files missing, skipped\n");
+				break;
+			}
+
+			// One more run on the instrumented core, for its speed and the opcode use table
+			utilBench_loadWorkload(state, workload);
+			state->core = core;
+			state->traced = true;
+			sfClock* tracedTimer = sfClock_create();
+			while (state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+				i8080_run(state, BENCH_SLICE);
+			}
+			float tracedTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(tracedTimer)) / 1000.0f;
+			sfClock_destroy(tracedTimer);
+			state->traced = false;
+
+			if (core == CORE_SWITCH) {
+				refPc = state->pc;
+				refPsw = i8080op_getPSW(state);
+				refCycles = state->cyclesExecuted;
+			}
+			bool matches = state->pc == refPc && i8080op_getPSW(state) == refPsw && state->cyclesExecuted == refCycles;
+
+			float emulatedMHz = elapsedTimeMs > 0 ? (state->cyclesExecuted / (elapsedTimeMs / 1000.0f)) / MHZ : 0;
+			fprintf(benchLog, "Core %-10s: %lu cycles in %10.3f ms, %8.3f MHz (%6.1fx realtime), mode %s, matches switch [%s]\n",
+				getCoreStr(core), state->cyclesExecuted, elapsedTimeMs, emulatedMHz, emulatedMHz / state->clockFreqMHz, getModeStr(state->mode), matches ? "OK" : "FAIL");
+			fprintf(benchLog, "    traced: %8.3f MHz\n", tracedTimeMs > 0 ? (state->cyclesExecuted / (tracedTimeMs / 1000.0f)) / MHZ : 0);
+
+			if (core == CORE_BLOCK || core == CORE_JIT) {
+				fprintf(benchLog, "    block cache: %lu hits, %lu misses, %lu invalidations\n", state->blockCache->hits, state->blockCache->misses, state->blockCache->invalidations);
+			}
+			if (core == CORE_PREDECODED || core == CORE_FUSED) {
+				unsigned long instructions = 0;
+				for (int i = 0; i < 0x100; i++)
+					instructions += state->debug->opcodeUse[i];
+				fprintf(benchLog, "    dispatches: %lu for %lu instructions, %lu (%.1f%%) saved by fused pairs\n",
+					instructions - state->debug->fusedPairs, instructions, state->debug->fusedPairs, instructions > 0 ? 100.0 * state->debug->fusedPairs / instructions : 0.0);
+			}
+			if (core == CORE_JIT && state->blockCache->jit != NULL) {
+				fprintf(benchLog, "    jit: %d bytes of native code\n", state->blockCache->jit->used);
+			}
+		}
+
+		// The final state only shows the cores agree at the end, also step each one beside the switch core and compare after every slice
+		for (int core = CORE_SWITCH + 1; core < CORE_COUNT; core++) {
+			long divergedAt = utilBench_lockstep(state, workload, core, false);
+			if (divergedAt == -2)
+				break;
+			if (divergedAt == -1)
+				fprintf(benchLog, "Core %-10s: lockstep with switch [OK]\n", getCoreStr(core));
+			else
+				fprintf(benchLog, "Core %-10s: lockstep with switch [FAIL] diverged in the slice ending at cycle %ld\n", getCoreStr(core), divergedAt);
+		}
+	}
+
+	utilBench_idleSkip(benchLog, state);
+	utilBench_hle(benchLog, state);
+	utilBench_memo(benchLog, state);
+	utilBench_wide(benchLog);
+	utilBench_system(benchLog);
+
+	fprintf(benchLog, "--------------------------------------------------\nBench complete!\n");
+	fclose(benchLog);
+}
+
+// i8080_isParityEven as it was before the ZSP table, less its log_debug call
+static bool utilBench_parityLoop(uint16_t n) {
+	if (n == 0)
+		return 0;
+
+	unsigned int numOneBits = 0;
+	for (int i = 0; i < 16; i++) {
+		if (((n >> i) & 1) == 1)
+			numOneBits += 1;
+	}
+	return numOneBits % 2 == 0;
+}
+
+void utilBench_zspCost(FILE* benchLog) {
+	fprintf(benchLog, "\n--- ALU flags ---\n");
+
+	// An ADD followed by the s, z and p flags of its result, the way the cores build them. The sum feeds the next add so neither loop can be folded away
+	uint8_t a = 0;
+	uint8_t psw = 0;
+	sfClock* timer = sfClock_create();
+	for (int i = 0; i < BENCH_ALU_OPS; i++) {
+		a += (uint8_t)i + psw;
+		psw = (a & FLAG_S) | (i8080_isZero(a) ? FLAG_Z : 0) | (utilBench_parityLoop(a) ? FLAG_P : 0);
+	}
+	uint8_t loopFlags = psw;
+	float loopNs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) * 1000.0f / BENCH_ALU_OPS;
+
+	a = 0;
+	psw = 0;
+	sfClock_restart(timer);
+	for (int i = 0; i < BENCH_ALU_OPS; i++) {
+		a += (uint8_t)i + psw;
+		psw = i8080_zspTable[a];
+	}
+	float tableNs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) * 1000.0f / BENCH_ALU_OPS;
+	sfClock_destroy(timer);
+
+	// The last flags of each loop are printed so neither can be dropped, and have to agree
+	fprintf(benchLog, "Bit loop  : %6.2f ns per ALU op\nZSP table : %6.2f ns per ALU op (%.1fx), last flags %02X and %02X [%s]\n", loopNs, tableNs, tableNs > 0 ? loopNs / tableNs : 0.0f,
+		loopFlags, psw, loopFlags == psw ? "OK" : "FAIL");
+}
+
+void utilBench_aluReplay(FILE* benchLog, i8080State* state, int workload) {
+	fprintf(benchLog, "\n--- ALU tables, %s ---\n", benchWorkloadNames[workload]);
+	if (!i8080_buildAluTables()) {
+		fprintf(benchLog, "ALU tables could not be allocated, skipped\n");
+		return;
+	}
+	i8080AluTrace* trace = malloc(BENCH_ALU_TRACE * sizeof(i8080AluTrace));
+	bool* linesTouched = calloc(sizeof(i8080AluTables) / BENCH_CACHE_LINE, sizeof(bool));
+	if (trace == NULL || linesTouched == NULL) {
+		log_fatal("Failed to allocate memory for the ALU trace");
+		exit(-1);
+	}
+	if (!utilBench_loadWorkload(state, workload)) {
+		fprintf(benchLog, "Workload files missing, skipped\n");
+		free(trace);
+		free(linesTouched);
+		return;
+	}
+	state->core = CORE_SWITCH;
+
+	// Record the inputs of every table driven instruction the workload runs
+	int count = 0;
+	while (count < BENCH_ALU_TRACE && state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+		checkInterrupts(state);
+		uint8_t opcode = i8080op_readMemory(state, state->pc);
+		uint8_t operand = i8080op_readMemory(state, state->pc + 1);
+		if (opcode >= ADD_B && opcode <= CMP_A) {
+			uint8_t registers[8] = { state->b, state->c, state->d, state->e, state->h, state->l, 0, state->a };
+			operand = (opcode & 7) == 6 ? i8080op_readMemory(state, i8080op_getHL(state)) : registers[opcode & 7];
+		}
+
+		// ADD, SUB and CMP go in with no carry, ADC and SBB with the carry flag and DAA with both c and ac
+		i8080AluTrace entry = { 0xFF, state->a, operand, 0 };
+		if ((opcode >= ADD_B && opcode <= ADD_A) || opcode == ADI)
+			entry.kind = ALU_TRACE_ADD;
+		else if ((opcode >= ADC_B && opcode <= ADC_A) || opcode == ACI) {
+			entry.kind = ALU_TRACE_ADD;
+			entry.carry = GET_FLAG(state, FLAG_C);
+		}
+		else if ((opcode >= SUB_B && opcode <= SUB_A) || opcode == SUI)
+			entry.kind = ALU_TRACE_SUB;
+		else if ((opcode >= SBB_B && opcode <= SBB_A) || opcode == SBI) {
+			entry.kind = ALU_TRACE_SUB;
+			entry.carry = GET_FLAG(state, FLAG_C);
+		}
+		else if ((opcode >= CMP_B && opcode <= CMP_A) || opcode == CPI)
+			entry.kind = ALU_TRACE_CMP;
+		else if (opcode == DAA) {
+			entry.kind = ALU_TRACE_DAA;
+			entry.carry = GET_FLAG(state, FLAG_C) | (GET_FLAG(state, FLAG_AC) << 1);
+		}
+		if (entry.kind != 0xFF)
+			trace[count++] = entry;
+
+		int cycles = i8080_executeInstruction(state);
+		state->cyclesExecuted += cycles;
+		state->interruptAccumulator += cycles;
+	}
+	if (count == 0) {
+		fprintf(benchLog, "No ADD/SUB/CMP/DAA instructions ran, skipped\n");
+		free(trace);
+		free(linesTouched);
+		return;
+	}
+
+	// Replay the trace through the reference functions and through the tables, enough times for at least BENCH_ALU_OPS lookups
+	int passes = (BENCH_ALU_OPS + count - 1) / count;
+	unsigned int sink = 0;
+	sfClock* timer = sfClock_create();
+	for (int pass = 0; pass < passes; pass++) {
+		for (int i = 0; i < count; i++) {
+			i8080AluTrace* t = &trace[i];
+			switch (t->kind) {
+			case ALU_TRACE_ADD: sink += i8080alu_add(t->a, t->operand, t->carry); break;
+			case ALU_TRACE_SUB: sink += i8080alu_sub(t->a, t->operand, t->carry); break;
+			case ALU_TRACE_CMP: sink += i8080alu_sub(t->a, t->operand, 0) >> 8; break;
+			case ALU_TRACE_DAA: sink += i8080alu_daa(t->a, t->carry & 1, t->carry >> 1); break;
+			}
+		}
+	}
+	float computedNs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) * 1000.0f / ((float)passes * count);
+
+	sfClock_restart(timer);
+	for (int pass = 0; pass < passes; pass++) {
+		for (int i = 0; i < count; i++) {
+			i8080AluTrace* t = &trace[i];
+			switch (t->kind) {
+			case ALU_TRACE_ADD: sink += i8080_aluTables->add[t->carry][t->a][t->operand]; break;
+			case ALU_TRACE_SUB: sink += i8080_aluTables->sub[t->carry][t->a][t->operand]; break;
+			case ALU_TRACE_CMP: sink += i8080_aluTables->sub[0][t->a][t->operand] >> 8; break;
+			case ALU_TRACE_DAA: sink += i8080_aluTables->daa[t->carry & 1][t->carry >> 1][t->a]; break;
+			}
+		}
+	}
+	float tableNs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) * 1000.0f / ((float)passes * count);
+	sfClock_destroy(timer);
+
+	// The cache lines of the tables the trace reads, the working set the tables add to the emulator
+	int lines = 0;
+	for (int i = 0; i < count; i++) {
+		i8080AluTrace* t = &trace[i];
+		const uint16_t* entry = NULL;
+		switch (t->kind) {
+		case ALU_TRACE_ADD: entry = &i8080_aluTables->add[t->carry][t->a][t->operand]; break;
+		case ALU_TRACE_SUB: entry = &i8080_aluTables->sub[t->carry][t->a][t->operand]; break;
+		case ALU_TRACE_CMP: entry = &i8080_aluTables->sub[0][t->a][t->operand]; break;
+		case ALU_TRACE_DAA: entry = &i8080_aluTables->daa[t->carry & 1][t->carry >> 1][t->a]; break;
+		}
+		size_t line = ((const uint8_t*)entry - (const uint8_t*)i8080_aluTables) / BENCH_CACHE_LINE;
+		if (!linesTouched[line]) {
+			linesTouched[line] = true;
+			lines++;
+		}
+	}
+
+	fprintf(benchLog, "%i ALU instructions recorded in %lu cycles (checksum %08X)\n", count, state->cyclesExecuted, sink);
+	fprintf(benchLog, "Computed  : %6.2f ns per ALU op\nALU tables: %6.2f ns per ALU op (%.2fx), %i of %i cache lines touched (%i KB of %i KB)\n",
+		computedNs, tableNs, tableNs > 0 ? computedNs / tableNs : 0.0f, lines, (int)(sizeof(i8080AluTables) / BENCH_CACHE_LINE),
+		lines * BENCH_CACHE_LINE / 1024, (int)(sizeof(i8080AluTables) / 1024));
+
+	free(trace);
+	free(linesTouched);
+}
+
+void utilBench_idleSkip(FILE* benchLog, i8080State* state) {
+	fprintf(benchLog, "\n--- idle loop skip, workload %s ---\n", benchWorkloadNames[BENCH_INVADERS]);
+
+	for (int core = 0; core < CORE_COUNT; core++) {
+		float elapsedTimeMs[2] = { 0, 0 };
+		unsigned long skippedCycles = 0;
+		uint16_t refPc = 0;
+		uint16_t refPsw = 0;
+		unsigned long refCycles = 0;
+		bool matches = true;
+
+		// Off then on, the same cycles have to end in the same place either way
+		for (int skip = 0; skip < 2; skip++) {
+			for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+				if (!utilBench_loadWorkload(state, BENCH_INVADERS)) {
+					fprintf(benchLog, "Workload files missing, skipped\n");
+					state->idle.enabled = false;
+					return;
+				}
+				state->core = core;
+				state->idle.enabled = skip;
+
+				sfClock* timer = sfClock_create();
+				while (state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+					i8080_run(state, BENCH_SLICE);
+				}
+				float runTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) / 1000.0f;
+				sfClock_destroy(timer);
+
+				if (repeat == 0 || runTimeMs < elapsedTimeMs[skip])
+					elapsedTimeMs[skip] = runTimeMs;
+			}
+
+			if (skip) {
+				skippedCycles = state->idle.skippedCycles;
+				matches = state->pc == refPc && i8080op_getPSW(state) == refPsw && state->cyclesExecuted == refCycles;
+			}
+			else {
+				refPc = state->pc;
+				refPsw = i8080op_getPSW(state);
+				refCycles = state->cyclesExecuted;
+			}
+		}
+		state->idle.enabled = false;
+
+		float offMHz = elapsedTimeMs[0] > 0 ? (refCycles / (elapsedTimeMs[0] / 1000.0f)) / MHZ : 0;
+		float onMHz = elapsedTimeMs[1] > 0 ? (state->cyclesExecuted / (elapsedTimeMs[1] / 1000.0f)) / MHZ : 0;
+		fprintf(benchLog, "Core %-10s: off %8.3f MHz, on %8.3f MHz (%5.2fx), %lu of %lu cycles (%.1f%%) skipped, matches skip off [%s]\n",
+			getCoreStr(core), offMHz, onMHz, offMHz > 0 ? onMHz / offMHz : 0, skippedCycles, state->cyclesExecuted,
+			state->cyclesExecuted > 0 ? 100.0 * skippedCycles / state->cyclesExecuted : 0.0, matches ? "OK" : "FAIL");
+
+		// The skip has to land exactly where running the loop would have, slice after slice
+		long divergedAt = utilBench_lockstep(state, BENCH_INVADERS, core, true);
+		if (divergedAt == -1)
+			fprintf(benchLog, "Core %-10s: skipping in lockstep with switch [OK]\n", getCoreStr(core));
+		else
+			fprintf(benchLog, "Core %-10s: skipping in lockstep with switch [FAIL] diverged in the slice ending at cycle %ld\n", getCoreStr(core), divergedAt);
+	}
+}
+
+void utilBench_hle(FILE* benchLog, i8080State* state) {
+	fprintf(benchLog, "\n--- HLE, workload %s ---\n", benchWorkloadNames[BENCH_INVADERS]);
+
+	for (int core = 0; core < CORE_COUNT; core++) {
+		float elapsedTimeMs[2] = { 0, 0 };
+		unsigned long nativeCycles = 0;
+		unsigned long runs = 0;
+		uint16_t refPc = 0;
+		uint16_t refPsw = 0;
+		unsigned long refCycles = 0;
+		bool matches = true;
+
+		// Off then on, the same cycles have to end in the same place either way
+		for (int hle = HLE_OFF; hle <= HLE_ON; hle++) {
+			for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+				if (!utilBench_loadWorkload(state, BENCH_INVADERS)) {
+					fprintf(benchLog, "Workload files missing, skipped\n");
+					state->hle = HLE_OFF;
+					return;
+				}
+				state->core = core;
+				state->hle = hle;
+				unsigned long cyclesBefore = i8080_hleCycles(state);
+				unsigned long runsBefore = 0;
+				for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+					runsBefore += i8080_hleFind(state, i) == NULL ? 0 : i8080_hleFind(state, i)->runs;
+				}
+
+				sfClock* timer = sfClock_create();
+				while (state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+					i8080_run(state, BENCH_SLICE);
+				}
+				float runTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) / 1000.0f;
+				sfClock_destroy(timer);
+
+				if (repeat == 0 || runTimeMs < elapsedTimeMs[hle])
+					elapsedTimeMs[hle] = runTimeMs;
+				nativeCycles = i8080_hleCycles(state) - cyclesBefore;
+				runs = 0;
+				for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+					runs += i8080_hleFind(state, i) == NULL ? 0 : i8080_hleFind(state, i)->runs;
+				}
+				runs -= runsBefore;
+			}
+
+			if (hle == HLE_ON) {
+				matches = state->pc == refPc && i8080op_getPSW(state) == refPsw && state->cyclesExecuted == refCycles;
+			}
+			else {
+				refPc = state->pc;
+				refPsw = i8080op_getPSW(state);
+				refCycles = state->cyclesExecuted;
+			}
+		}
+
+		float offMHz = elapsedTimeMs[HLE_OFF] > 0 ? (refCycles / (elapsedTimeMs[HLE_OFF] / 1000.0f)) / MHZ : 0;
+		float onMHz = elapsedTimeMs[HLE_ON] > 0 ? (state->cyclesExecuted / (elapsedTimeMs[HLE_ON] / 1000.0f)) / MHZ : 0;
+		fprintf(benchLog, "Core %-10s: off %8.3f MHz, on %8.3f MHz (%5.2fx), %lu routine runs covering %lu of %lu cycles (%.1f%%), matches HLE off [%s]\n",
+			getCoreStr(core), offMHz, onMHz, offMHz > 0 ? onMHz / offMHz : 0, runs, nativeCycles, state->cyclesExecuted,
+			state->cyclesExecuted > 0 ? 100.0 * nativeCycles / state->cyclesExecuted : 0.0, matches ? "OK" : "FAIL");
+
+		// The native routines have to leave memory and registers exactly as the ROM code does, slice after slice
+		long divergedAt = utilBench_lockstep(state, BENCH_INVADERS, core, false);
+		if (divergedAt == -1)
+			fprintf(benchLog, "Core %-10s: HLE in lockstep with switch [OK]\n", getCoreStr(core));
+		else
+			fprintf(benchLog, "Core %-10s: HLE in lockstep with switch [FAIL] diverged in the slice ending at cycle %ld\n", getCoreStr(core), divergedAt);
+		state->hle = HLE_OFF;
+	}
+
+	for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+		i8080HleFound* found = i8080_hleFind(state, i);
+		fprintf(benchLog, "%-15s: %lu runs, %lu cycles\n", i8080_hleRoutines[i].name, found == NULL ? 0 : found->runs, found == NULL ? 0 : found->cycles);
+	}
+}
+
+void utilBench_memo(FILE* benchLog, i8080State* state) {
+	fprintf(benchLog, "\n--- memoisation, workload %s ---\n", benchWorkloadNames[BENCH_INVADERS]);
+
+	for (int core = 0; core < CORE_COUNT; core++) {
+		if (core == CORE_BLOCK || core == CORE_JIT) {
+			fprintf(benchLog, "Core %-10s: refuses memoisation, skipped\n", getCoreStr(core));
+			continue;
+		}
+
+		float elapsedTimeMs[2] = { 0, 0 };
+		unsigned long hits = 0, misses = 0, saved = 0;
+		uint16_t refPc = 0;
+		uint16_t refPsw = 0;
+		unsigned long refCycles = 0;
+		bool matches = true;
+
+		// Off then on, the same cycles have to end in the same place either way
+		for (int i = 0; i < 2; i++) {
+			int memo = i == 0 ? MEMO_OFF : MEMO_ON;
+			for (int repeat = 0; repeat < BENCH_REPEATS; repeat++) {
+				if (!utilBench_loadWorkload(state, BENCH_INVADERS)) {
+					fprintf(benchLog, "Workload files missing, skipped\n");
+					state->memo = MEMO_OFF;
+					return;
+				}
+				state->core = core;
+				state->memo = memo;
+
+				sfClock* timer = sfClock_create();
+				while (state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+					i8080_run(state, BENCH_SLICE);
+				}
+				float runTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) / 1000.0f;
+				sfClock_destroy(timer);
+
+				if (repeat == 0 || runTimeMs < elapsedTimeMs[i])
+					elapsedTimeMs[i] = runTimeMs;
+			}
+
+			if (memo == MEMO_ON) {
+				matches = state->pc == refPc && i8080op_getPSW(state) == refPsw && state->cyclesExecuted == refCycles;
+				// Loading the workload clears the routines, these are from the last repeat alone
+				for (int j = 0; state->bus->memo != NULL && j < MEMO_ROUTINES; j++) {
+					hits += state->bus->memo->routines[j].hits;
+					misses += state->bus->memo->routines[j].misses;
+				}
+				saved = i8080_memoCyclesSaved(state);
+			}
+			else {
+				refPc = state->pc;
+				refPsw = i8080op_getPSW(state);
+				refCycles = state->cyclesExecuted;
+			}
+		}
+
+		float offMHz = elapsedTimeMs[0] > 0 ? (refCycles / (elapsedTimeMs[0] / 1000.0f)) / MHZ : 0;
+		float onMHz = elapsedTimeMs[1] > 0 ? (state->cyclesExecuted / (elapsedTimeMs[1] / 1000.0f)) / MHZ : 0;
+		fprintf(benchLog, "Core %-10s: off %8.3f MHz, on %8.3f MHz (%5.2fx), %lu calls replayed, %lu missed, covering %lu of %lu cycles (%.1f%%), matches memo off [%s]\n",
+			getCoreStr(core), offMHz, onMHz, offMHz > 0 ? onMHz / offMHz : 0, hits, misses, saved, state->cyclesExecuted,
+			state->cyclesExecuted > 0 ? 100.0 * saved / state->cyclesExecuted : 0.0, matches ? "OK" : "FAIL");
+
+		// A replayed call has to leave memory and registers exactly as running it does, slice after slice
+		if (core == CORE_SWITCH) {
+			i8080_memoReport(state, benchLog);
+		}
+		long divergedAt = utilBench_lockstep(state, BENCH_INVADERS, core, false);
+		if (divergedAt == -1)
+			fprintf(benchLog, "Core %-10s: memoisation in lockstep with switch [OK]\n", getCoreStr(core));
+		else
+			fprintf(benchLog, "Core %-10s: memoisation in lockstep with switch [FAIL] diverged in the slice ending at cycle %ld\n", getCoreStr(core), divergedAt);
+		state->memo = MEMO_OFF;
+	}
+}
+
+void utilBench_wide(FILE* benchLog) {
+	fprintf(benchLog, "\n--- wide core, %d invaders machines ---\n", WIDE_LANES);
+
+	i8080State* machines[WIDE_LANES];
+	for (int i = 0; i < WIDE_LANES; i++) {
+		machines[i] = i8080_createState();
+		machines[i]->idle.enabled = false; // the wide core runs every instruction, so do the scalar cores it is timed against
+	}
+
+	// Where each machine ended up on the switch core, the wide lanes have to end in the same place
+	uint16_t refPc[WIDE_LANES];
+	uint16_t refPsw[WIDE_LANES];
+	unsigned long refCycles[WIDE_LANES];
+	uint8_t* refMemory = malloc(WIDE_LANES * i8080_MEMORY_SIZE);
+	if (refMemory == NULL) {
+		log_fatal("Failed to allocate space for the wide core bench memory");
+		exit(-1);
+	}
+
+	// The scalar cores run the machines one after another, CORE_COUNT stands for the wide core
+	for (int core = 0; core <= CORE_COUNT; core++) {
+		bool loaded = true;
+		for (int i = 0; i < WIDE_LANES && loaded; i++) {
+			loaded = utilBench_loadWorkload(machines[i], BENCH_INVADERS);
+			machines[i]->core = core == CORE_COUNT ? CORE_SWITCH : core;
+			machines[i]->inPorts[1] = i & 0x05; // coin and player 1 start, held in a different combination by each lane
+		}
+		if (!loaded) {
+			fprintf(benchLog, "Workload files missing, skipped\n");
+			break;
+		}
+
+		i8080Wide wide;
+		i8080_wideInit(&wide, machines, WIDE_LANES);
+		sfClock* timer = sfClock_create();
+		if (core == CORE_COUNT) {
+			for (int frame = 0; frame < BENCH_WIDE_FRAMES; frame++)
+				i8080_runWide(&wide, BENCH_SLICE);
+		}
+		else {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				for (int frame = 0; frame < BENCH_WIDE_FRAMES && machines[i]->mode != MODE_HLT && machines[i]->mode != MODE_PANIC; frame++)
+					i8080_run(machines[i], BENCH_SLICE);
+			}
+		}
+		float elapsedTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) / 1000.0f;
+		sfClock_destroy(timer);
+
+		bool matches = true;
+		for (int i = 0; i < WIDE_LANES; i++) {
+			if (core == CORE_SWITCH) {
+				refPc[i] = machines[i]->pc;
+				refPsw[i] = i8080op_getPSW(machines[i]);
+				refCycles[i] = machines[i]->cyclesExecuted;
+				memcpy(refMemory + i * i8080_MEMORY_SIZE, machines[i]->memory, i8080_MEMORY_SIZE);
+			}
+			matches = matches && machines[i]->pc == refPc[i] && i8080op_getPSW(machines[i]) == refPsw[i] && machines[i]->cyclesExecuted == refCycles[i]
+				&& memcmp(refMemory + i * i8080_MEMORY_SIZE, machines[i]->memory, i8080_MEMORY_SIZE) == 0;
+		}
+
+		float frames = (float)WIDE_LANES * BENCH_WIDE_FRAMES;
+		fprintf(benchLog, "Core %-10s: %d machines x %d frames in %10.3f ms, %10.0f machine-frames/s, matches switch [%s]\n",
+			core == CORE_COUNT ? "wide" : getCoreStr(core), WIDE_LANES, BENCH_WIDE_FRAMES, elapsedTimeMs, elapsedTimeMs > 0 ? frames / (elapsedTimeMs / 1000.0f) : 0, matches ? "OK" : "FAIL");
+		if (core == CORE_COUNT) {
+			fprintf(benchLog, "    steps: %lu for %lu lane instructions (%.1f lanes a step), %lu peeled to the switch core\n",
+				wide.steps, wide.laneInstructions, wide.steps > 0 ? (double)wide.laneInstructions / wide.steps : 0.0, wide.peeled);
+		}
+	}
+
+	free(refMemory);
+	for (int i = 0; i < WIDE_LANES; i++) {
+		i8080_destroyState(machines[i]);
+	}
+}
+
+void utilBench_system(FILE* benchLog) {
+	int hostCores = i8080_hostCores();
+	int maxCpus = hostCores < 4 ? 4 : hostCores;
+	if (maxCpus > SYSTEM_MAX_CPUS)
+		maxCpus = SYSTEM_MAX_CPUS;
+	fprintf(benchLog, "\n--- system, 1 to %d processors on their own host threads, %d host cores ---\n", maxCpus, hostCores);
+
+	// Each processor reads its index from its own port 0 and mixes the bytes of page 0x40 + index over and over
+	const uint8_t program[] = {
+		IN, 0x00, ADI, 0x40, MOV_HA, MVI_L, 0x00,
+		MOV_AM, ADD_L, RLC, XRA_B, MOV_MA, INR_B, INR_L, JMP, 0x07, 0x01
+	};
+
+	// Where each processor ends up run alone, one slice at a time on the same core
+	uint16_t refPc[SYSTEM_MAX_CPUS];
+	uint8_t* refPages = malloc(SYSTEM_MAX_CPUS * 0x100);
+	if (refPages == NULL) {
+		log_fatal("Failed to allocate space for the system bench pages");
+		exit(-1);
+	}
+	i8080State* ref = i8080_createState();
+	for (int i = 0; i < maxCpus; i++) {
+		reset8080(ref);
+		ref->mode = MODE_TEST;
+		i8080_boardAttach(ref, &i8080_bareBoard);
+		ref->core = CORE_THREADED;
+		ref->idle.enabled = false;
+		ref->hle = HLE_OFF;
+		ref->inPorts[0] = i;
+		ref->pc = 0x0100;
+		ref->cyclesExecuted = 0;
+		memcpy(ref->memory + 0x0100, program, sizeof(program));
+		for (unsigned long end = BENCH_SLICE; end <= (unsigned long)BENCH_SLICE * BENCH_SYSTEM_QUANTA; end += BENCH_SLICE) {
+			if (ref->cyclesExecuted < end)
+				i8080_run(ref, (int)(end - ref->cyclesExecuted));
+		}
+		refPc[i] = ref->pc;
+		memcpy(refPages + i * 0x100, ref->memory + ((0x40 + i) << 8), 0x100);
+	}
+	i8080_destroyState(ref);
+
+	float oneCpuMHz = 0;
+	for (int cpus = 1; cpus <= maxCpus; cpus++) {
+		i8080System* system = i8080_systemCreate(cpus, BENCH_SLICE);
+		memcpy(system->memory + 0x0100, program, sizeof(program));
+		for (int i = 0; i < cpus; i++) {
+			system->cpus[i].state->core = CORE_THREADED;
+			system->cpus[i].state->inPorts[0] = i;
+			system->cpus[i].state->pc = 0x0100;
+		}
+
+		sfClock* timer = sfClock_create();
+		unsigned long cycles = i8080_systemRun(system, BENCH_SYSTEM_QUANTA);
+		float elapsedTimeMs = sfTime_asMicroseconds(sfClock_getElapsedTime(timer)) / 1000.0f;
+		sfClock_destroy(timer);
+
+		bool matches = true;
+		for (int i = 0; i < cpus; i++) {
+			matches = matches && system->cpus[i].state->pc == refPc[i] && memcmp(system->memory + ((0x40 + i) << 8), refPages + i * 0x100, 0x100) == 0;
+		}
+
+		float emulatedMHz = elapsedTimeMs > 0 ? (cycles / (elapsedTimeMs / 1000.0f)) / MHZ : 0;
+		if (cpus == 1)
+			oneCpuMHz = emulatedMHz;
+		fprintf(benchLog, "%2d processors: %lu cycles in %10.3f ms, %8.3f MHz in all, %5.2fx one processor, matches lone runs [%s]\n",
+			cpus, cycles, elapsedTimeMs, emulatedMHz, oneCpuMHz > 0 ? emulatedMHz / oneCpuMHz : 0.0f, matches ? "OK" : "FAIL");
+		i8080_systemDestroy(system);
+	}
+
+	free(refPages);
+}
+
+bool utilBench_loadWorkload(i8080State* state, int workload) {
+	reset8080(state);
+	state->cyclesExecuted = 0;
+
+	const char* files[4];
+	int offsets[4];
+	int fileCount = 0;
+
+	switch (workload) {
+	case BENCH_INVADERS:
+		// The game in attract mode, driven by the frame interrupts
+		files[0] = "invaders.h"; offsets[0] = 0x0000;
+		files[1] = "invaders.g"; offsets[1] = 0x0800;
+		files[2] = "invaders.f"; offsets[2] = 0x1000;
+		files[3] = "invaders.e"; offsets[3] = 0x1800;
+		fileCount = 4;
+		state->mode = MODE_NORMAL;
+		i8080_boardAttach(state, &i8080_invadersBoard);
+		break;
+	case BENCH_CPUTEST:
+	case BENCH_8080PRE:
+		// CP/M program on the CP/M board, BDOS calls return immediately and the warm boot at 0 halts
+		files[0] = workload == BENCH_CPUTEST ? "CPUTEST.COM" : "8080PRE.COM"; offsets[0] = 0x0100;
+		fileCount = 1;
+		state->mode = MODE_TEST;
+		i8080_boardAttach(state, &i8080_cpmBoard);
+		break;
+	}
+
+	for (int i = 0; i < fileCount; i++) {
+		FILE* f = fopen(files[i], "rb");
+		if (f == NULL) {
+			log_error("Bench workload file '%s' is missing", files[i]);
+			return false;
+		}
+		fclose(f);
+		loadFile(files[i], state->memory, i8080_MEMORY_SIZE, offsets[i]);
+	}
+
+	return true;
+}
+
+long utilBench_lockstep(i8080State* state, int workload, int core, bool idleSkip) {
+	i8080State* ref = i8080_createState();
+
+	long divergedAt = -1;
+	if (!utilBench_loadWorkload(ref, workload) || !utilBench_loadWorkload(state, workload))
+		divergedAt = -2;
+	ref->core = CORE_SWITCH;
+	ref->idle.enabled = false;
+	ref->hle = HLE_OFF;
+	ref->memo = MEMO_OFF;
+	state->core = core;
+	bool wasEnabled = state->idle.enabled;
+	state->idle.enabled = idleSkip;
+
+	while (divergedAt == -1 && ref->cyclesExecuted < BENCH_CYCLES && ref->mode != MODE_HLT && ref->mode != MODE_PANIC) {
+		i8080_run(ref, BENCH_SLICE);
+		i8080_run(state, BENCH_SLICE);
+
+		bool matches = state->pc == ref->pc && state->sp == ref->sp && state->mode == ref->mode && state->cyclesExecuted == ref->cyclesExecuted
+			&& i8080op_getPSW(state) == i8080op_getPSW(ref) && i8080op_getBC(state) == i8080op_getBC(ref) && i8080op_getDE(state) == i8080op_getDE(ref) && i8080op_getHL(state) == i8080op_getHL(ref)
+			&& memcmp(state->memory, ref->memory, i8080_MEMORY_SIZE) == 0;
+		if (!matches)
+			divergedAt = ref->cyclesExecuted;
+	}
+	state->idle.enabled = wasEnabled;
+
+	i8080_destroyState(ref);
+	return divergedAt;
+}
+
+void i8080_profileProtocol(i8080State* state, int topCount) {
+	FILE* profileLog = fopen("i8080_profile.log", "w");
+	if (profileLog == NULL) {
+		log_error("Failed to open 'i8080_profile.log' for writing");
+		return;
+	}
+	i8080Profile* profile = malloc(sizeof(i8080Profile));
+	if (profile == NULL) {
+		log_fatal("Failed to allocate memory for the profile");
+		exit(-1);
+	}
+
+	init8080(state);
+	state->traced = true; // the profile comes from the opcode use table
+
+	fprintf(profileLog, "i8080 Profile protocol.\n");
+
+	for (int workload = 0; workload < BENCH_WORKLOAD_COUNT; workload++) {
+		fprintf(profileLog, "\n--- workload %s ---\n", benchWorkloadNames[workload]);
+		if (!utilBench_loadWorkload(state, workload)) {
+			fprintf(profileLog, "Workload files missing, skipped\n");
+			continue;
+		}
+		state->core = CORE_SWITCH;
+		memset(profile, 0, sizeof(i8080Profile));
+		utilBench_profileWorkload(state, profile);
+
+		unsigned long opcodes[0x100];
+		unsigned long total = 0;
+		for (int i = 0; i < 0x100; i++) {
+			opcodes[i] = state->debug->opcodeUse[i];
+			total += opcodes[i];
+		}
+		fprintf(profileLog, "%lu instructions in %lu cycles\n", total, state->cyclesExecuted);
+
+		fprintf(profileLog, "\nOpcodes:\n");
+		utilBench_writeTop(profileLog, opcodes, NULL, 0x100, topCount, total, 1, false);
+		fprintf(profileLog, "\nPairs:\n");
+		utilBench_writeTop(profileLog, profile->pairs, NULL, 0x10000, topCount, total, 2, false);
+		fprintf(profileLog, "\nTriples:\n");
+		utilBench_writeTop(profileLog, profile->tripleCounts, profile->tripleKeys, PROFILE_TRIPLE_SLOTS, topCount, total, 3, false);
+		// The pairs the fused core can take, in the form of the list in i8080_fused.h
+		fprintf(profileLog, "\nFusable pairs:\n");
+		utilBench_writeTop(profileLog, profile->pairs, NULL, 0x10000, topCount, total, 2, true);
+	}
+
+	fprintf(profileLog, "--------------------------------------------------\nProfile complete!\n");
+	fclose(profileLog);
+	free(profile);
+}
+
+void utilBench_profileWorkload(i8080State* state, i8080Profile* profile) {
+	// Opcodes of the last two instructions, valid while the pc has only moved straight on from them
+	int straightRun = 0;
+	uint8_t previous[2] = { 0, 0 };
+	uint16_t expectedPc = state->pc;
+
+	while (state->cyclesExecuted < BENCH_CYCLES && state->mode != MODE_HLT && state->mode != MODE_PANIC) {
+		checkInterrupts(state);
+
+		uint16_t pc = state->pc;
+		uint8_t opcode = i8080op_readMemory(state, pc);
+		if (pc != expectedPc)
+			straightRun = 0;
+
+		if (straightRun >= 1)
+			profile->pairs[(previous[0] << 8) | opcode]++;
+		if (straightRun >= 2) {
+			uint32_t key = (1 << 24) | (previous[1] << 16) | (previous[0] << 8) | opcode;
+			uint32_t slot = (key * 2654435761u) >> 16 & (PROFILE_TRIPLE_SLOTS - 1);
+			// Linear probing, triples that find the table full are not counted
+			for (int probe = 0; probe < PROFILE_TRIPLE_SLOTS; probe++) {
+				uint32_t index = (slot + probe) & (PROFILE_TRIPLE_SLOTS - 1);
+				if (profile->tripleKeys[index] == key || profile->tripleKeys[index] == 0) {
+					profile->tripleKeys[index] = key;
+					profile->tripleCounts[index]++;
+					break;
+				}
+			}
+		}
+
+		int cycles = i8080_executeInstruction(state);
+		state->cyclesExecuted += cycles;
+		state->interruptAccumulator += cycles;
+
+		previous[1] = previous[0];
+		previous[0] = opcode;
+		straightRun++;
+		expectedPc = pc + i8080_getInstructionLength(opcode);
+	}
+}
+
+void utilBench_writeTop(FILE* file, unsigned long* counts, const uint32_t* keys, int size, int topCount, unsigned long total, int length, bool fusableOnly) {
+	// Walk down the counts largest first without sorting them, ties in index order
+	int last = -1;
+	for (int n = 0; n < topCount; n++) {
+		int best = -1;
+		for (int i = 0; i < size; i++) {
+			if (counts[i] == 0)
+				continue;
+			uint32_t key = keys != NULL ? keys[i] : i;
+			if (fusableOnly && !i8080_canFuse(key >> 8, key & 0xFF))
+				continue;
+			// Only entries after the last one written, in the order largest first then lowest index
+			if (last >= 0 && (counts[i] > counts[last] || (counts[i] == counts[last] && i <= last)))
+				continue;
+			if (best < 0 || counts[i] > counts[best])
+				best = i;
+		}
+		if (best < 0)
+			break;
+		last = best;
+
+		uint32_t key = keys != NULL ? keys[best] : best;
+		fprintf(file, "%6.2f%% %10lu  ", 100.0 * counts[best] / total, counts[best]);
+		if (fusableOnly) {
+			fprintf(file, "X(");
+			utilBench_writeOpcodeName(file, key >> 8);
+			fprintf(file, ", ");
+			utilBench_writeOpcodeName(file, key & 0xFF);
+			fprintf(file, ")\n");
+		}
+		else {
+			for (int i = length - 1; i >= 0; i--)
+				fprintf(file, "%s%s", i8080_decompile((key >> (i * 8)) & 0xFF), i > 0 ? "; " : "\n");
+		}
+	}
+}
+
+void utilBench_writeOpcodeName(FILE* file, uint8_t opcode) {
+	// The enum drops the accumulator the decompiler names in the ALU instructions, ADD A,B is ADD_B but MOV A,B is MOV_AB
+	const char* name = i8080_decompile(opcode);
+	const char* comma = strchr(name, ',');
+	bool dropAccumulator = comma != NULL && strncmp(name, "MOV", 3) != 0;
+
+	for (const char* c = name; *c != '\0'; c++) {
+		if (dropAccumulator && *c == ' ') {
+			fputc('_', file);
+			c = comma;
+		}
+		else if (*c == ' ')
+			fputc('_', file);
+		else if (*c != ',')
+			fputc(*c, file);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+/*
+
+i8080_bench.h
+
+Benchmark protocol. Runs fixed workloads on every core and reports the emulated speed
+
+*/
+
+#include "i8080.h"
+#include "i8080_blockcache.h"
+#include "i8080_jit.h"
+#include "i8080_wide.h"
+#include "i8080_system.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sfml/System/Clock.h>
+
+// Slots in the hash table of opcode triples, must be a power of 2
+#define PROFILE_TRIPLE_SLOTS 0x10000
+
+// Counts of the opcode sequences that ran in a straight line, without a jump or interrupt between them
+typedef struct i8080Profile {
+	unsigned long pairs[0x10000]; // indexed by first opcode << 8 | second opcode
+	uint32_t tripleKeys[PROFILE_TRIPLE_SLOTS]; // first << 16 | second << 8 | third, plus 1 << 24 so 0 marks an empty slot
+	unsigned long tripleCounts[PROFILE_TRIPLE_SLOTS];
+} i8080Profile;
+
+// Inputs of one ADD/SUB/CMP/DAA as the workload ran it
+typedef struct i8080AluTrace {
+	uint8_t kind; // ALU_TRACE_ family
+	uint8_t a;
+	uint8_t operand;
+	uint8_t carry; // carry or borrow in. For DAA bit 0 is c and bit 1 is ac
+} i8080AluTrace;
+
+/* Bench function defs */
+// Runs every workload on every core and writes the results to i8080_bench.log
+void i8080_benchProtocol(i8080State* state);
+// Runs every workload on the switch core and writes the most used opcodes, pairs and triples to i8080_profile.log, topCount of each
+void i8080_profileProtocol(i8080State* state, int topCount);
+// Times the s, z and p flags of an ADD built with the old bit counting parity check and with the ZSP table, and writes the cost per ALU op
+void utilBench_zspCost(FILE* benchLog);
+// Records the ADD/SUB/CMP/DAA instructions a workload runs on the switch core, then replays them through the reference functions and the ALU tables and writes the cost per op and the table cache lines touched
+void utilBench_aluReplay(FILE* benchLog, i8080State* state, int workload);
+// Runs invaders in attract mode on every core with the idle loop skip off and on, and writes the speed of each, the share of cycles skipped and whether the skip ends and steps in lockstep where running every instruction does
+void utilBench_idleSkip(FILE* benchLog, i8080State* state);
+// Runs invaders in attract mode on every core with HLE off and on, and writes the speed of each, the share of cycles run by native routines and whether HLE ends and steps in lockstep where running every instruction does
+void utilBench_hle(FILE* benchLog, i8080State* state);
+// Runs invaders in attract mode on every core with memoisation off and on, and writes the speed of each, the calls replayed and whether memoisation ends and steps in lockstep where running every call does, then the routines found on the switch core
+void utilBench_memo(FILE* benchLog, i8080State* state);
+// Runs WIDE_LANES invaders machines, each holding different inputs, on the wide core and one at a time on every scalar core, and writes the machine-frames per second of each and whether every machine ended where the switch core left it
+void utilBench_wide(FILE* benchLog);
+// Runs systems of 1 up to at least 4 processors, or as many as the host has cores, each processor on its own host thread
+// working on its own page, and writes the total emulated speed of each, its scaling over one processor and whether every
+// processor ended where a lone state left it
+void utilBench_system(FILE* benchLog);
+// Loads the named workload into a freshly reset state. Returns false if the workload files could not be loaded
+bool utilBench_loadWorkload(i8080State* state, int workload);
+// Runs a workload on the core beside the switch core one slice at a time, comparing the two after each slice. The switch core runs every instruction, the core skips idle loops if idleSkip is set and runs native routines as the HLE mode of the state asks. Returns the cycle count of the first slice that differs, -1 if they never differ, or -2 if the workload could not be loaded
+long utilBench_lockstep(i8080State* state, int workload, int core, bool idleSkip);
+// Runs a workload one instruction at a time, counting the straight line opcode pairs and triples into the profile
+void utilBench_profileWorkload(i8080State* state, i8080Profile* profile);
+// Writes the topCount largest counts to the file as opcode sequences of the given length, keyed by their index or by keys if not NULL. fusableOnly writes just the pairs the fused core can take, as entries of I8080_FUSED_LIST
+void utilBench_writeTop(FILE* file, unsigned long* counts, const uint32_t* keys, int size, int topCount, unsigned long total, int length, bool fusableOnly);
+// Writes the name of the opcode as it appears in the i8080Opcode enum, MOV A,M as MOV_AM
+void utilBench_writeOpcodeName(FILE* file, uint8_t opcode);
@@ -0,0 +1,162 @@
+/*
+
+i8080_blockcache.c
+
+Basic block cache. Straight line runs of instructions are decoded once, keyed by their start pc, and run as a unit
+
+*/
+
+#include "i8080_blockcache.h"
+#include "i8080_jit.h"
+
+#include <stdlib.h>
+
+// Returns if the opcode changes the flow of control, which ends a block
+I8080_INLINE bool endsBlock(uint8_t opcode) {
+	return (i8080_opcodeInfo[opcode].kind & OPK_JUMP) != 0;
+}
+
+// Decodes the block starting at pc into the block
+static void buildBlock(i8080State* state, i8080Block* block, uint16_t pc) {
+	block->startPc = pc;
+	block->runs = 0;
+	block->native = NULL;
+	block->count = 0;
+	block->bodyCycles = 0;
+	block->firstPage = i8080op_mirrorAddress(state, pc) / BLOCK_PAGE_SIZE;
+
+	uint8_t opcode;
+	do {
+		i8080MicroOp* op = &block->ops[block->count++];
+		opcode = i8080op_readMemory(state, pc);
+		op->opcode = opcode;
+		op->handler = i8080_opHandlers[opcode];
+		op->byte1 = i8080op_readMemory(state, pc + 1);
+		op->byte2 = i8080op_readMemory(state, pc + 2);
+		op->length = i8080_getInstructionLength(opcode);
+		op->cycles = i8080_getInstructionClockCycles(opcode);
+		op->failedCycles = i8080_getFailedInstructionClockCycles(opcode);
+		pc += op->length;
+		block->bodyCycles += op->cycles;
+	} while (!endsBlock(opcode) && block->count < BLOCK_MAX_INSTRUCTIONS);
+
+	// The last instruction isn't part of the body, whether it branches or not
+	block->bodyCycles -= block->ops[block->count - 1].cycles;
+
+	block->lastPage = i8080op_mirrorAddress(state, pc - 1) / BLOCK_PAGE_SIZE;
+	state->blockCache->codePages[block->firstPage] = true;
+	state->blockCache->codePages[block->lastPage] = true;
+	block->valid = true;
+}
+
+void i8080_flushBlockCache(i8080State* state) {
+	if (state->blockCache == NULL) {
+		state->blockCache = malloc(sizeof(i8080BlockCache));
+		if (state->blockCache == NULL) {
+			log_fatal("Failed to allocate memory for the block cache");
+			exit(-1);
+		}
+		state->blockCache->jit = NULL;
+	}
+	i8080_jitFlush(state);
+
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		state->blockCache->blocks[i].valid = false;
+	}
+	for (int i = 0; i < BLOCK_PAGE_COUNT; i++) {
+		state->blockCache->codePages[i] = false;
+	}
+	state->blockCache->hits = 0;
+	state->blockCache->misses = 0;
+	state->blockCache->invalidations = 0;
+
+	state->blockCacheValid = true;
+}
+
+void i8080_invalidateBlockPage(i8080State* state, uint8_t page) {
+	i8080BlockCache* cache = state->blockCache;
+
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		i8080Block* block = &cache->blocks[i];
+		if (block->valid && (block->firstPage == page || block->lastPage == page)) {
+			block->valid = false;
+			cache->invalidations++;
+		}
+	}
+
+	// Nothing cached here any more, writes to the page are free until a block is built on it again
+	cache->codePages[page] = false;
+}
+
+int i8080_runBlocks(i8080State* state, int cycleBudget) {
+	int cyclesUsed = 0;
+
+	if (!state->blockCacheValid)
+		i8080_flushBlockCache(state);
+	i8080BlockCache* cache = state->blockCache;
+	// A CALL runs in the middle of a block and cyclesExecuted moves a block at a time, neither of which memoisation can work with
+	if (state->memo != MEMO_OFF) {
+		log_warn("Memoisation does not run on the %s core, turning it off", getCoreStr(state->core));
+		i8080_memoAbort(state, NULL);
+		state->memo = MEMO_OFF;
+	}
+	unsigned int interruptPeriod = state->bus->board->interruptPeriod;
+
+	while (cyclesUsed < cycleBudget) {
+		checkInterrupts(state);
+		I8080_IDLE_CHECK(state, cyclesUsed, cycleBudget);
+		I8080_HLE_CHECK(state, cyclesUsed, cycleBudget);
+
+		i8080Block* block = &cache->blocks[state->pc & (BLOCK_CACHE_SIZE - 1)];
+		if (block->valid && block->startPc == state->pc) {
+			cache->hits++;
+		}
+		else {
+			cache->misses++;
+			buildBlock(state, block, state->pc);
+		}
+
+		// The whole block only runs if the per instruction loop would have run all of it too: no instruction but the last may
+		// reach the end of the budget or the next interrupt. Otherwise step one instruction and try again at the next boundary
+		if (cyclesUsed + block->bodyCycles >= cycleBudget || state->interruptAccumulator + block->bodyCycles >= interruptPeriod) {
+			int cycles = i8080_executeInstruction(state);
+			cyclesUsed += cycles;
+			state->cyclesExecuted += cycles;
+			state->interruptAccumulator += cycles;
+		}
+		else {
+			if (state->core == CORE_JIT && block->native == NULL && block->runs++ >= jit_hotThreshold)
+				i8080_jitCompile(state, block);
+
+			int cycles = 0;
+			if (block->native != NULL) {
+				cycles = block->native(state);
+			}
+			else {
+				for (int i = 0; i < block->count; i++) {
+					const i8080MicroOp* op = &block->ops[i];
+
+					state->f.rx = false;
+					state->f.tx = false;
+
+					uint8_t result = op->handler(state, op->opcode, op->byte1, op->byte2);
+					if (!(result & OPRESULT_JUMPED))
+						state->pc += op->length;
+					cycles += (result & OPRESULT_FAILED) ? op->failedCycles : op->cycles;
+
+					// Stop if the processor halted, or the block wrote over itself
+					if (state->mode == MODE_HLT || state->mode == MODE_PANIC || !block->valid)
+						break;
+				}
+			}
+			cyclesUsed += cycles;
+			state->cyclesExecuted += cycles;
+			state->interruptAccumulator += cycles;
+		}
+
+		if (state->mode == MODE_HLT || state->mode == MODE_PANIC)
+			break;
+	}
+
+	return cyclesUsed;
+}
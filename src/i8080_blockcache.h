@@ -0,0 +1,51 @@
+#pragma once
+/*
+
+i8080_blockcache.h
+
+Basic block cache. Straight line runs of instructions are decoded once, keyed by their start pc, and run as a unit
+
+*/
+
+#include "i8080_predecode.h"
+
+// Most instructions in one block
+#define BLOCK_MAX_INSTRUCTIONS 32
+// Number of blocks in the cache, direct mapped on the start pc. Must be a power of 2
+#define BLOCK_CACHE_SIZE 1024
+// Size of the pages that writes invalidate blocks on
+#define BLOCK_PAGE_SIZE 0x100
+#define BLOCK_PAGE_COUNT (i8080_MEMORY_SIZE / BLOCK_PAGE_SIZE)
+
+// Native code for a whole block. Returns the clock cycles it took
+typedef int (*i8080NativeBlock)(i8080State* state);
+
+typedef struct i8080Block {
+	bool valid;
+	uint16_t startPc;
+	uint8_t firstPage; // physical pages holding the first and last byte of the block
+	uint8_t lastPage;
+	uint8_t count;
+	int bodyCycles; // cycles of every instruction but the last, none of which can branch
+	i8080MicroOp ops[BLOCK_MAX_INSTRUCTIONS];
+	unsigned int runs; // whole runs since the block was built
+	i8080NativeBlock native; // compiled by the JIT core, NULL until then
+} i8080Block;
+
+typedef struct i8080BlockCache {
+	i8080Block blocks[BLOCK_CACHE_SIZE];
+	bool codePages[BLOCK_PAGE_COUNT]; // pages that may hold a cached block
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long invalidations;
+	struct i8080JitBuffer* jit; // executable memory for native blocks, NULL until the JIT core first compiles
+} i8080BlockCache;
+
+// Drops every block and zeros the counters, allocating the cache on first use
+void i8080_flushBlockCache(i8080State* state);
+
+// Drops every block holding a byte of the physical page. Called by i8080op_writeMemory for pages marked in codePages
+void i8080_invalidateBlockPage(i8080State* state, uint8_t page);
+
+// Runs instructions a block at a time, through native code for hot blocks on the JIT core. Same contract as i8080_run, but does not drain waitCycles
+int i8080_runBlocks(i8080State* state, int cycleBudget);
@@ -0,0 +1,92 @@
+/*
+
+i8080_board.c
+
+Boards: the invaders cabinet, the CP/M test board and the bare board
+
+*/
+
+#include "i8080_board.h"
+#include "i8080.h"
+
+#include <string.h>
+
+// Registers of the invaders shift register in the board bytes
+#define INVADERS_SHIFT_LOW 0
+#define INVADERS_SHIFT_HIGH 1
+#define INVADERS_SHIFT_OFFSET 2
+
+static void invadersReset(i8080State* state) {
+	memset(state->bus->boardBytes, 0, BUS_BOARD_BYTES);
+	state->inPorts[1] = 0x00;
+	state->inPorts[2] = 0x80;
+	state->inPorts[3] = 0x00;
+}
+
+// The shift register: OUT 4 shifts a byte in from the top, OUT 2 picks the offset and IN 3 reads the byte at it
+static void invadersOut(i8080State* state, uint8_t port, uint8_t value) {
+	uint8_t* shift = state->bus->boardBytes;
+	if (port == 2) {
+		shift[INVADERS_SHIFT_OFFSET] = value & 0x7;
+	}
+	else if (port == 4) {
+		shift[INVADERS_SHIFT_LOW] = shift[INVADERS_SHIFT_HIGH];
+		shift[INVADERS_SHIFT_HIGH] = value;
+	}
+	else {
+		return;
+	}
+	uint16_t v = (shift[INVADERS_SHIFT_HIGH] << 8) | shift[INVADERS_SHIFT_LOW];
+	state->inPorts[3] = (v >> (8 - shift[INVADERS_SHIFT_OFFSET])) & 0xFF;
+}
+
+// CP/M programs start at 0100, BDOS calls return straight away and the warm boot at 0 halts
+static void cpmReset(i8080State* state) {
+	state->memory[0x0000] = HLT;
+	state->memory[0x0005] = RET;
+	state->pc = 0x0100;
+}
+
+const i8080Board i8080_invadersBoard = {
+	"invaders", &i8080_invadersMap,
+	17066, 2, { INTERRUPT_2, INTERRUPT_1 }, // mid screen, then the end of the frame
+	invadersReset, invadersOut,
+	{ 0x2400, 256, 224 } // 32 bytes a line, the monitor is turned on its side
+};
+
+const i8080Board i8080_cpmBoard = {
+	"cpm", &i8080_flatMap,
+	BOARD_NO_INTERRUPTS, 0, { 0, 0 },
+	cpmReset, NULL,
+	{ 0x0000, 64, 64 }
+};
+
+const i8080Board i8080_bareBoard = {
+	"bare", &i8080_flatMap,
+	BOARD_NO_INTERRUPTS, 0, { 0, 0 },
+	NULL, NULL,
+	{ 0x0000, 64, 64 }
+};
+
+const i8080Board* const i8080_boards[BOARD_COUNT] = { &i8080_invadersBoard, &i8080_cpmBoard, &i8080_bareBoard };
+
+void i8080_boardAttach(i8080State* state, const i8080Board* board) {
+	state->bus->board = board;
+	i8080_busMap(state, board->map);
+	i8080_boardReset(state);
+}
+
+void i8080_boardReset(i8080State* state) {
+	const i8080Board* board = state->bus->board;
+	state->debug->vid = board->video;
+	if (board->reset != NULL)
+		board->reset(state);
+}
+
+const i8080Board* i8080_boardFind(const char* name) {
+	for (int i = 0; i < BOARD_COUNT; i++) {
+		if (strcmp(i8080_boards[i]->name, name) == 0)
+			return i8080_boards[i];
+	}
+	return NULL;
+}
@@ -0,0 +1,54 @@
+#pragma once
+/*
+
+i8080_board.h
+
+Boards. Everything around the processor that differs from machine to machine: the memory map, what the ports do, the
+interrupts the board raises and where its screen is. A state is plugged into one board, kept over resets, and the cores
+only ever reach the board through its memory map, port_out, checkInterrupts and the interrupt period they run up to. The invaders board is the cabinet, the
+CP/M board is 64K of RAM with the BDOS entry and warm boot stubbed for the CP/M test programs, and the bare board is 64K
+of RAM with nothing else
+
+*/
+
+#include "i8080_bus.h"
+
+// Interrupt period of a board that raises no interrupts, longer than any budget so the cores never stop a block or a fused
+// pair short for one
+#define BOARD_NO_INTERRUPTS 0x7FFFFFFF
+
+// Most interrupts a board raises in turn, one for each RST
+#define BOARD_MAX_INTERRUPTS 8
+
+typedef void (*i8080BoardReset)(i8080State* state);
+typedef void (*i8080BoardOut)(i8080State* state, uint8_t port, uint8_t value);
+
+typedef struct i8080Board {
+	const char* name;
+	const i8080MemoryMap* map;
+	// RST addresses of the interrupts the board raises every interruptPeriod cycles, taken in turn by the interruptIndex of the state
+	unsigned int interruptPeriod; // BOARD_NO_INTERRUPTS with no interrupts
+	int interruptCount; // 0 for a board that raises none, nothing then wakes a halted processor
+	uint16_t interrupts[BOARD_MAX_INTERRUPTS];
+	i8080BoardReset reset; // after reset8080 and i8080_boardAttach: the in ports, the board registers and anything the board puts in memory. NULL for nothing
+	i8080BoardOut onOut; // after every OUT, with the value already in outPorts. NULL when nothing listens
+	videoMemoryInfo video; // the screen in memory, for the front end
+} i8080Board;
+
+// Boards i8080_boardFind knows
+#define BOARD_COUNT 3
+
+extern const i8080Board i8080_invadersBoard;
+extern const i8080Board i8080_cpmBoard;
+extern const i8080Board i8080_bareBoard;
+extern const i8080Board* const i8080_boards[BOARD_COUNT];
+
+// Plugs the state into the board: maps its memory, takes its video settings and resets its hardware. Memory the map keeps
+// is left as it is, so a board can be picked after loading a program
+void i8080_boardAttach(i8080State* state, const i8080Board* board);
+
+// Resets the hardware of the board the state is plugged into, from reset8080
+void i8080_boardReset(i8080State* state);
+
+// The board of that name, NULL if there is none
+const i8080Board* i8080_boardFind(const char* name);
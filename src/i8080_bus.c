@@ -0,0 +1,83 @@
+/*
+
+i8080_bus.c
+
+Memory bus. The page tables of the states and the memory maps of the machines
+
+*/
+
+#include "i8080_bus.h"
+#include "i8080.h"
+
+// Backs the pages no region covers
+static uint8_t busUnmapped[BUS_PAGE_SIZE];
+
+static void busRomWrite(i8080State* state, uint16_t address, uint8_t value) {
+	(void)state;
+	log_error("Memory write of value %02X at %04X attempted: blocked", value, address);
+}
+
+static void busUnmappedWrite(i8080State* state, uint16_t address, uint8_t value) {
+	(void)state;
+	log_warn("Memory write of value %02X at %04X attempted: nothing mapped there", value, address);
+}
+
+static const i8080BusRegion invadersRegions[] = {
+	{ 0x0000, 0x2000, 0x0000, 0, NULL, busRomWrite }, // ROM
+	{ 0x2000, 0x2000, 0x2000, 0, NULL, NULL }, // work RAM and the screen from 0x2400
+	{ 0x4000, 0xC000, 0x2000, 0x2000, NULL, NULL }, // the RAM again every 0x2000
+};
+
+const i8080MemoryMap i8080_invadersMap = { "invaders", sizeof(invadersRegions) / sizeof(invadersRegions[0]), invadersRegions };
+
+static const i8080BusRegion flatRegions[] = {
+	{ 0x0000, 0x10000, 0x0000, 0, NULL, NULL },
+};
+
+const i8080MemoryMap i8080_flatMap = { "flat", sizeof(flatRegions) / sizeof(flatRegions[0]), flatRegions };
+
+void i8080_busMap(i8080State* state, const i8080MemoryMap* map) {
+	i8080Bus* bus = state->bus;
+	bus->map = map;
+	for (int page = 0; page < BUS_PAGES; page++) {
+		bus->pages[page].read = busUnmapped;
+		bus->pages[page].write = NULL;
+		bus->pages[page].onRead = NULL;
+		bus->pages[page].onWrite = busUnmappedWrite;
+		bus->pages[page].offset = (uint16_t)(page * BUS_PAGE_SIZE);
+	}
+
+	for (int i = 0; i < map->regionCount; i++) {
+		const i8080BusRegion* region = &map->regions[i];
+		int window = region->window == 0 ? region->length : region->window;
+		if (region->start % BUS_PAGE_SIZE != 0 || region->length % BUS_PAGE_SIZE != 0 || window % BUS_PAGE_SIZE != 0
+			|| region->start + region->length > i8080_MEMORY_SIZE || region->target + window > i8080_MEMORY_SIZE) {
+			log_error("Region %i of the %s memory map is not whole pages inside the address space, left unmapped", i, map->name);
+			continue;
+		}
+
+		for (int offset = 0; offset < region->length; offset += BUS_PAGE_SIZE) {
+			i8080BusPage* page = &bus->pages[(region->start + offset) / BUS_PAGE_SIZE];
+			uint8_t* host = state->memory + region->target + offset % window;
+			page->read = host;
+			page->write = region->onWrite == NULL ? host : NULL;
+			page->onRead = region->onRead;
+			page->onWrite = region->onWrite;
+			page->offset = (uint16_t)(region->target + offset % window);
+		}
+	}
+
+	// Code decoded while the old map was in place may not be what the new one reads
+	state->microOpsValid = false;
+	state->blockCacheValid = false;
+	i8080_hleForget(state);
+}
+
+bool i8080_busReadOnly(i8080State* state, uint16_t address, int length) {
+	for (int page = address / BUS_PAGE_SIZE; page <= (address + length - 1) / BUS_PAGE_SIZE; page++) {
+		const i8080BusPage* p = &state->bus->pages[page % BUS_PAGES];
+		if (p->write != NULL || p->onRead != NULL)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+/*
+
+i8080_bus.h
+
+Memory bus. Every state reads and writes memory through a table of the 256 pages of 256 bytes in its address space. A page
+of plain RAM or ROM is a host pointer into the state memory, so an access is one lookup and one load or store. A page of a
+special region hands its reads, its writes or both to a handler instead, for fetches as for data. The table is built from the memory map of the
+machine, a list of regions declared once per machine, and kept over resets
+
+*/
+
+#include "i8080_util.h"
+
+// Bytes in a page of the bus, and pages in the address space
+#define BUS_PAGE_SIZE 0x100
+#define BUS_PAGES 0x100
+// Bytes the hardware of a board can keep beside the processor, see i8080_board.h
+#define BUS_BOARD_BYTES 4
+
+typedef uint8_t (*i8080BusRead)(i8080State* state, uint16_t address);
+typedef void (*i8080BusWrite)(i8080State* state, uint16_t address, uint8_t value);
+
+typedef struct i8080BusPage {
+	uint8_t* read; // host pointer to the page, for fetches and for reads when onRead is NULL
+	uint8_t* write; // host pointer writes store through, NULL to hand them to onWrite
+	i8080BusRead onRead; // NULL for plain memory
+	i8080BusWrite onWrite; // for a page whose write pointer is NULL
+	uint16_t offset; // offset into the state memory the page is backed by, its own address on an unmapped page
+} i8080BusPage;
+
+// One stretch of the address space in a memory map
+typedef struct i8080BusRegion {
+	int start; // first address, on a page boundary
+	int length; // bytes, whole pages
+	int target; // offset into the state memory the stretch is backed by
+	int window; // bytes from target the stretch repeats over, 0 for its whole length
+	i8080BusRead onRead; // NULL to read the backing memory
+	i8080BusWrite onWrite; // NULL to write the backing memory
+} i8080BusRegion;
+
+// The memory map of a machine. Pages no region covers read as 0 and drop their writes
+typedef struct i8080MemoryMap {
+	const char* name;
+	int regionCount;
+	const i8080BusRegion* regions;
+} i8080MemoryMap;
+
+typedef struct i8080Bus {
+	const i8080MemoryMap* map; // the map the pages were built from
+	const struct i8080Board* board; // the board the state is plugged into, its ports, interrupts and video
+	uint8_t boardBytes[BUS_BOARD_BYTES]; // registers of the board hardware, the invaders shift register
+	struct i8080Memo* memo; // the routines memoised from the ROM of the machine, NULL until it records a call
+	struct i8080Hle* hle; // what the machine found of the HLE registry, NULL until a core reaches a routine head
+	i8080BusPage pages[BUS_PAGES];
+} i8080Bus;
+
+// Space Invaders: the ROM at 0x0000-0x1FFF, writes to it logged and dropped, RAM at 0x2000-0x3FFF mirrored up to 0xFFFF
+extern const i8080MemoryMap i8080_invadersMap;
+// 64K of flat RAM, for the tests and CP/M programs
+extern const i8080MemoryMap i8080_flatMap;
+
+// Builds the page table of the state from the map over its memory, and drops the code decoded through the old one. The
+// rest of the board stays as it was
+void i8080_busMap(i8080State* state, const i8080MemoryMap* map);
+
+// Whether every page of length bytes from address is write protected, with reads of plain memory, so code there can be decoded once
+bool i8080_busReadOnly(i8080State* state, uint16_t address, int length);
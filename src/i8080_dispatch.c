@@ -0,0 +1,416 @@
+/*
+
+i8080_dispatch.c
+
+Table driven opcode dispatch. Each opcode family is written once as a macro and stamped out for every register,
+the handlers are then collected into a 256 entry table from the handler column of I8080_OPCODE_LIST. The same list also
+builds the label table of the threaded loop so the two can never disagree
+
+*/
+
+#include "i8080_dispatch.h"
+#include "i8080_predecode.h"
+#include "i8080_fused.h"
+
+#define HANDLER(name) static uint8_t name(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2)
+#define ADDRESS16 (((uint16_t)byte2 << 8) + byte1)
+
+// Operand sources for the ALU families
+#define OPERAND_B (state->b)
+#define OPERAND_C (state->c)
+#define OPERAND_D (state->d)
+#define OPERAND_E (state->e)
+#define OPERAND_H (state->h)
+#define OPERAND_L (state->l)
+#define OPERAND_A (state->a)
+#define OPERAND_M (i8080op_readMemory(state, i8080op_getHL(state)))
+#define OPERAND_I (byte1)
+
+// Branch conditions. The carry is always up to date, the others may still be deferred
+#define CONDITION_NZ (!(I8080_FLAGS(state)->psw & FLAG_Z))
+#define CONDITION_Z (I8080_FLAGS(state)->psw & FLAG_Z)
+#define CONDITION_NC (!(state->f.psw & FLAG_C))
+#define CONDITION_C (state->f.psw & FLAG_C)
+#define CONDITION_PO (!(I8080_FLAGS(state)->psw & FLAG_P))
+#define CONDITION_PE (I8080_FLAGS(state)->psw & FLAG_P)
+#define CONDITION_P (!(I8080_FLAGS(state)->psw & FLAG_S))
+#define CONDITION_M (I8080_FLAGS(state)->psw & FLAG_S)
+
+// Defers the s, z, p and ac flags of an ALU result until something reads them. The carry is still set straight away
+#define LAZY_FLAGS(kind, result) state->lazyFlags = (kind); state->lazyResult = (result)
+
+/* Handler families */
+
+// Register fields by opcode name
+#define REG_B b
+#define REG_C c
+#define REG_D d
+#define REG_E e
+#define REG_H h
+#define REG_L l
+#define REG_A a
+
+// MOV between two registers, and to and from memory[HL]
+#define DEF_MOV(DST, SRC) HANDLER(op_MOV_##DST##SRC) { state->REG_##DST = state->REG_##SRC; return OPRESULT_OK; }
+#define DEF_MOV_ROW(DST) \
+	DEF_MOV(DST, B) DEF_MOV(DST, C) DEF_MOV(DST, D) DEF_MOV(DST, E) DEF_MOV(DST, H) DEF_MOV(DST, L) DEF_MOV(DST, A) \
+	HANDLER(op_MOV_##DST##M) { state->REG_##DST = OPERAND_M; return OPRESULT_OK; } \
+	HANDLER(op_MOV_M##DST) { i8080op_writeMemory(state, i8080op_getHL(state), state->REG_##DST); return OPRESULT_OK; }
+
+// Single register increment, decrement and immediate load
+#define DEF_REG8(REG) \
+	HANDLER(op_INR_##REG) { state->REG_##REG = state->REG_##REG + 1; LAZY_FLAGS(LAZY_ADD, state->REG_##REG); return OPRESULT_OK; } \
+	HANDLER(op_DCR_##REG) { state->REG_##REG = state->REG_##REG - 1; LAZY_FLAGS(LAZY_DCR, state->REG_##REG); return OPRESULT_OK; } \
+	HANDLER(op_MVI_##REG) { state->REG_##REG = byte1; return OPRESULT_OK; }
+
+// Register pair load, increment, decrement, add to HL, push and pop
+#define DEF_PAIR(NAME, PAIR) \
+	HANDLER(op_LXI_##NAME) { i8080op_put##PAIR##8(state, byte2, byte1); return OPRESULT_OK; } \
+	HANDLER(op_INX_##NAME) { i8080op_put##PAIR##16(state, i8080op_get##PAIR(state) + 1); return OPRESULT_OK; } \
+	HANDLER(op_DCX_##NAME) { i8080op_put##PAIR##16(state, i8080op_get##PAIR(state) - 1); return OPRESULT_OK; } \
+	HANDLER(op_DAD_##NAME) { i8080op_putHL16(state, i8080op_addCarry16(state, i8080op_getHL(state), i8080op_get##PAIR(state))); return OPRESULT_OK; } \
+	HANDLER(op_PUSH_##NAME) { i8080op_pushStack(state, i8080op_get##PAIR(state)); return OPRESULT_OK; } \
+	HANDLER(op_POP_##NAME) { i8080op_put##PAIR##16(state, i8080op_popStack(state)); return OPRESULT_OK; }
+
+// Accumulator operations, with the same flags as the i8080op_addCarry8/subCarry8 and i8080_acFlagSet helpers the switch uses.
+// ADC and SBB keep the 8 bit truncation of the switch implementation
+#ifdef I8080_ALU_TABLES
+// The tables give every flag at once, so nothing is left to resolve
+#define ALU_TABLE(TABLE, carry, v) { uint16_t entry = i8080_aluTables->TABLE[carry][state->a][v]; state->a = ALU_RESULT(entry); state->f.psw = ALU_FLAGS(entry); state->lazyFlags = LAZY_NONE; }
+#define ALU_ADD(v) ALU_TABLE(add, 0, (v))
+#define ALU_ADC(v) ALU_TABLE(add, GET_FLAG(state, FLAG_C), (v))
+#define ALU_SUB(v) ALU_TABLE(sub, 0, (v))
+#define ALU_SBB(v) ALU_TABLE(sub, GET_FLAG(state, FLAG_C), (v))
+#define ALU_CMP(v) state->f.psw = ALU_FLAGS(i8080_aluTables->sub[0][state->a][(v)]) & ~FLAG_AC; state->lazyFlags = LAZY_NONE
+#else
+#define ALU_ADD8(x, y) { uint8_t l = (x); uint8_t r = (y); SET_FLAG(state, FLAG_C, (l + r) > 0xFF); state->a = l + r; LAZY_FLAGS(LAZY_ADD, state->a); }
+#define ALU_SUB8(x, y) { uint8_t l = (x); uint8_t r = (y); SET_FLAG(state, FLAG_C, l < r); state->a = l - r; LAZY_FLAGS(LAZY_SUB, state->a); }
+#define ALU_ADD(v) ALU_ADD8(state->a, (v))
+#define ALU_ADC(v) ALU_ADD8(state->a, (v) + GET_FLAG(state, FLAG_C))
+#define ALU_SUB(v) ALU_SUB8(state->a, (v))
+#define ALU_SBB(v) ALU_SUB8(state->a - GET_FLAG(state, FLAG_C), (v))
+#define ALU_CMP(v) SET_FLAG(state, FLAG_C, state->a < (v)); LAZY_FLAGS(LAZY_LOGIC, state->a - (v))
+#endif
+#define ALU_ANA(v) state->lazyOperand = state->a | (v); state->a = state->a & (v); SET_FLAG(state, FLAG_C, 0); LAZY_FLAGS(LAZY_ANA, state->a)
+#define ALU_XRA(v) state->a = state->a ^ (v); LAZY_FLAGS(LAZY_LOGIC, state->a)
+#define ALU_ORA(v) state->a = state->a | (v); LAZY_FLAGS(LAZY_LOGIC, state->a)
+
+#define DEF_ALU(OP, SRC) HANDLER(op_##OP##_##SRC) { uint8_t v = OPERAND_##SRC; ALU_##OP(v); return OPRESULT_OK; }
+#define DEF_ALU_ROW(OP) \
+	DEF_ALU(OP, B) DEF_ALU(OP, C) DEF_ALU(OP, D) DEF_ALU(OP, E) DEF_ALU(OP, H) DEF_ALU(OP, L) DEF_ALU(OP, M) DEF_ALU(OP, A)
+
+// Conditional jumps, calls and returns
+#define DEF_BRANCH(CC) \
+	HANDLER(op_J##CC) { if (CONDITION_##CC) { i8080op_setPC(state, ADDRESS16); return OPRESULT_JUMPED; } return OPRESULT_OK; } \
+	HANDLER(op_C##CC) { if (CONDITION_##CC) { i8080op_executeCALL(state, ADDRESS16); return OPRESULT_JUMPED; } return OPRESULT_FAILED; } \
+	HANDLER(op_R##CC) { if (CONDITION_##CC) { i8080op_executeRET(state); return OPRESULT_JUMPED; } return OPRESULT_FAILED; }
+
+// Restarts
+#define DEF_RST(n) HANDLER(op_RST_##n) { i8080op_executeCALL(state, INTERRUPT_##n); return OPRESULT_JUMPED; }
+
+/* Handlers */
+
+DEF_MOV_ROW(B)
+DEF_MOV_ROW(C)
+DEF_MOV_ROW(D)
+DEF_MOV_ROW(E)
+DEF_MOV_ROW(H)
+DEF_MOV_ROW(L)
+DEF_MOV_ROW(A)
+
+DEF_REG8(B)
+DEF_REG8(C)
+DEF_REG8(D)
+DEF_REG8(E)
+DEF_REG8(H)
+DEF_REG8(L)
+DEF_REG8(A)
+
+DEF_PAIR(B, BC)
+DEF_PAIR(D, DE)
+DEF_PAIR(H, HL)
+
+DEF_ALU_ROW(ADD)
+DEF_ALU_ROW(ADC)
+DEF_ALU_ROW(SUB)
+DEF_ALU_ROW(SBB)
+DEF_ALU_ROW(ANA)
+DEF_ALU_ROW(XRA)
+DEF_ALU_ROW(ORA)
+DEF_ALU_ROW(CMP)
+
+// Immediate forms of the accumulator operations. XRI and ORI also clear carry so are written out below
+DEF_ALU(ADD, I)
+DEF_ALU(ADC, I)
+DEF_ALU(SUB, I)
+DEF_ALU(SBB, I)
+DEF_ALU(ANA, I)
+DEF_ALU(CMP, I)
+
+DEF_BRANCH(NZ)
+DEF_BRANCH(Z)
+DEF_BRANCH(NC)
+DEF_BRANCH(C)
+DEF_BRANCH(PO)
+DEF_BRANCH(PE)
+DEF_BRANCH(P)
+DEF_BRANCH(M)
+
+DEF_RST(0)
+DEF_RST(1)
+DEF_RST(2)
+DEF_RST(3)
+DEF_RST(4)
+DEF_RST(5)
+DEF_RST(6)
+DEF_RST(7)
+
+HANDLER(op_NOP) { return OPRESULT_OK; }
+
+HANDLER(op_unimplemented) {
+	unimplementedOpcode(state, opcode);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_STAX_B) { i8080op_writeMemory(state, i8080op_getBC(state), state->a); return OPRESULT_OK; }
+HANDLER(op_STAX_D) { i8080op_writeMemory(state, i8080op_getDE(state), state->a); return OPRESULT_OK; }
+HANDLER(op_LDAX_B) { state->a = i8080op_readMemory(state, i8080op_getBC(state)); return OPRESULT_OK; }
+HANDLER(op_LDAX_D) { state->a = i8080op_readMemory(state, i8080op_getDE(state)); return OPRESULT_OK; }
+
+HANDLER(op_RLC) { state->a = i8080op_rotateBitwiseLeft(state, state->a); return OPRESULT_OK; }
+HANDLER(op_RRC) { state->a = i8080op_rotateBitwiseRight(state, state->a); return OPRESULT_OK; }
+
+HANDLER(op_RAL) {
+	uint8_t bit7 = state->a >> 7;
+	state->a = (state->a << 1) | GET_FLAG(state, FLAG_C);
+	SET_FLAG(state, FLAG_C, bit7);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_RAR) {
+	SET_FLAG(state, FLAG_C, state->a & 0x01);
+	state->a = (state->a >> 1) | (state->a & 0x80);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_SHLD) {
+	i8080op_writeMemory(state, ADDRESS16, state->l);
+	i8080op_writeMemory(state, ADDRESS16 + 1, state->h);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_LHLD) {
+	state->l = i8080op_readMemory(state, ADDRESS16);
+	state->h = i8080op_readMemory(state, ADDRESS16 + 1);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_DAA) {
+	i8080op_resolveFlags(state);
+	i8080op_aluDaa(state);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_CMA) { state->a = ~state->a; return OPRESULT_OK; }
+HANDLER(op_STC) { state->f.psw |= FLAG_C; return OPRESULT_OK; }
+HANDLER(op_CMC) { state->f.psw ^= FLAG_C; return OPRESULT_OK; }
+
+HANDLER(op_LXI_SP) { i8080op_setSP(state, ADDRESS16); return OPRESULT_OK; }
+HANDLER(op_INX_SP) { i8080op_setSP(state, state->sp + 1); return OPRESULT_OK; }
+HANDLER(op_DCX_SP) { i8080op_setSP(state, state->sp - 1); return OPRESULT_OK; }
+HANDLER(op_DAD_SP) { i8080op_putHL16(state, i8080op_addCarry16(state, i8080op_getHL(state), state->sp)); return OPRESULT_OK; }
+HANDLER(op_SPHL) { i8080op_setSP(state, i8080op_getHL(state)); return OPRESULT_OK; }
+
+HANDLER(op_STA) { i8080op_writeMemory(state, ADDRESS16, state->a); return OPRESULT_OK; }
+HANDLER(op_LDA) { state->a = i8080op_readMemory(state, ADDRESS16); return OPRESULT_OK; }
+
+HANDLER(op_INR_M) {
+	uint8_t v = i8080op_readMemory(state, i8080op_getHL(state)) + 1;
+	LAZY_FLAGS(LAZY_ADD, v);
+	i8080op_writeMemory(state, i8080op_getHL(state), v);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_DCR_M) {
+	// Matches the switch, which uses the increment rule for the ac flag here
+	uint8_t v = i8080op_readMemory(state, i8080op_getHL(state)) - 1;
+	LAZY_FLAGS(LAZY_ADD, v);
+	i8080op_writeMemory(state, i8080op_getHL(state), v);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_MVI_M) { i8080op_writeMemory(state, i8080op_getHL(state), byte1); return OPRESULT_OK; }
+
+HANDLER(op_HLT) {
+	log_info("HLT called, halting");
+	i8080_halt(state);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_JMP) { i8080op_setPC(state, ADDRESS16); return OPRESULT_JUMPED; }
+HANDLER(op_CALL) { i8080op_executeCALL(state, ADDRESS16); return OPRESULT_JUMPED; }
+HANDLER(op_RET) { i8080op_executeRET(state); return OPRESULT_JUMPED; }
+HANDLER(op_PCHL) { i8080op_setPC(state, i8080op_getHL(state)); return OPRESULT_JUMPED; }
+
+HANDLER(op_PUSH_PSW) { i8080op_pushStack(state, i8080op_getPSW(state)); return OPRESULT_OK; }
+
+HANDLER(op_POP_PSW) {
+	uint16_t v = i8080op_popStack(state);
+	state->a = (v & 0xFF00) >> 8;
+	i8080op_putFlags(state, v & 0xFF);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_XTHL) {
+	uint16_t v = i8080op_popStack(state);
+	i8080op_pushStack(state, i8080op_getHL(state));
+	i8080op_putHL16(state, v);
+	return OPRESULT_OK;
+}
+
+HANDLER(op_XCHG) {
+	uint16_t v = state->de;
+	state->de = state->hl;
+	state->hl = v;
+	return OPRESULT_OK;
+}
+
+HANDLER(op_OUT) { port_out(state, byte1, state->a); state->f.tx = true; return OPRESULT_OK; }
+HANDLER(op_IN) { state->a = port_in(state, byte1); state->f.rx = true; return OPRESULT_OK; }
+HANDLER(op_DI) { state->f.ien = 0; return OPRESULT_OK; }
+HANDLER(op_EI) { state->f.ien = 1; return OPRESULT_OK; }
+
+HANDLER(op_XRI) { SET_FLAG(state, FLAG_C, 0); ALU_XRA(byte1); return OPRESULT_OK; }
+HANDLER(op_ORI) { SET_FLAG(state, FLAG_C, 0); ALU_ORA(byte1); return OPRESULT_OK; }
+
+/* Tables */
+
+// Every opcode with the handler I8080_OPCODE_LIST gives it
+#define HANDLER_ENTRY(hex, name, handler, ...) [0x##hex] = handler,
+const i8080OpHandler i8080_opHandlers[0x100] = { I8080_OPCODE_LIST(HANDLER_ENTRY) };
+
+bool i8080_dispatchOpcode(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2) {
+	state->f.rx = false;
+	state->f.tx = false;
+
+	uint8_t result = i8080_opHandlers[opcode](state, opcode, byte1, byte2);
+
+	if (!(result & OPRESULT_JUMPED))
+		state->pc += i8080_getInstructionLength(opcode);
+
+	return !(result & OPRESULT_FAILED);
+}
+
+#if defined(__GNUC__)
+
+int i8080_runThreaded(i8080State* state, int cycleBudget) {
+	// One label per opcode, each ending in its own copy of the dispatch so the host branch predictor sees a separate indirect jump per opcode
+	#define LABEL_ADDRESS(hex, ...) [0x##hex] = &&label_##hex,
+	static void* const labels[0x100] = { I8080_OPCODE_LIST(LABEL_ADDRESS) };
+
+	int cyclesUsed = 0;
+	uint8_t opcode;
+	uint8_t byte1;
+	uint8_t byte2;
+	uint8_t result;
+	int cycles;
+
+	#define DISPATCH() \
+		if (cyclesUsed >= cycleBudget || state->mode == MODE_HLT || state->mode == MODE_PANIC) \
+			goto done; \
+		checkInterrupts(state); \
+		I8080_IDLE_CHECK(state, cyclesUsed, cycleBudget); \
+		I8080_HLE_CHECK(state, cyclesUsed, cycleBudget); \
+		I8080_MEMO_CHECK(state, cyclesUsed, cycleBudget); \
+		opcode = i8080_fetch(state, &byte1, &byte2); \
+		if (state->traced) \
+			i8080_traceInstruction(state, opcode); \
+		state->f.rx = false; \
+		state->f.tx = false; \
+		goto *labels[opcode]
+
+	// The length and cycle counts come straight from the opcode list, constants in each copy
+	#define LABEL_BODY(hex, name, handler, mnemonic, format, length, cycles_, failedCycles, ...) \
+		label_##hex: \
+			result = handler(state, 0x##hex, byte1, byte2); \
+			if (!(result & OPRESULT_JUMPED)) \
+				state->pc += length; \
+			cycles = (result & OPRESULT_FAILED) ? failedCycles : cycles_; \
+			cyclesUsed += cycles; \
+			state->cyclesExecuted += cycles; \
+			state->interruptAccumulator += cycles; \
+			DISPATCH();
+
+	// A halted or panicked processor does not start a new instruction
+	if (state->mode == MODE_HLT || state->mode == MODE_PANIC)
+		return 0;
+
+	DISPATCH();
+	I8080_OPCODE_LIST(LABEL_BODY)
+
+done:
+	return cyclesUsed;
+
+	#undef LABEL_ADDRESS
+	#undef DISPATCH
+	#undef LABEL_BODY
+}
+
+#else
+
+int i8080_runThreaded(i8080State* state, int cycleBudget) {
+	// No computed goto on this compiler, call through the handler table from a tight loop instead
+	int cyclesUsed = 0;
+
+	while (cyclesUsed < cycleBudget) {
+		checkInterrupts(state);
+		I8080_IDLE_CHECK(state, cyclesUsed, cycleBudget);
+		I8080_HLE_CHECK(state, cyclesUsed, cycleBudget);
+		I8080_MEMO_CHECK(state, cyclesUsed, cycleBudget);
+
+		uint8_t byte1;
+		uint8_t byte2;
+		uint8_t opcode = i8080_fetch(state, &byte1, &byte2);
+		if (state->traced)
+			i8080_traceInstruction(state, opcode);
+
+		bool success = i8080_dispatchOpcode(state, opcode, byte1, byte2);
+		int cycles = success ? i8080_getInstructionClockCycles(opcode) : i8080_getFailedInstructionClockCycles(opcode);
+		cyclesUsed += cycles;
+		state->cyclesExecuted += cycles;
+		state->interruptAccumulator += cycles;
+
+		if (state->mode == MODE_HLT || state->mode == MODE_PANIC)
+			break;
+	}
+
+	return cyclesUsed;
+}
+
+#endif
+
+// The second instruction runs with the pc on it, as it would have been dispatched on its own
+#define DEF_FUSED(FIRST, SECOND) \
+	static uint8_t fused_##FIRST##_##SECOND(i8080State* state, const i8080MicroOp* first) { \
+		const i8080MicroOp* second = first + first->length; \
+		i8080_opHandlers[FIRST](state, FIRST, first->byte1, first->byte2); \
+		state->pc += first->length; \
+		uint8_t result = i8080_opHandlers[SECOND](state, SECOND, second->byte1, second->byte2); \
+		if (!(result & OPRESULT_JUMPED)) \
+			state->pc += second->length; \
+		return result | OPRESULT_JUMPED; \
+	}
+I8080_FUSED_LIST(DEF_FUSED)
+
+bool i8080_canFuse(uint8_t first, uint8_t second) {
+	if (i8080_opcodeInfo[first].kind & (OPK_JUMP | OPK_INTERRUPT))
+		return false;
+	uint16_t kinds = i8080_opcodeInfo[first].kind | i8080_opcodeInfo[second].kind;
+	return !(kinds & (OPK_HALT | OPK_IO | OPK_UNDOCUMENTED));
+}
+
+i8080FusedHandler i8080_findFusedHandler(uint8_t first, uint8_t second) {
+	#define FUSED_MATCH(FIRST, SECOND) if (first == FIRST && second == SECOND) return fused_##FIRST##_##SECOND;
+	I8080_FUSED_LIST(FUSED_MATCH)
+	return NULL;
+}
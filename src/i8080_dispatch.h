@@ -0,0 +1,37 @@
+#pragma once
+/*
+
+i8080_dispatch.h
+
+Table driven opcode dispatch. One handler per opcode instead of the switch in i8080_executeOpcode
+
+*/
+
+#include "i8080.h"
+
+// Handler results
+#define OPRESULT_OK 0x00 // Instruction completed, the pc moves past it
+#define OPRESULT_JUMPED 0x01 // Instruction set the pc itself, do not increment
+#define OPRESULT_FAILED 0x02 // Conditional instruction was not taken, use the failed cycle count
+
+// Executes one opcode with its operand bytes already fetched. Returns a combination of the OPRESULT_ bits
+typedef uint8_t (*i8080OpHandler)(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2);
+
+// Runs a predecoded instruction and the one straight after it in a single call. Moves the pc itself and returns the OPRESULT_ bits of the second instruction along with OPRESULT_JUMPED
+struct i8080MicroOp;
+typedef uint8_t (*i8080FusedHandler)(i8080State* state, const struct i8080MicroOp* first);
+
+// The handler for every opcode
+extern const i8080OpHandler i8080_opHandlers[0x100];
+
+// Executes an opcode through the handler table. Same contract as i8080_executeOpcode
+bool i8080_dispatchOpcode(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2);
+
+// Returns if two instructions could run as a fused pair: the first has to carry straight on to the second, and neither may halt, panic or touch a port
+bool i8080_canFuse(uint8_t first, uint8_t second);
+
+// Returns the fused handler for the pair if it is in I8080_FUSED_LIST, NULL otherwise
+i8080FusedHandler i8080_findFusedHandler(uint8_t first, uint8_t second);
+
+// Runs instructions through a threaded dispatch loop (computed goto where the compiler supports it, the handler table otherwise). Same contract as i8080_run, but does not drain waitCycles
+int i8080_runThreaded(i8080State* state, int cycleBudget);
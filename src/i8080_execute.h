@@ -0,0 +1,983 @@
+/*
+
+i8080_execute.h
+
+Body of the switch core. i8080.c includes it twice: once with EXECUTE_TRACED set to 1 for the instrumented core, which
+logs every instruction through log_trace as i8080_disassemble writes it, and once with it set to 0 for the lean core, where
+the trace compiles to nothing. No include guard on purpose
+
+*/
+
+
+bool EXECUTE_OPCODE(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2) {
+	bool success = true;
+	bool pcShouldIncrement = true;
+
+	int byteLen = i8080_getInstructionLength(opcode);
+
+	uint16_t store16_1;
+	uint8_t store8_1;
+	uint8_t store8_2;
+
+	state->f.rx = false;
+	state->f.tx = false;
+
+#if EXECUTE_TRACED
+	char disassembly[I8080_DISASSEMBLY_LEN];
+	log_trace("[%04X] %-12s A:%02X BC:%04X DE:%04X HL:%04X SP:%04X PSW:%02X", state->pc, i8080_disassemble(disassembly, opcode, byte1, byte2),
+		state->a, state->bc, state->de, state->hl, state->sp, I8080_FLAGS(state)->psw);
+#endif
+
+	switch (opcode) {
+	case NOP: // Do nothing
+		break;
+	case LXI_B: // put in BC D16
+		i8080op_putBC16(state, ((uint16_t)byte2 << 8) | byte1);
+		break;
+	case STAX_B: // write value of A to memory[BC]
+		i8080op_writeMemory(state, i8080op_getBC(state), state->a);
+		break;
+	case INX_B: // Increment BC
+		i8080op_putBC16(state, 1 + i8080op_getBC(state));
+		break;
+	case INR_B: // Increment B
+		state->b = state->b + 1;
+		i8080_acFlagSetInc(state, state->b);i8080op_setZSP(state, state->b);
+		break;
+	case DCR_B: // Decrement B
+		state->b = state->b - 1;
+		i8080_acFlagSetDcr(state, state->b);i8080op_setZSP(state, state->b);
+		break;
+	case MVI_B: // Put byte1 into B
+		state->b = byte1;
+		break;
+	case RLC: // Bitshift and place the dropped bit in the carry flag and bit 0 of the new number
+		state->a = i8080op_rotateBitwiseLeft(state, state->a);
+		break;
+	case DAD_B: // HL += BC
+		i8080op_putHL16(state, i8080op_addCarry16(state, i8080op_getHL(state), i8080op_getBC(state)));
+		break;
+	case LDAX_B: // Load memory pointed to by BC into A
+		state->a = i8080op_readMemory(state, i8080op_getBC(state));
+		break;
+	case DCX_B: // Decrement BC by 1
+		i8080op_putBC16(state, i8080op_getBC(state) - 1);
+		break;
+	case INR_C: // Increment C by 1
+		state->c = state->c + 1;
+		i8080_acFlagSetInc(state, state->c);i8080op_setZSP(state, state->c);
+		break;
+	case DCR_C: // Decrement C by 1
+		state->c = state->c - 1;
+		i8080_acFlagSetDcr(state, state->c);i8080op_setZSP(state, state->c);
+		break;
+	case MVI_C: // Put byte1 into C
+		state->c = byte1;
+		break;
+	case RRC: // Bitshift and place the dropped bit in the carry flag and bit 7 of the new number
+		state->a = i8080op_rotateBitwiseRight(state, state->a);
+		break;
+	case LXI_D: // put in DE D16
+		i8080op_putDE16(state, ((uint16_t)byte2 << 8) | byte1);
+		break;
+	case STAX_D: // write value of A to memory[DE]
+		i8080op_writeMemory(state, i8080op_getDE(state), state->a);
+		break;
+	case INX_D: // Increment DE
+		i8080op_putDE16(state, 1 + i8080op_getDE(state));
+		break;
+	case INR_D: // Increment D
+		state->d = state->d + 1;
+		i8080_acFlagSetInc(state, state->d);i8080op_setZSP(state, state->d);
+		break;
+	case DCR_D: // Decrement D
+		state->d = state->d - 1;
+		i8080_acFlagSetDcr(state, state->d);i8080op_setZSP(state, state->d);
+		break;
+	case MVI_D: // Put byte1 into D
+		state->d = byte1;
+		break;
+	case RAL: // Bitshift left 1 and use CY as bit 0, and store dropped bit 7 in CY after
+		store8_1 = (state->a >> 7); // Get the 7th bit
+		state->a = (state->a << 1) | GET_FLAG(state, FLAG_C); // Store the CY in 0th bit
+		SET_FLAG(state, FLAG_C, store8_1); // Store 7th bit the carry flag
+		break;
+	case DAD_D: // HL += DE
+		i8080op_putHL16(state, i8080op_addCarry16(state, i8080op_getHL(state), i8080op_getDE(state)));
+		break;
+	case LDAX_D: // Load memory pointed to by DE into A
+		state->a = i8080op_readMemory(state, i8080op_getDE(state));
+		break;
+	case DCX_D: // Decrement DE by 1
+		i8080op_putDE16(state, i8080op_getDE(state) - 1);
+		break;
+	case INR_E: // Increment E by 1
+		state->e = state->e + 1;
+		i8080_acFlagSetInc(state, state->e);i8080op_setZSP(state, state->e);
+		break;
+	case DCR_E: // Decrement E by 1
+		state->e = state->e - 1;
+		i8080_acFlagSetDcr(state, state->e);i8080op_setZSP(state, state->e);
+		break;
+	case MVI_E: // Put byte1 into C
+		state->e = byte1;
+		break;
+	case RAR: // Bitshift and place the dropped bit in the carry flag, set bit 7 to old bit 7
+		store8_1 = state->a & 0x01; // Get the 0th bit
+		store8_2 = state->a & 0x80; // Get the 7th bit
+		SET_FLAG(state, FLAG_C, store8_1); // Store it in the carry flag
+		state->a = (state->a >> 1) | store8_2; // Store the 7th bit in position
+		break;
+	case LXI_H: // put in HL D16
+		i8080op_putHL16(state, ((uint16_t)byte2 << 8) | byte1);
+		break;
+	case SHLD: // write value of HL to memory[store16_1]
+		store16_1 = (uint16_t)byte1 + (((uint16_t)byte2) << 8);
+		i8080op_writeMemory(state, store16_1, state->l);
+		i8080op_writeMemory(state, store16_1 + 1, state->h);
+		break;
+	case INX_H: // Increment HL
+		i8080op_putHL16(state, 1 + i8080op_getHL(state));
+		break;
+	case INR_H: // Increment H
+		state->h = state->h + 1;
+		i8080_acFlagSetInc(state, state->h);i8080op_setZSP(state, state->h);
+		break;
+	case DCR_H: // Decrement D
+		state->h = state->h - 1;
+		i8080_acFlagSetDcr(state, state->h);i8080op_setZSP(state, state->h);
+		break;
+	case MVI_H: // Put byte1 into H
+		state->h = byte1;
+		break;
+	case DAA:
+		// Special, throw a warning but NOP
+		i8080op_aluDaa(state);
+		break;
+	case DAD_H: // HL += HL
+		i8080op_putHL16(state, i8080op_addCarry16(state, i8080op_getHL(state), i8080op_getHL(state)));
+		break;
+	case LHLD: // Load L with memory[store16_1] and H with memory[store16_1 + 1]
+		store16_1 = (uint16_t)byte1 + (((uint16_t)byte2) << 8);
+		state->l = i8080op_readMemory(state, store16_1);
+		state->h = i8080op_readMemory(state, store16_1 + 1);
+		break;
+	case DCX_H: // Decrement HL by 1
+		i8080op_putHL16(state, i8080op_getHL(state) - 1);
+		break;
+	case INR_L: // Increment L by 1
+		state->l = state->l + 1;
+		i8080_acFlagSetInc(state, state->l);i8080op_setZSP(state, state->l);
+		break;
+	case DCR_L: // Decrement L by 1
+		state->l = state->l - 1;
+		i8080_acFlagSetDcr(state, state->l);i8080op_setZSP(state, state->l);
+		break;
+	case MVI_L: // Put byte1 into L
+		state->l = byte1;
+		break;
+	case CMA: // a set to bitwise not of a
+		state->a = ~state->a;
+		break;
+	case LXI_SP:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // D16
+		i8080op_setSP(state, store16_1); // Set the sp to D16
+		break;
+	case STA: // write value of A to memory[store16_1]
+		store16_1 = (uint16_t)byte1 + (((uint16_t)byte2) << 8);
+		i8080op_writeMemory(state, store16_1, state->a);
+		break;
+	case INX_SP:
+		i8080op_setSP(state, state->sp + 1);
+		break;
+	case INR_M:
+		store8_1 = i8080op_readMemory(state, i8080op_getHL(state));
+		store8_1 += 1;
+		i8080_acFlagSetInc(state, store8_1);i8080op_setZSP(state, store8_1);
+		i8080op_writeMemory(state, i8080op_getHL(state), store8_1);
+		break;
+	case DCR_M:
+		store8_1 = i8080op_readMemory(state, i8080op_getHL(state));
+		store8_1 -= 1;
+		i8080_acFlagSetInc(state, store8_1);i8080op_setZSP(state, store8_1);
+		i8080op_writeMemory(state, i8080op_getHL(state), store8_1);
+		break;
+	case MVI_M: // Put byte1 into memory[HL]
+		i8080op_writeMemory(state, i8080op_getHL(state), byte1);
+		break;
+	case STC:
+		SET_FLAG(state, FLAG_C, 1);
+		break;
+	case DAD_SP: // HL += SP
+		i8080op_putHL16(state, i8080op_addCarry16(state, i8080op_getHL(state), state->sp));
+		break;
+	case LDA: // load value of A from memory[store16_1]
+		store16_1 = (uint16_t)byte1 + (((uint16_t)byte2) << 8);
+		state->a = i8080op_readMemory(state, store16_1);
+		break;
+	case DCX_SP:
+		i8080op_setSP(state, state->sp - 1);
+		break;
+	case INR_A:
+		state->a = state->a + 1;
+		i8080_acFlagSetInc(state, state->a);i8080op_setZSP(state, state->a);
+		break;
+	case DCR_A:
+		state->a = state->a - 1;
+		i8080_acFlagSetDcr(state, state->a);i8080op_setZSP(state, state->a);
+		break;
+	case MVI_A: // Put byte1 into A
+		state->a = byte1;
+		break;
+	case CMC:
+		SET_FLAG(state, FLAG_C, !GET_FLAG(state, FLAG_C));
+		break;
+	case MOV_BB:
+		state->b = state->b;
+		break;
+	case MOV_BC:
+		state->b = state->c;
+		break;
+	case MOV_BD:
+		state->b = state->d;
+		break;
+	case MOV_BE:
+		state->b = state->e;
+		break;
+	case MOV_BH:
+		state->b = state->h;
+		break;
+	case MOV_BL:
+		state->b = state->l;
+		break;
+	case MOV_BM:
+		state->b = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_BA:
+		state->b = state->a;
+		break;
+	case MOV_CB:
+		state->c = state->b;
+		break;
+	case MOV_CC:
+		state->c = state->c;
+		break;
+	case MOV_CD:
+		state->c = state->d;
+		break;
+	case MOV_CE:
+		state->c = state->e;
+		break;
+	case MOV_CH:
+		state->c = state->h;
+		break;
+	case MOV_CL:
+		state->c = state->l;
+		break;
+	case MOV_CM:
+		state->c = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_CA:
+		state->c = state->a;
+		break;
+	case MOV_DB:
+		state->d = state->b;
+		break;
+	case MOV_DC:
+		state->d = state->c;
+		break;
+	case MOV_DD:
+		state->d = state->d;
+		break;
+	case MOV_DE:
+		state->d = state->e;
+		break;
+	case MOV_DH:
+		state->d = state->h;
+		break;
+	case MOV_DL:
+		state->d = state->l;
+		break;
+	case MOV_DM:
+		state->d = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_DA:
+		state->d = state->a;
+		break;
+	case MOV_EB:
+		state->e = state->b;
+		break;
+	case MOV_EC:
+		state->e = state->c;
+		break;
+	case MOV_ED:
+		state->e = state->d;
+		break;
+	case MOV_EE:
+		state->e = state->e;
+		break;
+	case MOV_EH:
+		state->e = state->h;
+		break;
+	case MOV_EL:
+		state->e = state->l;
+		break;
+	case MOV_EM:
+		state->e = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_EA:
+		state->e = state->a;
+		break;
+	case MOV_HB:
+		state->h = state->b;
+		break;
+	case MOV_HC:
+		state->h = state->c;
+		break;
+	case MOV_HD:
+		state->h = state->d;
+		break;
+	case MOV_HE:
+		state->h = state->e;
+		break;
+	case MOV_HH:
+		state->h = state->h;
+		break;
+	case MOV_HL:
+		state->h = state->l;
+		break;
+	case MOV_HM:
+		state->h = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_HA:
+		state->h = state->a;
+		break;
+	case MOV_LB:
+		state->l = state->b;
+		break;
+	case MOV_LC:
+		state->l = state->c;
+		break;
+	case MOV_LD:
+		state->l = state->d;
+		break;
+	case MOV_LE:
+		state->l = state->e;
+		break;
+	case MOV_LH:
+		state->l = state->h;
+		break;
+	case MOV_LL:
+		state->l = state->l;
+		break;
+	case MOV_LM:
+		state->l = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_LA:
+		state->l = state->a;
+		break;
+	case MOV_MB:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->b);
+		break;
+	case MOV_MC:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->c);
+		break;
+	case MOV_MD:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->d);
+		break;
+	case MOV_ME:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->e);
+		break;
+	case MOV_MH:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->h);
+		break;
+	case MOV_ML:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->l);
+		break;
+	case MOV_MA:
+		i8080op_writeMemory(state, i8080op_getHL(state), state->a);
+		break;
+	case HLT:
+		// HALT THE PROGRAM?
+		log_info("[%04X] HLT(%02X)", state->pc, HLT);
+		i8080_halt(state);
+		break;
+	case MOV_AB:
+		state->a = state->b;
+		break;
+	case MOV_AC:
+		state->a = state->c;
+		break;
+	case MOV_AD:
+		state->a = state->d;
+		break;
+	case MOV_AE:
+		state->a = state->e;
+		break;
+	case MOV_AH:
+		state->a = state->h;
+		break;
+	case MOV_AL:
+		state->a = state->l;
+		break;
+	case MOV_AM:
+		state->a = i8080op_readMemory(state, i8080op_getHL(state));
+		break;
+	case MOV_AA:
+		state->a = state->a;
+		break;
+	case ADD_B: // Adds B to A
+		i8080op_aluAdd(state, state->b, 0);
+		break;
+	case ADD_C: // Adds C to A
+		i8080op_aluAdd(state, state->c, 0);
+		break;
+	case ADD_D: // Adds D to A
+		i8080op_aluAdd(state, state->d, 0);
+		break;
+	case ADD_E: // Adds E to A
+		i8080op_aluAdd(state, state->e, 0);
+		break;
+	case ADD_H: // Adds H to A
+		i8080op_aluAdd(state, state->h, 0);
+		break;
+	case ADD_L: // Adds L to A
+		i8080op_aluAdd(state, state->l, 0);
+		break;
+	case ADD_M: // Adds memory[HL] to A
+		i8080op_aluAdd(state, i8080op_readMemory(state, i8080op_getHL(state)), 0);
+		break;
+	case ADD_A: // Adds A to A
+		i8080op_aluAdd(state, state->a, 0);
+		break;
+	case ADC_B: // Adds B to A
+		i8080op_aluAdd(state, state->b, GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_C: // Adds C to A
+		i8080op_aluAdd(state, state->c, GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_D: // Adds D to A
+		i8080op_aluAdd(state, state->d, GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_E: // Adds E to A
+		i8080op_aluAdd(state, state->e, GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_H: // Adds H to A
+		i8080op_aluAdd(state, state->h, GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_L: // Adds L to A
+		i8080op_aluAdd(state, state->l, GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_M: // Adds memory[HL] to A
+		i8080op_aluAdd(state, i8080op_readMemory(state, i8080op_getHL(state)), GET_FLAG(state, FLAG_C));
+		break;
+	case ADC_A: // Adds A to A
+		i8080op_aluAdd(state, state->a, GET_FLAG(state, FLAG_C));
+		break;
+	case SUB_B: // takes B from A
+		i8080op_aluSub(state, state->b, 0);
+		break;
+	case SUB_C: // takes C from A
+		i8080op_aluSub(state, state->c, 0);
+		break;
+	case SUB_D: // takes D from A
+		i8080op_aluSub(state, state->d, 0);
+		break;
+	case SUB_E: // takes E from A
+		i8080op_aluSub(state, state->e, 0);
+		break;
+	case SUB_H: // takes H from A
+		i8080op_aluSub(state, state->h, 0);
+		break;
+	case SUB_L: // takes L from A
+		i8080op_aluSub(state, state->l, 0);
+		break;
+	case SUB_M: // takes memory[HL] from A
+		i8080op_aluSub(state, i8080op_readMemory(state, i8080op_getHL(state)), 0);
+		break;
+	case SUB_A: // takes A from A
+		i8080op_aluSub(state, state->a, 0);
+		break;
+	case SBB_B:
+		i8080op_aluSub(state, state->b, GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_C:
+		i8080op_aluSub(state, state->c, GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_D:
+		i8080op_aluSub(state, state->d, GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_E:
+		i8080op_aluSub(state, state->e, GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_H:
+		i8080op_aluSub(state, state->h, GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_L:
+		i8080op_aluSub(state, state->l, GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_M:
+		i8080op_aluSub(state, i8080op_readMemory(state, i8080op_getHL(state)), GET_FLAG(state, FLAG_C));
+		break;
+	case SBB_A:
+		i8080op_aluSub(state, state->a, GET_FLAG(state, FLAG_C));
+		break;
+	case ANA_B:
+		i8080_acFlagSetAna(state, state->b);
+		state->a = state->a & state->b;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_C:
+		i8080_acFlagSetAna(state, state->c);
+		state->a = state->a & state->c;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_D:
+		i8080_acFlagSetAna(state, state->d);
+		state->a = state->a & state->d;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_E:
+		i8080_acFlagSetAna(state, state->e);
+		state->a = state->a & state->e;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_H:
+		i8080_acFlagSetAna(state, state->h);
+		state->a = state->a & state->h;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_L:
+		i8080_acFlagSetAna(state, state->l);
+		state->a = state->a & state->l;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_M:
+		i8080_acFlagSetAna(state, i8080op_readMemory(state, i8080op_getHL(state)));
+		state->a = state->a & i8080op_readMemory(state, i8080op_getHL(state));
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case ANA_A:
+		i8080_acFlagSetAna(state, state->a);
+		state->a = state->a & state->a;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case XRA_B:
+		state->a = state->a ^ state->b;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_C:
+		state->a = state->a ^ state->c;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_D:
+		state->a = state->a ^ state->d;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_E:
+		state->a = state->a ^ state->e;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_H:
+		state->a = state->a ^ state->h;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_L:
+		state->a = state->a ^ state->l;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_M:
+		state->a = state->a ^ i8080op_readMemory(state, i8080op_getHL(state));
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case XRA_A:
+		state->a = state->a ^ state->a;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_B:
+		state->a = state->a | state->b;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_C:
+		state->a = state->a | state->c;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_D:
+		state->a = state->a | state->d;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_E:
+		state->a = state->a | state->e;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_H:
+		state->a = state->a | state->h;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_L:
+		state->a = state->a | state->l;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_M:
+		state->a = state->a | i8080op_readMemory(state, i8080op_getHL(state));
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case ORA_A:
+		state->a = state->a | state->a;
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case CMP_B: // takes B from A
+		i8080op_aluCmp(state, state->b);
+		break;
+	case CMP_C: // takes C from A
+		i8080op_aluCmp(state, state->c);
+		break;
+	case CMP_D: // takes D from A
+		i8080op_aluCmp(state, state->d);
+		break;
+	case CMP_E: // takes E from A
+		i8080op_aluCmp(state, state->e);
+		break;
+	case CMP_H: // takes H from A
+		i8080op_aluCmp(state, state->h);
+		break;
+	case CMP_L: // takes L from A
+		i8080op_aluCmp(state, state->l);
+		break;
+	case CMP_M: // takes memory[HL] from A
+		i8080op_aluCmp(state, i8080op_readMemory(state, i8080op_getHL(state)));
+		break;
+	case CMP_A: // takes A from A
+		i8080op_aluCmp(state, state->a);
+		break;
+	case RNZ:
+		if (!GET_FLAG(state, FLAG_Z)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = !GET_FLAG(state, FLAG_Z);
+		break;
+	case POP_B:
+		i8080op_putBC16(state, i8080op_popStack(state));
+		break;
+	case JNZ:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_Z) == 0) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case JMP:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case CNZ:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (!GET_FLAG(state, FLAG_Z)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = !GET_FLAG(state, FLAG_Z);
+		break;
+	case PUSH_B:
+		i8080op_pushStack(state, i8080op_getBC(state));
+		break;
+	case ADI: // Adds D8 to A
+		i8080op_aluAdd(state, byte1, 0);
+		break;
+	case RST_0: // Call $0x0
+		i8080op_executeCALL(state, INTERRUPT_0);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RZ:
+		if (GET_FLAG(state, FLAG_Z)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = GET_FLAG(state, FLAG_Z);
+		break;
+	case RET:
+		pcShouldIncrement = false;
+		i8080op_executeRET(state);
+		break;
+	case JZ:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_Z) == 1) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case CZ:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (GET_FLAG(state, FLAG_Z)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = GET_FLAG(state, FLAG_Z);
+		break;
+	case CALL:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		i8080op_executeCALL(state, store16_1);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case ACI: // Adds D8 to A
+		i8080op_aluAdd(state, byte1, GET_FLAG(state, FLAG_C));
+		break;
+	case RST_1:
+		i8080op_executeCALL(state, INTERRUPT_1);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RNC:
+		if (!GET_FLAG(state, FLAG_C)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = !GET_FLAG(state, FLAG_C);
+		break;
+	case POP_D:
+		i8080op_putDE16(state, i8080op_popStack(state));
+		break;
+	case JNC:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_C) == 0) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case OUT:
+		port_out(state, byte1, state->a);
+		state->f.tx = true;
+		break;
+	case CNC:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (!GET_FLAG(state, FLAG_C)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = !GET_FLAG(state, FLAG_C);
+		break;
+	case PUSH_D:
+		i8080op_pushStack(state, i8080op_getDE(state));
+		break;
+	case SUI: // takes D8 from A
+		i8080op_aluSub(state, byte1, 0);
+		break;
+	case RST_2:
+		i8080op_executeCALL(state, INTERRUPT_2);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RC:
+		if (GET_FLAG(state, FLAG_C)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = GET_FLAG(state, FLAG_C);
+		break;
+	case JC:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_C) == 1) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case IN: // TODO
+		state->a = port_in(state, byte1);
+		state->f.rx = true;
+		break;
+	case CC:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (GET_FLAG(state, FLAG_C)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = GET_FLAG(state, FLAG_C);
+		break;
+	case SBI: // takes D8 from A
+		i8080op_aluSub(state, byte1, GET_FLAG(state, FLAG_C));
+		break;
+	case RST_3:
+		i8080op_executeCALL(state, INTERRUPT_3);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RPO:
+		if (!GET_FLAG(state, FLAG_P)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = !GET_FLAG(state, FLAG_P);
+		break;
+	case POP_H:
+		i8080op_putHL16(state, i8080op_popStack(state));
+		break;
+	case JPO:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_P) == 0) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case XTHL:
+		store16_1 = i8080op_popStack(state);
+		i8080op_pushStack(state, i8080op_getHL(state));
+		i8080op_putHL16(state, store16_1);
+		break;
+	case CPO:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (!GET_FLAG(state, FLAG_P)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = !GET_FLAG(state, FLAG_P);
+		break;
+	case PUSH_H:
+		i8080op_pushStack(state, i8080op_getHL(state));
+		break;
+	case ANI:
+		i8080_acFlagSetAna(state, byte1);
+		state->a = state->a & byte1;
+		SET_FLAG(state, FLAG_C, 0);
+		i8080op_setZSP(state, state->a);
+		break;
+	case RST_4:
+		i8080op_executeCALL(state, INTERRUPT_4);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RPE:
+		if (GET_FLAG(state, FLAG_P)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = GET_FLAG(state, FLAG_P);
+		break;
+	case PCHL:
+		i8080op_setPC(state, i8080op_getHL(state));
+		pcShouldIncrement = false;
+		break;
+	case JPE:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_P) == 1) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case XCHG:
+		store16_1 = state->de;
+		state->de = state->hl;
+		state->hl = store16_1;
+		break;
+	case CPE:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (GET_FLAG(state, FLAG_P)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = GET_FLAG(state, FLAG_P);
+		break;
+	case XRI:
+		state->a = state->a ^ byte1;
+		SET_FLAG(state, FLAG_C, 0);
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case RST_5:
+		i8080op_executeCALL(state, INTERRUPT_5);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RP:
+		if (!GET_FLAG(state, FLAG_S)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = !GET_FLAG(state, FLAG_S);
+		break;
+	case POP_PSW:
+		store16_1 = i8080op_popStack(state);
+		state->a = (store16_1 & 0xFF00) >> 8;
+		i8080op_putFlags(state, store16_1 & 0xFF);
+		break;
+	case JP:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_S) == 0) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case DI:
+		state->f.ien = 0;
+		break;
+	case CP:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (!GET_FLAG(state, FLAG_S)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = !GET_FLAG(state, FLAG_S);
+		break;
+	case PUSH_PSW:
+		i8080op_pushStack(state, i8080op_getPSW(state));
+		break;
+	case ORI:
+		state->a = state->a | byte1;
+		SET_FLAG(state, FLAG_C, 0);
+		SET_FLAG(state, FLAG_AC, 0);i8080op_setZSP(state, state->a);
+		break;
+	case RST_6:
+		i8080op_executeCALL(state, INTERRUPT_6);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	case RM:
+		if (GET_FLAG(state, FLAG_S)) {
+			pcShouldIncrement = false;
+			i8080op_executeRET(state);
+		}
+		success = GET_FLAG(state, FLAG_S);
+		break;
+	case SPHL:
+		i8080op_setSP(state, i8080op_getHL(state));
+		break;
+	case JM:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // jmpPos
+		if (GET_FLAG(state, FLAG_S) == 1) {
+			i8080op_setPC(state, store16_1); // Set the pc to jmpPos
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		break;
+	case EI:
+		state->f.ien = 1;
+		break;
+	case CM:
+		store16_1 = ((uint16_t)byte2 << 8) + byte1; // address
+		if (GET_FLAG(state, FLAG_S)) {
+			i8080op_executeCALL(state, store16_1);
+			pcShouldIncrement = false; // Stop the auto increment
+		}
+		success = GET_FLAG(state, FLAG_S);
+		break;
+	case CPI:
+		i8080op_aluCmp(state, byte1);
+		break;
+	case RST_7:
+		i8080op_executeCALL(state, INTERRUPT_7);
+		pcShouldIncrement = false; // Stop the auto increment
+		break;
+	default:
+		unimplementedOpcode(state, opcode);
+		break;
+	}
+
+	// Determine how we increment our pc
+	if (pcShouldIncrement) {
+		state->pc += byteLen;
+	}
+
+	return success;
+}
+
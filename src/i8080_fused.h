@@ -0,0 +1,15 @@
+#pragma once
+/*
+
+i8080_fused.h
+
+Instruction pairs the fused core runs as one handler. Taken from the "Fusable pairs" of the invaders workload in
+i8080_profile.log (--profile), most frequent first. Every pair must pass i8080_canFuse
+
+*/
+
+// X(first opcode, second opcode)
+#define I8080_FUSED_LIST(X) \
+	X(LDA, DCR_A) X(DCR_A, JNZ) X(LDA, ANA_A) X(ANA_A, JNZ) \
+	X(INX_H, MOV_AH) X(MVI_M, INX_H) X(MOV_AH, CPI) X(CPI, JNZ) \
+	X(RRC, JC) X(ANA_A, JZ) X(DCR_B, JNZ) X(LDAX_D, MOV_MA)
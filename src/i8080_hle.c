@@ -0,0 +1,283 @@
+/*
+
+i8080_hle.c
+
+High level emulation of ROM routines. The registry holds the invaders screen clear, block copy and sprite column loops
+
+*/
+
+#include "i8080_hle.h"
+#include "i8080.h"
+#include "i8080_blockcache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+uint8_t i8080_hleFilter[0x100];
+
+// Stores as i8080op_writeMemory does, straight through the page where it would store the value unchanged
+I8080_INLINE void hleWrite(i8080State* state, uint16_t address, uint8_t value) {
+	const i8080BusPage* page = &state->bus->pages[address >> 8];
+	int codePage = (page->offset + (address & 0xFF)) / BLOCK_PAGE_SIZE;
+	if (page->write != NULL && (state->blockCache == NULL || !state->blockCache->codePages[codePage]) && (state->bus->hle == NULL || !state->bus->hle->codePages[codePage]))
+		page->write[address & 0xFF] = value;
+	else
+		i8080op_writeMemory(state, address, value);
+}
+
+// ClearScreen, 1A5C. MVI M,0 INX H MOV A,H CPI 40 JNZ 1A5F until HL reaches 0x4000, every byte of the screen zeroed
+static int clearScreenPassesLeft(i8080State* state) {
+	if (((state->hl + 1) & 0xFFFF) >> 8 == 0x40)
+		return 1;
+	int passes = (0x4000 - state->hl) & 0xFFFF;
+	return passes == 0 ? 0x10000 : passes;
+}
+
+static void clearScreenRun(i8080State* state, int passes) {
+	for (int i = 0; i < passes; i++) {
+		hleWrite(state, state->hl, 0x00);
+		state->hl++;
+	}
+	state->a = state->h;
+	i8080op_aluCmp(state, 0x40);
+}
+
+// BlockCopy, 1A32. LDAX D MOV M,A INX H INX D DCR B JNZ 1A32, B bytes from DE to HL
+static int blockCopyPassesLeft(i8080State* state) {
+	return state->b == 0 ? 0x100 : state->b;
+}
+
+static void blockCopyRun(i8080State* state, int passes) {
+	for (int i = 0; i < passes; i++) {
+		state->a = i8080_busRead(state, state->de);
+		hleWrite(state, state->hl, state->a);
+		state->hl++;
+		state->de++;
+		state->b--;
+	}
+	i8080_acFlagSetDcr(state, state->b);
+	i8080op_setZSP(state, state->b);
+}
+
+// DrawSimpSprite, 1439. PUSH B LDAX D MOV M,A INX D LXI B,0020 DAD B POP B DCR B JNZ 1439, B bytes from DE down a
+// column of the screen, one row of 0x20 bytes apart each. Used by DrawChar for every character of text
+static int drawSpritePassesLeft(i8080State* state) {
+	return state->b == 0 ? 0x100 : state->b;
+}
+
+static void drawSpriteRun(i8080State* state, int passes) {
+	for (int i = 0; i < passes; i++) {
+		hleWrite(state, state->sp - 1, state->b);
+		hleWrite(state, state->sp - 2, state->c);
+		state->a = i8080_busRead(state, state->de);
+		hleWrite(state, state->hl, state->a);
+		state->de++;
+		state->hl = i8080op_addCarry16(state, state->hl, 0x0020);
+		// POP B gives back what PUSH B stored, unless the column ran over it
+		state->c = i8080_busRead(state, state->sp - 2);
+		state->b = i8080_busRead(state, state->sp - 1) - 1;
+	}
+	i8080_acFlagSetDcr(state, state->b);
+	i8080op_setZSP(state, state->b);
+}
+
+i8080HleRoutine i8080_hleRoutines[HLE_ROUTINE_COUNT] = {
+	{ .name = "ClearScreen", .entry = 0x1A5F, .length = 10, .hash = 0x5434E794, .passesLeft = clearScreenPassesLeft, .run = clearScreenRun },
+	{ .name = "BlockCopy", .entry = 0x1A32, .length = 9, .hash = 0x4188CC0E, .passesLeft = blockCopyPassesLeft, .run = blockCopyRun },
+	{ .name = "DrawSimpSprite", .entry = 0x1439, .length = 14, .hash = 0x61476FBE, .passesLeft = drawSpritePassesLeft, .run = drawSpriteRun },
+};
+
+void i8080_hleInit(void) {
+	memset(i8080_hleFilter, 0, sizeof(i8080_hleFilter));
+	for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+		i8080_hleFilter[i8080_hleRoutines[i].entry & 0xFF] = 1;
+	}
+}
+
+// Whether the code at the head is the routine, hashing it once and marking the pages it is on so a write forgets the match
+static bool hleMatches(i8080State* state, const i8080HleRoutine* routine, i8080HleFound* found) {
+	if (found->match != HLE_MATCH_UNKNOWN)
+		return found->match == HLE_MATCH_FOUND;
+
+	uint32_t hash = FNV_OFFSET_BASIS;
+	for (int j = 0; j < routine->length; j++) {
+		uint16_t address = routine->entry + j;
+		hash ^= i8080_busRead(state, address);
+		hash *= FNV_PRIME;
+		int page = i8080op_mirrorAddress(state, address) / BLOCK_PAGE_SIZE;
+		state->bus->hle->codePages[page] = true;
+		// The JIT stores straight to pages holding no cached code, mark the page for it too so a store comes through
+		// i8080op_writeMemory
+		if (state->blockCache != NULL)
+			state->blockCache->codePages[page] = true;
+	}
+	found->match = hash == routine->hash ? HLE_MATCH_FOUND : HLE_MATCH_NONE;
+	if (found->match == HLE_MATCH_NONE)
+		return false;
+
+	// Every routine is a loop of straight line code up to its JNZ back to the head, then the RET
+	uint16_t pc = routine->entry;
+	uint8_t opcode = i8080_busRead(state, pc);
+	int cycles = 0;
+	while (opcode != JNZ) {
+		cycles += i8080_getInstructionClockCycles(opcode);
+		pc += i8080_getInstructionLength(opcode);
+		opcode = i8080_busRead(state, pc);
+	}
+	// A jump takes as long whether it is taken or not, only calls and returns have a failed cycle count
+	found->passCycles = cycles + i8080_getInstructionClockCycles(JNZ);
+	found->lastCycles = found->passCycles + i8080_getInstructionClockCycles(RET);
+	return true;
+}
+
+// The routine whose code is at the pc, or -1 if the code there is not one of the registry
+static int hleLookup(i8080State* state) {
+	for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+		if (i8080_hleRoutines[i].entry != state->pc)
+			continue;
+
+		if (state->bus->hle == NULL) {
+			state->bus->hle = calloc(1, sizeof(i8080Hle));
+			if (state->bus->hle == NULL) {
+				log_error("Failed to allocate memory for HLE, turning it off");
+				state->hle = HLE_OFF;
+				return -1;
+			}
+		}
+		return hleMatches(state, &i8080_hleRoutines[i], &state->bus->hle->found[i]) ? i : -1;
+	}
+	return -1;
+}
+
+// Runs the passes through the ROM code on the state and through the native routine on a copy of it, and compares the two
+static int hleVerify(i8080State* state, const i8080HleRoutine* routine, i8080HleFound* found, int passes, bool finished, int cycles) {
+	i8080Hle* hle = state->bus->hle;
+	if (hle->shadowMemory == NULL) {
+		hle->shadowMemory = malloc(i8080_MEMORY_SIZE);
+		hle->shadowBus = malloc(sizeof(i8080Bus));
+		if (hle->shadowMemory == NULL || hle->shadowBus == NULL) {
+			log_error("Failed to allocate memory for HLE verification");
+			free(hle->shadowMemory);
+			free(hle->shadowBus);
+			hle->shadowMemory = NULL;
+			hle->shadowBus = NULL;
+			return 0;
+		}
+	}
+
+	i8080State shadow = *state;
+	shadow.memory = hle->shadowMemory;
+	shadow.bus = hle->shadowBus;
+	*shadow.bus = *state->bus;
+	shadow.bus->memo = NULL;
+	shadow.bus->hle = NULL;
+	shadow.blockCache = NULL;
+	i8080_busMap(&shadow, state->bus->map);
+	memcpy(shadow.memory, state->memory, i8080_MEMORY_SIZE);
+	i8080op_resolveFlags(&shadow);
+	routine->run(&shadow, passes);
+	if (finished)
+		i8080op_executeRET(&shadow);
+
+	int used = 0;
+	while (used < cycles && state->mode != MODE_PANIC) {
+		used += i8080_executeInstruction(state);
+	}
+	i8080op_resolveFlags(state);
+	state->cyclesExecuted += used;
+	state->interruptAccumulator += used;
+
+	bool matches = used == cycles && shadow.a == state->a && shadow.bc == state->bc && shadow.de == state->de && shadow.hl == state->hl
+		&& shadow.sp == state->sp && shadow.pc == state->pc && shadow.f.psw == state->f.psw
+		&& memcmp(shadow.memory, state->memory, i8080_MEMORY_SIZE) == 0;
+	if (!matches) {
+		found->mismatches++;
+		log_error("HLE %s does not match the ROM code over %i passes from cycle %lu", routine->name, passes, state->cyclesExecuted - used);
+	}
+	found->runs++;
+	found->cycles += used;
+	return used;
+}
+
+int i8080_hleRun(i8080State* state, int cyclesUsed, int cycleBudget) {
+	// A traced run logs every instruction and the accurate timing steps through them, a routine run in one go suits neither
+	if (state->traced || state->timing == TIMING_ACCURATE)
+		return 0;
+
+	int index = hleLookup(state);
+	if (index < 0)
+		return 0;
+	const i8080HleRoutine* routine = &i8080_hleRoutines[index];
+	i8080HleFound* found = &state->bus->hle->found[index];
+
+	// Only cycles the per instruction loop would have run without stopping: the last pass ends with the budget and the
+	// accumulator still short
+	int room = cycleBudget - cyclesUsed - 1;
+	int toInterrupt = (int)state->bus->board->interruptPeriod - (int)state->interruptAccumulator - 1;
+	if (toInterrupt < room)
+		room = toInterrupt;
+
+	int left = routine->passesLeft(state);
+	bool finished = (left - 1) * found->passCycles + found->lastCycles <= room;
+	int passes = left;
+	if (!finished) {
+		// Stop at the head, short of the pass that would fall through
+		passes = room / found->passCycles;
+		if (passes > left - 1)
+			passes = left - 1;
+	}
+	if (passes <= 0)
+		return 0;
+	int cycles = finished ? (passes - 1) * found->passCycles + found->lastCycles : passes * found->passCycles;
+
+	if (state->hle == HLE_VERIFY)
+		return hleVerify(state, routine, found, passes, finished, cycles);
+
+	// The native routine goes around the memory hooks, a call being recorded would miss its accesses
+	i8080_memoAbort(state, NULL);
+	i8080op_resolveFlags(state);
+	routine->run(state, passes);
+	if (finished)
+		i8080op_executeRET(state);
+
+	state->cyclesExecuted += cycles;
+	state->interruptAccumulator += cycles;
+	found->runs++;
+	found->cycles += cycles;
+	return cycles;
+}
+
+unsigned long i8080_hleCycles(i8080State* state) {
+	unsigned long cycles = 0;
+	for (int i = 0; state->bus->hle != NULL && i < HLE_ROUTINE_COUNT; i++) {
+		cycles += state->bus->hle->found[i].cycles;
+	}
+	return cycles;
+}
+
+i8080HleFound* i8080_hleFind(i8080State* state, int routine) {
+	return state->bus->hle == NULL ? NULL : &state->bus->hle->found[routine];
+}
+
+void i8080_hleForget(i8080State* state) {
+	i8080Hle* hle = state->bus->hle;
+	if (hle == NULL)
+		return;
+	for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+		hle->found[i].match = HLE_MATCH_UNKNOWN;
+	}
+	memset(hle->codePages, 0, sizeof(hle->codePages));
+}
+
+void i8080_hleFree(i8080State* state) {
+	i8080Hle* hle = state->bus->hle;
+	if (hle == NULL)
+		return;
+	free(hle->shadowMemory);
+	free(hle->shadowBus);
+	free(hle);
+	state->bus->hle = NULL;
+}
@@ -0,0 +1,88 @@
+#pragma once
+/*
+
+i8080_hle.h
+
+High level emulation of ROM routines. A registry of loops known to do nothing but bulk memory work, each found by the
+address of its head and an FNV-1a hash of its code, with a native function doing the same memory and register work. When
+a core reaches the head of one, as many whole passes as fit before the end of the budget and the next interrupt run
+natively and are charged the cycles the ROM code would have taken, so the cores still match cycle for cycle. Each machine
+keeps what it found of the registry with its bus: whether the code at each head hashed right, worked out once and
+forgotten on a write to the pages holding it, the run counters and the shadow state HLE_VERIFY compares on
+
+*/
+
+#include "i8080_util.h"
+
+// Routines in the registry
+#define HLE_ROUTINE_COUNT 3
+
+typedef struct i8080HleRoutine {
+	const char* name;
+	uint16_t entry; // head of the loop, where the native routine takes over
+	uint16_t length; // bytes of code from the head up to and including the RET after the loop, all hashed
+	uint32_t hash; // FNV-1a of those bytes
+	int (*passesLeft)(i8080State* state); // passes until the loop falls through to the RET, from the registers at the head
+	void (*run)(i8080State* state, int passes); // runs passes of the loop, leaving the registers, flags and memory as the ROM code would at the head
+} i8080HleRoutine;
+
+// The registry, the same for every machine
+extern i8080HleRoutine i8080_hleRoutines[HLE_ROUTINE_COUNT];
+
+// Whether the code at the head of a routine is the routine
+enum i8080HleMatch {
+	HLE_MATCH_UNKNOWN, // not hashed since the machine was reset, remapped or had the code written
+	HLE_MATCH_FOUND,
+	HLE_MATCH_NONE
+};
+
+// One routine of the registry as a machine found it
+typedef struct i8080HleFound {
+	uint8_t match; // i8080HleMatch
+	// Worked out from the code with the match
+	int passCycles; // cycles of a pass that jumps back to the head
+	int lastCycles; // cycles of the pass that falls through, with the RET
+	// Counters, never cleared
+	unsigned long runs; // times a core handed the routine to its native function
+	unsigned long cycles; // cycles charged for those runs, or run through the ROM code beside the native routine under HLE_VERIFY
+	unsigned long mismatches; // runs under HLE_VERIFY where the native routine and the ROM code parted
+} i8080HleFound;
+
+// What a machine keeps of the registry, allocated with its bus by the first routine head a core reaches
+typedef struct i8080Hle {
+	i8080HleFound found[HLE_ROUTINE_COUNT];
+	bool codePages[0x100]; // pages of the state memory holding code of a routine hashed, a write to one forgets the matches
+	// Copy of the machine HLE_VERIFY runs the native routines on, allocated by the first run verified
+	uint8_t* shadowMemory;
+	struct i8080Bus* shadowBus;
+} i8080Hle;
+
+// Non zero for the low byte of the pc of each routine head, so the run loops only look further on a possible hit
+extern uint8_t i8080_hleFilter[0x100];
+
+// Fills i8080_hleFilter from the registry
+void i8080_hleInit(void);
+
+// For a pc that may be a routine head. If the code there hashes as a routine of the registry, runs the whole passes that
+// end before the budget runs out and the next interrupt is due, with the RET if the loop finishes, and adds them to
+// cyclesExecuted and interruptAccumulator. Under HLE_VERIFY the ROM code runs the passes instead and the native routine
+// runs beside it on a copy of the state, any difference being logged. Returns the cycles used
+int i8080_hleRun(i8080State* state, int cyclesUsed, int cycleBudget);
+
+// Cycles charged for native routines over the whole registry on the machine
+unsigned long i8080_hleCycles(i8080State* state);
+
+// What the machine found of the routine of the registry, NULL until a core first reached one of their heads
+i8080HleFound* i8080_hleFind(i8080State* state, int routine);
+
+// Forgets whether the code at each head is its routine, keeping the counters. Called by reset8080, i8080_busMap and
+// i8080op_writeMemory for a page marked in codePages
+void i8080_hleForget(i8080State* state);
+
+// Frees what the machine keeps of the registry
+void i8080_hleFree(i8080State* state);
+
+// Hands known ROM routines to their native function, for the run loops of the cores straight after I8080_IDLE_CHECK
+#define I8080_HLE_CHECK(state, cyclesUsed, cycleBudget) \
+	if ((state)->hle != HLE_OFF && i8080_hleFilter[(state)->pc & 0xFF]) \
+		(cyclesUsed) += i8080_hleRun((state), (cyclesUsed), (cycleBudget))
@@ -0,0 +1,1181 @@
+/*
+
+i8080_jit.c
+
+x86-64 translation of cached basic blocks into native code. A block loads the 8080 registers it uses into host registers
+once, runs every instruction on them and stores them back when it leaves. Memory goes through the bus page table inline,
+with pages that have handlers or hold cached code taken out of line to i8080op_readMemory and i8080op_writeMemory. A
+backwards pass over the block finds which flags are read before they are written again, only those are worked out.
+Instructions that touch ports, the interrupt system or the halt state call their handler. Other hosts keep running the
+blocks through the interpreter
+
+*/
+
+#if !defined(_WIN32)
+// mmap's MAP_ANONYMOUS is not ISO C, the C library only declares it with its default feature set, -std=c11 leaves it out
+#define _DEFAULT_SOURCE
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__x86_64__)
+#include <sys/mman.h>
+#endif
+
+#include "i8080_jit.h"
+#include "i8080_bus.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+int jit_hotThreshold = 2;
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+// The BSDs before MAP_ANONYMOUS only had the older name
+#if !defined(_WIN32) && !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+// Longest native code one instruction can produce with its out of line paths, and the most the prologue, exits and
+// epilogue of a block take. Used to check the buffer has room for a block
+#define JIT_MAX_OP_BYTES 400
+#define JIT_BLOCK_BYTES 512
+
+// Byte offsets of the state fields touched by native code
+#define OFFSET(field) ((int32_t)offsetof(i8080State, field))
+#define PSW_OFFSET (OFFSET(f) + (int32_t)offsetof(flagRegister, psw))
+#define ISI_OFFSET (OFFSET(f) + (int32_t)offsetof(flagRegister, isi))
+// Byte offset from the bus of a field of its first page, the page index times the page size is added at run time
+#define PAGE_FIELD(field) ((int32_t)(offsetof(i8080Bus, pages) + offsetof(i8080BusPage, field)))
+
+// Host registers, by their encoding
+enum {
+	X86_RAX, X86_RCX, X86_RDX, X86_RBX, X86_RSP, X86_RBP, X86_RSI, X86_RDI,
+	X86_R8, X86_R9, X86_R10, X86_R11, X86_R12, X86_R13, X86_R14, X86_R15
+};
+// Byte registers without a REX prefix. With one the same encodings name SPL to DIL, which X86_REX_BYTE asks for
+enum { X86_AL, X86_CL, X86_DL, X86_BL, X86_AH, X86_CH, X86_DH, X86_BH };
+#define X86_REX_BYTE 0x10
+#define X86_SIL (X86_RSI | X86_REX_BYTE)
+#define X86_DIL (X86_RDI | X86_REX_BYTE)
+// Byte registers no instruction with a REX prefix can name
+#define X86_HIGH_BYTE(r) (((r) & (X86_REX_BYTE | 0xC)) == 4)
+
+// Condition codes of the jumps and conditional moves
+#define X86_CC_C 0x2
+#define X86_CC_Z 0x4
+#define X86_CC_NZ 0x5
+#define X86_ALWAYS -1
+
+// Where a block keeps the 8080. A is AL and BC, DE and HL are CX, DX and BX zero extended, so every 8 bit register is a
+// byte register the host reaches without a REX prefix
+#define HOST_SP X86_R13 // zero extended
+#define HOST_PSW X86_R12 // zero extended, the flags something still reads are always up to date
+#define HOST_BUS X86_R14
+#define HOST_CACHE X86_RBP
+#define HOST_STATE X86_R15
+// RSI, RDI and R8 to R11 are scratch. R9 holds 8080 addresses, R10 and R11 bytes read from memory
+
+// Host byte register of each 8080 register by the index opcodes name it with, -1 for M
+static const int hostByte[8] = { X86_CH, X86_CL, X86_DH, X86_DL, X86_BH, X86_BL, -1, X86_AL };
+// Host register of each pair by the index opcodes name it with in bits 4 and 5
+static const int hostPair[4] = { X86_RCX, X86_RDX, X86_RBX, HOST_SP };
+
+// What a block keeps in host registers
+#define GROUP_A 0x01
+#define GROUP_BC 0x02
+#define GROUP_DE 0x04
+#define GROUP_HL 0x08
+#define GROUP_SP 0x10
+#define GROUP_PSW 0x20
+#define GROUP_MEMORY 0x40 // the bus and block cache pointers
+
+#if defined(_WIN32)
+// Arguments go in RCX, RDX and R8 with 32 bytes of shadow space above the return address. RSI and RDI are callee saved
+#define ARG0 X86_RCX
+#define ARG1 X86_RDX
+#define ARG2 X86_R8
+#define SHADOW_SPACE 32
+#else
+#define ARG0 X86_RDI
+#define ARG1 X86_RSI
+#define ARG2 X86_RDX
+#define SHADOW_SPACE 0
+#endif
+// Stack slot above the shadow space that out of line reads leave their byte in
+#define TEMP_OFFSET SHADOW_SPACE
+
+// Caller saved registers holding 8080 state or scratch values, which the out of line memory paths keep over their call
+static const int stubSaved[] = { X86_RAX, X86_RCX, X86_RDX, X86_R8, X86_R9, X86_R10, X86_R11 };
+#define STUB_SAVED_COUNT ((int)(sizeof(stubSaved) / sizeof(stubSaved[0])))
+// Keeps the stack 16 byte aligned at the call, with the shadow space below the saved registers
+#define STUB_PAD (SHADOW_SPACE + 8)
+
+// Flag tables, by the LAZY_ rule the ac flag follows
+enum { FLAGS_ADD, FLAGS_SUB, FLAGS_DCR, FLAGS_LOGIC };
+
+// How an instruction leaves the carry
+enum { CARRY_KEEP, CARRY_HOST, CARRY_CLEAR };
+
+// Bit set in the return of jitExecuteOp when the block must stop after the instruction
+#define JIT_STOP 0x10000
+
+typedef struct jitEmitter {
+	uint8_t* code;
+	int pos;
+	int limit; // bytes the block may take, past it the bytes are dropped and the compile fails
+} jitEmitter;
+
+// Out of line code, emitted after the epilogue of the block
+enum {
+	STUB_READ, // reads through i8080op_readMemory, coming back with RSI on the byte
+	STUB_WRITE, // writes through i8080op_writeMemory
+	STUB_EXIT, // leaves the block because it wrote over itself
+	STUB_RETURN // returns after a handler stopped the block, its cycles in AX
+};
+
+typedef struct jitStub {
+	uint8_t kind;
+	int8_t address; // host register holding the 8080 address of a read or write
+	int8_t value; // byte register a write stores, -1 for the immediate
+	uint8_t immediate;
+	int jumps[2]; // rel32 fields of the jumps to the stub, 0 when unused
+	int resume; // where a read or write goes back to
+	uint16_t pc; // pc an exit leaves in the state
+	int cycles; // cycles an exit returns, added to those of the handler for STUB_RETURN
+} jitStub;
+
+#define JIT_MAX_STUBS (BLOCK_MAX_INSTRUCTIONS * 4)
+#define JIT_MAX_EXIT_JUMPS 4
+
+typedef struct jitCompiler {
+	jitEmitter e;
+	i8080JitBuffer* jit;
+	i8080State* state;
+	i8080Block* block;
+	int groups; // GROUP_ bits of what the block keeps in host registers
+	int saved[8]; // callee saved registers the prologue pushes
+	int savedCount;
+	int frame; // bytes the prologue reserves below them
+	jitStub stubs[JIT_MAX_STUBS];
+	int stubCount;
+	int exitJumps[JIT_MAX_EXIT_JUMPS]; // jumps of taken conditional calls and returns to the common exit
+	int exitJumpCount;
+	int exitPos;
+	int epiloguePos;
+} jitCompiler;
+
+static void emit8(jitEmitter* e, uint8_t b) {
+	if (e->pos < e->limit)
+		e->code[e->pos] = b;
+	e->pos++;
+}
+
+static void emit16(jitEmitter* e, uint16_t v) {
+	emit8(e, v & 0xFF);
+	emit8(e, v >> 8);
+}
+
+static void emit32(jitEmitter* e, uint32_t v) {
+	for (int i = 0; i < 4; i++)
+		emit8(e, (v >> (i * 8)) & 0xFF);
+}
+
+static void emit64(jitEmitter* e, uint64_t v) {
+	for (int i = 0; i < 8; i++)
+		emit8(e, (v >> (i * 8)) & 0xFF);
+}
+
+// Operand flags of emitRR and emitRM
+#define OP_W 0x1 // 64 bit operands
+#define OP_16 0x2 // 16 bit operands
+#define OP_BYTE_REG 0x4 // the reg field is a byte register
+#define OP_BYTE_RM 0x8 // the r/m field is a byte register
+
+// Emits the prefixes and opcode. reg, index and rm are register encodings, index -1 when there is none
+static void emitHead(jitEmitter* e, int flags, uint32_t op, int reg, int index, int rm, bool rmIsRegister) {
+	bool byteReg = (flags & OP_BYTE_REG) != 0;
+	bool byteRm = (flags & OP_BYTE_RM) != 0 && rmIsRegister;
+	uint8_t rex = ((flags & OP_W) ? 0x08 : 0) | ((reg & 8) ? 0x04 : 0) | ((index >= 0 && (index & 8)) ? 0x02 : 0) | ((rm & 8) ? 0x01 : 0);
+	bool forced = (byteReg && (reg & X86_REX_BYTE)) || (byteRm && (rm & X86_REX_BYTE));
+
+	if (flags & OP_16)
+		emit8(e, 0x66);
+	if (rex != 0 || forced) {
+		if ((byteReg && X86_HIGH_BYTE(reg)) || (byteRm && X86_HIGH_BYTE(rm))) {
+			log_fatal("The JIT tried to encode a high byte register with a REX prefix");
+			exit(-1);
+		}
+		emit8(e, 0x40 | rex);
+	}
+	if (op > 0xFF)
+		emit8(e, op >> 8);
+	emit8(e, op & 0xFF);
+}
+
+// op reg, rm with both registers
+static void emitRR(jitEmitter* e, int flags, uint32_t op, int reg, int rm) {
+	emitHead(e, flags, op, reg, -1, rm, true);
+	emit8(e, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+// op reg, [base + index + disp]
+static void emitRM(jitEmitter* e, int flags, uint32_t op, int reg, int base, int index, int32_t disp) {
+	emitHead(e, flags, op, reg, index, base, false);
+	bool short8 = disp >= -128 && disp <= 127;
+	emit8(e, (short8 ? 0x44 : 0x84) | ((reg & 7) << 3));
+	emit8(e, ((index >= 0 ? index & 7 : 4) << 3) | (base & 7));
+	if (short8)
+		emit8(e, (uint8_t)disp);
+	else
+		emit32(e, (uint32_t)disp);
+}
+
+// mov r32, imm32, clearing the top of the register
+static void emitMovImm(jitEmitter* e, int reg, uint32_t v) {
+	if (reg & 8)
+		emit8(e, 0x41);
+	emit8(e, 0xB8 | (reg & 7));
+	emit32(e, v);
+}
+
+// mov r64, imm64
+static void emitMovImm64(jitEmitter* e, int reg, uint64_t v) {
+	emit8(e, 0x48 | ((reg & 8) ? 0x01 : 0));
+	emit8(e, 0xB8 | (reg & 7));
+	emit64(e, v);
+}
+
+static void emitPush(jitEmitter* e, int reg) {
+	if (reg & 8)
+		emit8(e, 0x41);
+	emit8(e, 0x50 | (reg & 7));
+}
+
+static void emitPop(jitEmitter* e, int reg) {
+	if (reg & 8)
+		emit8(e, 0x41);
+	emit8(e, 0x58 | (reg & 7));
+}
+
+// add or sub rsp, imm32
+static void emitStack(jitEmitter* e, int bytes) {
+	emitRR(e, OP_W, 0x81, bytes < 0 ? 5 : 0, X86_RSP);
+	emit32(e, (uint32_t)(bytes < 0 ? -bytes : bytes));
+}
+
+// Calls the function through RAX
+static void emitCall(jitEmitter* e, uint64_t function) {
+	emitMovImm64(e, X86_RAX, function);
+	emitRR(e, 0, 0xFF, 2, X86_RAX);
+}
+
+// jmp rel32, or jcc rel32 for a condition code. Returns the position of the rel32 field for emitPatch
+static int emitJump(jitEmitter* e, int cc) {
+	if (cc == X86_ALWAYS) {
+		emit8(e, 0xE9);
+	}
+	else {
+		emit8(e, 0x0F);
+		emit8(e, 0x80 | cc);
+	}
+	int field = e->pos;
+	emit32(e, 0);
+	return field;
+}
+
+// Points the rel32 field at the target
+static void emitPatch(jitEmitter* e, int field, int target) {
+	if (field + 4 > e->limit)
+		return;
+	uint32_t rel = (uint32_t)(target - (field + 4));
+	for (int i = 0; i < 4; i++)
+		e->code[field + i] = (rel >> (i * 8)) & 0xFF;
+}
+
+static jitStub* addStub(jitCompiler* c, uint8_t kind) {
+	jitStub* stub = &c->stubs[c->stubCount++];
+	memset(stub, 0, sizeof(jitStub));
+	stub->kind = kind;
+	return stub;
+}
+
+// Runs one instruction of a block through its handler. Returns the cycles it took, with JIT_STOP set if the block must stop
+static int jitExecuteOp(i8080State* state, const i8080MicroOp* op, const i8080Block* block) {
+	state->f.rx = false;
+	state->f.tx = false;
+
+	uint8_t result = op->handler(state, op->opcode, op->byte1, op->byte2);
+	if (!(result & OPRESULT_JUMPED))
+		state->pc += op->length;
+	int cycles = (result & OPRESULT_FAILED) ? op->failedCycles : op->cycles;
+
+	if (state->mode == MODE_HLT || state->mode == MODE_PANIC || !block->valid)
+		return cycles | JIT_STOP;
+	return cycles;
+}
+
+// Returns if the instruction is translated, the rest call their handler
+static bool jitInline(uint8_t opcode) {
+	if (i8080_opcodeInfo[opcode].kind & (OPK_IO | OPK_INTERRUPT | OPK_HALT | OPK_UNDOCUMENTED))
+		return false;
+#ifdef CPUDIAG
+	// The CP/M console calls are caught in i8080op_executeCALL
+	if (i8080_opcodeInfo[opcode].kind & OPK_CALL)
+		return false;
+#endif
+	return opcode != DAA && opcode != XTHL;
+}
+
+// Returns the GROUP_ bits of what a translated instruction uses
+static int jitGroups(uint8_t opcode) {
+	const i8080OpcodeInfo* info = &i8080_opcodeInfo[opcode];
+	int groups = 0;
+
+	if (info->flagsRead | info->flagsWritten)
+		groups |= GROUP_PSW;
+	if (info->kind & (OPK_READ | OPK_WRITE))
+		groups |= GROUP_MEMORY;
+	if (info->kind & OPK_STACK)
+		groups |= GROUP_SP;
+
+	static const int byteGroups[8] = { GROUP_BC, GROUP_BC, GROUP_DE, GROUP_DE, GROUP_HL, GROUP_HL, GROUP_HL, GROUP_A };
+	static const int pairGroups[4] = { GROUP_BC, GROUP_DE, GROUP_HL, GROUP_SP };
+
+	if (opcode >= 0x40 && opcode < 0x80)
+		return groups | byteGroups[(opcode >> 3) & 7] | byteGroups[opcode & 7];
+	if (opcode >= 0x80 && opcode < 0xC0)
+		return groups | GROUP_A | byteGroups[opcode & 7];
+
+	switch (opcode & 0xC7) {
+	case 0x04: case 0x05: case 0x06:
+		return groups | byteGroups[(opcode >> 3) & 7];
+	case 0x01: case 0x03:
+		return groups | pairGroups[(opcode >> 4) & 3] | ((opcode & 0x0F) == 0x09 ? GROUP_HL : 0);
+	case 0x02:
+		return groups | GROUP_A | ((opcode & 0x20) ? 0 : pairGroups[(opcode >> 4) & 3]) | (opcode == SHLD || opcode == LHLD ? GROUP_HL : 0);
+	case 0x07:
+		return groups | GROUP_A;
+	case 0xC6:
+		return groups | GROUP_A;
+	case 0xC1: case 0xC5:
+		if (!(opcode & 0x08))
+			return groups | (((opcode >> 4) & 3) == 3 ? GROUP_A | GROUP_PSW : pairGroups[(opcode >> 4) & 3]);
+		break;
+	}
+
+	switch (opcode) {
+	case XCHG: return groups | GROUP_DE | GROUP_HL;
+	case SPHL: return groups | GROUP_SP | GROUP_HL;
+	case PCHL: return groups | GROUP_HL;
+	}
+	return groups;
+}
+
+// Stores the registers the block keeps on the host back into the state
+static void emitWriteBack(jitCompiler* c) {
+	jitEmitter* e = &c->e;
+	if (c->groups & GROUP_A)
+		emitRM(e, OP_BYTE_REG, 0x88, X86_AL, HOST_STATE, -1, OFFSET(a));
+	if (c->groups & GROUP_BC)
+		emitRM(e, OP_16, 0x89, X86_RCX, HOST_STATE, -1, OFFSET(bc));
+	if (c->groups & GROUP_DE)
+		emitRM(e, OP_16, 0x89, X86_RDX, HOST_STATE, -1, OFFSET(de));
+	if (c->groups & GROUP_HL)
+		emitRM(e, OP_16, 0x89, X86_RBX, HOST_STATE, -1, OFFSET(hl));
+	if (c->groups & GROUP_SP)
+		emitRM(e, OP_16, 0x89, HOST_SP, HOST_STATE, -1, OFFSET(sp));
+	if (c->groups & GROUP_PSW) {
+		emitRM(e, OP_BYTE_REG, 0x88, HOST_PSW, HOST_STATE, -1, PSW_OFFSET);
+		emitRM(e, 0, 0xC6, 0, HOST_STATE, -1, OFFSET(lazyFlags));
+		emit8(e, LAZY_NONE);
+	}
+}
+
+// Loads the registers the block keeps on the host from the state, building any flags left deferred first
+static void emitLoad(jitCompiler* c) {
+	jitEmitter* e = &c->e;
+	if (c->groups & GROUP_PSW) {
+		emitRM(e, 0, 0x80, 7, HOST_STATE, -1, OFFSET(lazyFlags)); // cmp byte [state + lazyFlags], LAZY_NONE
+		emit8(e, LAZY_NONE);
+		int resolved = emitJump(e, X86_CC_Z);
+		emitRR(e, OP_W, 0x89, HOST_STATE, ARG0);
+		emitCall(e, (uint64_t)(size_t)i8080op_resolveFlags);
+		emitPatch(e, resolved, e->pos);
+		emitRM(e, 0, 0x0FB6, HOST_PSW, HOST_STATE, -1, PSW_OFFSET);
+	}
+	if (c->groups & GROUP_A)
+		emitRM(e, 0, 0x0FB6, X86_RAX, HOST_STATE, -1, OFFSET(a));
+	if (c->groups & GROUP_BC)
+		emitRM(e, 0, 0x0FB7, X86_RCX, HOST_STATE, -1, OFFSET(bc));
+	if (c->groups & GROUP_DE)
+		emitRM(e, 0, 0x0FB7, X86_RDX, HOST_STATE, -1, OFFSET(de));
+	if (c->groups & GROUP_HL)
+		emitRM(e, 0, 0x0FB7, X86_RBX, HOST_STATE, -1, OFFSET(hl));
+	if (c->groups & GROUP_SP)
+		emitRM(e, 0, 0x0FB7, HOST_SP, HOST_STATE, -1, OFFSET(sp));
+}
+
+// Leaves the page index of the 8080 address in the host register times the size of a page in EDI
+static void emitPageIndex(jitEmitter* e, int address) {
+	emitRR(e, 0, 0x89, address, X86_RDI); // mov edi, address
+	emitRR(e, 0, 0xC1, 5, X86_RDI); // shr edi, 8
+	emit8(e, 8);
+	emitRR(e, 0, 0x69, X86_RDI, X86_RDI); // imul edi, edi, sizeof(i8080BusPage)
+	emit32(e, (uint32_t)sizeof(i8080BusPage));
+}
+
+// Adds the low byte of the 8080 address in the host register to RSI
+static void emitPageOffset(jitEmitter* e, int address) {
+	emitRR(e, OP_BYTE_RM, 0x0FB6, X86_RDI, address);
+	emitRR(e, OP_W, 0x01, X86_RDI, X86_RSI);
+}
+
+// Points RSI at the byte the bus reads at the 8080 address in the host register. Pages with a read handler go out of line
+// and come back with RSI on the byte it returned
+static void emitReadPointer(jitCompiler* c, int address) {
+	jitEmitter* e = &c->e;
+	jitStub* stub = addStub(c, STUB_READ);
+	stub->address = address;
+
+	emitPageIndex(e, address);
+	emitRM(e, OP_W, 0x83, 7, HOST_BUS, X86_RDI, PAGE_FIELD(onRead)); // cmp qword [page + onRead], 0
+	emit8(e, 0);
+	stub->jumps[0] = emitJump(e, X86_CC_NZ);
+	emitRM(e, OP_W, 0x8B, X86_RSI, HOST_BUS, X86_RDI, PAGE_FIELD(read));
+	emitPageOffset(e, address);
+	stub->resume = e->pos;
+}
+
+// Writes the byte register, or the immediate when value is -1, to the 8080 address in the host register. Pages with a write
+// handler or holding cached code go out of line
+static void emitWrite(jitCompiler* c, int address, int value, uint8_t immediate) {
+	jitEmitter* e = &c->e;
+	jitStub* stub = addStub(c, STUB_WRITE);
+	stub->address = address;
+	stub->value = value;
+	stub->immediate = immediate;
+
+	emitPageIndex(e, address);
+	emitRM(e, OP_W, 0x8B, X86_RSI, HOST_BUS, X86_RDI, PAGE_FIELD(write));
+	emitRR(e, OP_W, 0x85, X86_RSI, X86_RSI); // test rsi, rsi
+	stub->jumps[0] = emitJump(e, X86_CC_Z);
+	emitRM(e, 0, 0x0FB7, X86_RDI, HOST_BUS, X86_RDI, PAGE_FIELD(offset)); // the physical page, from the offset of the page
+	emitRR(e, 0, 0xC1, 5, X86_RDI);
+	emit8(e, 8);
+	emitRM(e, 0, 0x80, 7, HOST_CACHE, X86_RDI, (int32_t)offsetof(i8080BlockCache, codePages)); // cmp byte [codePages + page], 0
+	emit8(e, 0);
+	stub->jumps[1] = emitJump(e, X86_CC_NZ);
+	emitPageOffset(e, address);
+	if (value < 0) {
+		emitRM(e, 0, 0xC6, 0, X86_RSI, -1, 0);
+		emit8(e, immediate);
+	}
+	else {
+		emitRM(e, OP_BYTE_REG, 0x88, value, X86_RSI, -1, 0);
+	}
+	stub->resume = e->pos;
+}
+
+// Reads the byte at the 8080 address in the host register into the byte register, or zero extended into the whole
+// register when widen is set
+static void emitRead(jitCompiler* c, int address, int dst, bool widen) {
+	emitReadPointer(c, address);
+	if (widen)
+		emitRM(&c->e, 0, 0x0FB6, dst, X86_RSI, -1, 0);
+	else
+		emitRM(&c->e, OP_BYTE_REG, 0x8A, dst, X86_RSI, -1, 0);
+}
+
+// Leaves the 16 bit sum of the pair and the displacement in R9D
+static void emitAddress(jitEmitter* e, int pair, int displacement) {
+	emitRM(e, 0, 0x8D, X86_R9, pair, -1, displacement); // lea r9d, [pair + displacement]
+	emitRR(e, 0, 0x0FB7, X86_R9, X86_R9); // movzx r9d, r9w
+}
+
+// Pushes the two byte registers, or the 16 bit immediate when high is -1
+static void emitPushStack(jitCompiler* c, int high, int low, uint16_t v) {
+	emitAddress(&c->e, HOST_SP, -1);
+	emitWrite(c, X86_R9, high, v >> 8);
+	emitAddress(&c->e, HOST_SP, -2);
+	emitWrite(c, X86_R9, high < 0 ? -1 : low, v & 0xFF);
+	emitRR(&c->e, OP_16, 0x81, 5, HOST_SP); // sub r13w, 2
+	emit16(&c->e, 2);
+}
+
+// Pops the pc of a return into EDI and ends the interrupt, as i8080op_executeRET does
+static void emitReturn(jitCompiler* c) {
+	jitEmitter* e = &c->e;
+	emitRead(c, HOST_SP, X86_R10, true);
+	emitAddress(e, HOST_SP, 1);
+	emitRead(c, X86_R9, X86_R11, true);
+	emitRR(e, OP_16, 0x81, 0, HOST_SP); // add r13w, 2
+	emit16(e, 2);
+	emitRM(e, 0, 0xC7, 0, HOST_STATE, -1, ISI_OFFSET); // mov dword [state + isi], 0
+	emit32(e, 0);
+	emitRR(e, 0, 0xC1, 4, X86_R11); // shl r11d, 8
+	emit8(e, 8);
+	emitRR(e, 0, 0x09, X86_R10, X86_R11); // or r11d, r10d
+	emitRR(e, 0, 0x89, X86_R11, X86_RDI); // mov edi, r11d
+}
+
+// Updates the flags that are written and still read from the result in the byte register, by the flag table. CARRY_HOST
+// takes the carry from the host carry flag, which nothing between the instruction and this may change. anaAc or's in the
+// ac flag of an ANA left in R9B
+static void emitFlags(jitCompiler* c, int need, int table, int result, int carry, bool anaAc) {
+	jitEmitter* e = &c->e;
+	bool szap = (need & OPF_SZAP) != 0;
+	bool setCarry = (need & OPF_C) != 0 && carry != CARRY_KEEP;
+	if (!szap && !setCarry)
+		return;
+
+	if (setCarry && carry == CARRY_HOST)
+		emitRR(e, OP_BYTE_RM, 0x0F92, 0, X86_R8); // setc r8b
+	if (szap) {
+		emitRR(e, OP_BYTE_RM, 0x0FB6, X86_RSI, result);
+		emitMovImm64(e, X86_RDI, (uint64_t)(size_t)c->jit->flagTables[table]);
+	}
+	uint8_t clear = (szap ? OPF_SZAP : 0) | (setCarry ? OPF_C : 0);
+	emitRR(e, 0, 0x81, 4, HOST_PSW); // and r12d, ~clear
+	emit32(e, (uint8_t)~clear);
+	if (szap)
+		emitRM(e, OP_BYTE_REG, 0x0A, HOST_PSW, X86_RDI, X86_RSI, 0); // or r12b, [table + result]
+	if (szap && anaAc)
+		emitRR(e, OP_BYTE_REG | OP_BYTE_RM, 0x08, X86_R9, HOST_PSW);
+	if (setCarry && carry == CARRY_HOST)
+		emitRR(e, OP_BYTE_REG | OP_BYTE_RM, 0x08, X86_R8, HOST_PSW);
+}
+
+// Copies the 8080 carry into the host carry flag
+static void emitCarryIn(jitEmitter* e) {
+	emitRR(e, 0, 0x0FBA, 4, HOST_PSW); // bt r12d, 0
+	emit8(e, 0);
+}
+
+// Zero extends the source byte register, or the immediate when source is -1, into the host register
+static void emitSource(jitEmitter* e, int reg, int source, uint8_t immediate) {
+	if (source < 0)
+		emitMovImm(e, reg, immediate);
+	else
+		emitRR(e, OP_BYTE_RM, 0x0FB6, reg, source);
+}
+
+// One of ADD, ADC, SUB, SBB, ANA, XRA, ORA and CMP, by bits 3 to 5 of the opcode, on A and the source byte register or the
+// immediate when source is -1
+static void emitAlu(jitCompiler* c, int operation, int source, uint8_t immediate, int need, bool immediateForm) {
+	jitEmitter* e = &c->e;
+	// Host opcodes of the register form and the /digit of the immediate form, in 8080 order
+	static const uint8_t registerOps[8] = { 0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38 };
+	static const uint8_t immediateDigits[8] = { 0, 2, 5, 3, 4, 6, 1, 7 };
+
+	switch (operation) {
+	case 1: // ADC: the operand and the carry are added first, the carry comes from adding that to A
+		emitSource(e, X86_RSI, source, immediate);
+		emitCarryIn(e);
+		emitRR(e, 0, 0x83, 2, X86_RSI); // adc esi, 0
+		emit8(e, 0);
+		emitRR(e, OP_BYTE_REG | OP_BYTE_RM, 0x00, X86_SIL, X86_AL);
+		emitFlags(c, need, FLAGS_ADD, X86_AL, CARRY_HOST, false);
+		return;
+	case 3: // SBB: the carry is taken from A first, the borrow comes from taking the operand from that
+		emitSource(e, X86_RSI, source, immediate);
+		emitCarryIn(e);
+		emitRR(e, OP_BYTE_RM, 0x80, 3, X86_AL); // sbb al, 0
+		emit8(e, 0);
+		emitRR(e, OP_BYTE_REG | OP_BYTE_RM, 0x28, X86_SIL, X86_AL);
+		emitFlags(c, need, FLAGS_SUB, X86_AL, CARRY_HOST, false);
+		return;
+	case 4: // ANA: ac is bit 3 of A or the operand
+		emitSource(e, X86_RDI, source, immediate);
+		if (need & OPF_SZAP) {
+			emitRR(e, OP_BYTE_RM, 0x0FB6, X86_R9, X86_AL);
+			emitRR(e, 0, 0x09, X86_RDI, X86_R9);
+			emitRR(e, 0, 0x83, 4, X86_R9); // and r9d, 8
+			emit8(e, 8);
+			emitRR(e, 0, 0xD1, 4, X86_R9); // shl r9d, 1
+		}
+		emitRR(e, OP_BYTE_REG | OP_BYTE_RM, 0x20, X86_DIL, X86_AL);
+		emitFlags(c, need, FLAGS_LOGIC, X86_AL, CARRY_CLEAR, true);
+		return;
+	case 7: // CMP: the flags of A minus the operand with ac clear
+		if (need == 0)
+			return;
+		emitRR(e, OP_BYTE_RM, 0x0FB6, X86_RSI, X86_AL);
+		emitSource(e, X86_RDI, source, immediate);
+		emitRR(e, 0, 0x29, X86_RDI, X86_RSI); // sub esi, edi
+		emitFlags(c, need, FLAGS_LOGIC, X86_SIL, CARRY_HOST, false);
+		return;
+	}
+
+	if (source < 0) {
+		emitRR(e, OP_BYTE_RM, 0x80, immediateDigits[operation], X86_AL);
+		emit8(e, immediate);
+	}
+	else {
+		emitRR(e, OP_BYTE_REG | OP_BYTE_RM, registerOps[operation], source, X86_AL);
+	}
+	if (operation == 0)
+		emitFlags(c, need, FLAGS_ADD, X86_AL, CARRY_HOST, false);
+	else if (operation == 2)
+		emitFlags(c, need, FLAGS_SUB, X86_AL, CARRY_HOST, false);
+	else // XRI and ORI clear the carry, XRA and ORA keep it
+		emitFlags(c, need, FLAGS_LOGIC, X86_AL, immediateForm ? CARRY_CLEAR : CARRY_KEEP, false);
+}
+
+// Flag each pair of conditions tests, by bits 4 and 5 of the opcode
+static const uint8_t conditionFlags[4] = { FLAG_Z, FLAG_C, FLAG_P, FLAG_S };
+
+// Emits the test of a conditional call or return. Returns the rel32 field of the jump taken when the condition fails
+static int emitCondition(jitEmitter* e, uint8_t opcode) {
+	int cc = (opcode >> 3) & 7;
+	emitRR(e, OP_BYTE_RM, 0xF6, 0, HOST_PSW); // test r12b, flag
+	emit8(e, conditionFlags[cc >> 1]);
+	// Odd conditions want the flag set, even ones clear
+	return emitJump(e, (cc & 1) ? X86_CC_Z : X86_CC_NZ);
+}
+
+// Emits the instruction. need holds the flags it writes that are still read. Returns true if it left the pc in EDI and
+// its cycles in ESI for the exit
+static bool emitOp(jitCompiler* c, const i8080MicroOp* op, uint16_t pc, int cyclesBefore, int need) {
+	jitEmitter* e = &c->e;
+	uint8_t opcode = op->opcode;
+	uint16_t next = pc + op->length;
+	uint16_t word = ((uint16_t)op->byte2 << 8) | op->byte1;
+	int cycles = cyclesBefore + op->cycles;
+	int dst = hostByte[(opcode >> 3) & 7];
+	int src = hostByte[opcode & 7];
+	int pair = hostPair[(opcode >> 4) & 3];
+
+	// MOV
+	if (opcode >= 0x40 && opcode < 0x80) {
+		if (dst >= 0 && src >= 0) {
+			if (dst != src)
+				emitRR(e, OP_BYTE_REG | OP_BYTE_RM, 0x88, src, dst);
+		}
+		else if (src < 0) {
+			emitRead(c, X86_RBX, dst, false);
+		}
+		else {
+			emitWrite(c, X86_RBX, src, 0);
+		}
+		return false;
+	}
+
+	// ALU on a register or M
+	if (opcode >= 0x80 && opcode < 0xC0) {
+		if (src < 0) {
+			emitRead(c, X86_RBX, X86_R10, true);
+			src = X86_R10;
+		}
+		emitAlu(c, (opcode >> 3) & 7, src, 0, need, false);
+		return false;
+	}
+
+	switch (opcode & 0xC7) {
+	case 0x04: // INR
+	case 0x05: // DCR
+		if (dst >= 0) {
+			emitRR(e, OP_BYTE_RM, 0xFE, opcode & 1, dst);
+			emitFlags(c, need, (opcode & 1) ? FLAGS_DCR : FLAGS_ADD, dst, CARRY_KEEP, false);
+		}
+		else {
+			// INR M and DCR M both build ac the way ADD does
+			emitRead(c, X86_RBX, X86_R10, true);
+			emitRR(e, OP_BYTE_RM, 0xFE, opcode & 1, X86_R10);
+			emitFlags(c, need, FLAGS_ADD, X86_R10, CARRY_KEEP, false);
+			emitWrite(c, X86_RBX, X86_R10, 0);
+		}
+		return false;
+	case 0x06: // MVI
+		if (dst >= 0) {
+			emitRR(e, OP_BYTE_RM, 0xC6, 0, dst);
+			emit8(e, op->byte1);
+		}
+		else {
+			emitWrite(c, X86_RBX, -1, op->byte1);
+		}
+		return false;
+	case 0xC6: // ADI, ACI, SUI, SBI, ANI, XRI, ORI, CPI
+		emitAlu(c, (opcode >> 3) & 7, -1, op->byte1, need, true);
+		return false;
+	case 0xC7: // RST
+		emitPushStack(c, -1, -1, next);
+		emitMovImm(e, X86_RDI, opcode & 0x38);
+		emitMovImm(e, X86_RSI, cycles);
+		return true;
+	case 0xC2: { // Jcc
+		int cc = (opcode >> 3) & 7;
+		emitMovImm(e, X86_RDI, next);
+		emitMovImm(e, X86_R8, word);
+		emitRR(e, OP_BYTE_RM, 0xF6, 0, HOST_PSW);
+		emit8(e, conditionFlags[cc >> 1]);
+		emitRR(e, 0, 0x0F40 | ((cc & 1) ? X86_CC_NZ : X86_CC_Z), X86_RDI, X86_R8); // cmov edi, r8d
+		emitMovImm(e, X86_RSI, cycles);
+		return true;
+	}
+	case 0xC4: { // Ccc
+		int notTaken = emitCondition(e, opcode);
+		emitPushStack(c, -1, -1, next);
+		emitMovImm(e, X86_RDI, word);
+		emitMovImm(e, X86_RSI, cycles);
+		c->exitJumps[c->exitJumpCount++] = emitJump(e, X86_ALWAYS);
+		emitPatch(e, notTaken, e->pos);
+		emitMovImm(e, X86_RDI, next);
+		emitMovImm(e, X86_RSI, cyclesBefore + op->failedCycles);
+		return true;
+	}
+	case 0xC0: { // Rcc
+		int notTaken = emitCondition(e, opcode);
+		emitReturn(c);
+		emitMovImm(e, X86_RSI, cycles);
+		c->exitJumps[c->exitJumpCount++] = emitJump(e, X86_ALWAYS);
+		emitPatch(e, notTaken, e->pos);
+		emitMovImm(e, X86_RDI, next);
+		emitMovImm(e, X86_RSI, cyclesBefore + op->failedCycles);
+		return true;
+	}
+	}
+
+	switch (opcode) {
+	case NOP:
+		return false;
+	case LXI_B: case LXI_D: case LXI_H: case LXI_SP:
+		emitMovImm(e, pair, word);
+		return false;
+	case INX_B: case INX_D: case INX_H: case INX_SP:
+	case DCX_B: case DCX_D: case DCX_H: case DCX_SP:
+		emitRR(e, OP_16, 0xFF, (opcode & 0x08) ? 1 : 0, pair);
+		return false;
+	case DAD_B: case DAD_D: case DAD_H: case DAD_SP:
+		emitRR(e, OP_16, 0x01, pair, X86_RBX);
+		emitFlags(c, need, 0, 0, CARRY_HOST, false);
+		return false;
+	case STAX_B: case STAX_D:
+		emitWrite(c, pair, X86_AL, 0);
+		return false;
+	case LDAX_B: case LDAX_D:
+		emitRead(c, pair, X86_AL, false);
+		return false;
+	case SHLD:
+		emitMovImm(e, X86_R9, word);
+		emitWrite(c, X86_R9, X86_BL, 0);
+		emitMovImm(e, X86_R9, (uint16_t)(word + 1));
+		emitWrite(c, X86_R9, X86_BH, 0);
+		return false;
+	case LHLD:
+		emitMovImm(e, X86_R9, word);
+		emitRead(c, X86_R9, X86_BL, false);
+		emitMovImm(e, X86_R9, (uint16_t)(word + 1));
+		emitRead(c, X86_R9, X86_BH, false);
+		return false;
+	case STA:
+		emitMovImm(e, X86_R9, word);
+		emitWrite(c, X86_R9, X86_AL, 0);
+		return false;
+	case LDA:
+		emitMovImm(e, X86_R9, word);
+		emitRead(c, X86_R9, X86_AL, false);
+		return false;
+	case RLC: case RRC: case RAL: case RAR:
+		// rol, ror, rcl and sar: RAR keeps bit 7
+		if (opcode == RAL)
+			emitCarryIn(e);
+		emitRR(e, OP_BYTE_RM, 0xD0, opcode == RLC ? 0 : opcode == RRC ? 1 : opcode == RAL ? 2 : 7, X86_AL);
+		emitFlags(c, need, 0, 0, CARRY_HOST, false);
+		return false;
+	case CMA:
+		emitRR(e, OP_BYTE_RM, 0xF6, 2, X86_AL);
+		return false;
+	case STC:
+	case CMC:
+		if (need & OPF_C) {
+			emitRR(e, 0, 0x83, opcode == STC ? 1 : 6, HOST_PSW); // or or xor r12d, FLAG_C
+			emit8(e, FLAG_C);
+		}
+		return false;
+	case XCHG:
+		emitRR(e, 0, 0x87, X86_RDX, X86_RBX);
+		return false;
+	case SPHL:
+		emitRR(e, 0, 0x89, X86_RBX, HOST_SP);
+		return false;
+	case PCHL:
+		emitRR(e, 0, 0x89, X86_RBX, X86_RDI);
+		emitMovImm(e, X86_RSI, cycles);
+		return true;
+	case PUSH_B: case PUSH_D: case PUSH_H:
+		emitPushStack(c, dst, hostByte[((opcode >> 3) & 7) + 1], 0);
+		return false;
+	case PUSH_PSW:
+		emitPushStack(c, X86_AL, HOST_PSW, 0);
+		return false;
+	case POP_B: case POP_D: case POP_H:
+	case POP_PSW: {
+		int high = opcode == POP_PSW ? X86_AL : hostByte[(opcode >> 3) & 7];
+		int low = opcode == POP_PSW ? HOST_PSW : hostByte[((opcode >> 3) & 7) + 1];
+		emitRead(c, HOST_SP, low, opcode == POP_PSW);
+		if (opcode == POP_PSW) {
+			emitRR(e, 0, 0x83, 4, HOST_PSW); // and r12d, FLAG_MASK
+			emit8(e, FLAG_MASK);
+			emitRR(e, 0, 0x83, 1, HOST_PSW); // or r12d, FLAG_ONE
+			emit8(e, FLAG_ONE);
+		}
+		emitAddress(e, HOST_SP, 1);
+		emitRead(c, X86_R9, high, false);
+		emitRR(e, OP_16, 0x81, 0, HOST_SP);
+		emit16(e, 2);
+		return false;
+	}
+	case JMP:
+		emitMovImm(e, X86_RDI, word);
+		emitMovImm(e, X86_RSI, cycles);
+		return true;
+	case CALL:
+		emitPushStack(c, -1, -1, next);
+		emitMovImm(e, X86_RDI, word);
+		emitMovImm(e, X86_RSI, cycles);
+		return true;
+	case RET:
+		emitReturn(c);
+		emitMovImm(e, X86_RSI, cycles);
+		return true;
+	}
+
+	log_fatal("The JIT has no translation for opcode %02X", opcode);
+	exit(-1);
+}
+
+// Runs the instruction through its handler, with the registers written back around the call. If the handler stops the
+// block it returns with the cycles so far and its own
+static void emitHandler(jitCompiler* c, const i8080MicroOp* op, uint16_t pc, int cyclesBefore, bool last) {
+	jitEmitter* e = &c->e;
+	emitWriteBack(c);
+	emitRM(e, OP_16, 0xC7, 0, HOST_STATE, -1, OFFSET(pc));
+	emit16(e, pc);
+	emitRR(e, OP_W, 0x89, HOST_STATE, ARG0);
+	emitMovImm64(e, ARG1, (uint64_t)(size_t)op);
+	emitMovImm64(e, ARG2, (uint64_t)(size_t)c->block);
+	emitCall(e, (uint64_t)(size_t)jitExecuteOp);
+
+	jitStub* stub = addStub(c, STUB_RETURN);
+	stub->cycles = cyclesBefore;
+	if (last) {
+		stub->jumps[0] = emitJump(e, X86_ALWAYS);
+		return;
+	}
+	emit8(e, 0xA9); // test eax, JIT_STOP
+	emit32(e, JIT_STOP);
+	stub->jumps[0] = emitJump(e, X86_CC_NZ);
+	emitLoad(c);
+}
+
+// Finds where the rx and tx bits of the flag register are, to clear them on the way out as the interpreter leaves them
+static void jitRxTx(int32_t* offset, uint8_t* mask) {
+	flagRegister probe;
+	memset(&probe, 0, sizeof(probe));
+	probe.rx = 1;
+	probe.tx = 1;
+	const uint8_t* bytes = (const uint8_t*)&probe;
+	for (int i = 0; i < (int)sizeof(probe); i++) {
+		if (bytes[i] != 0) {
+			*offset = OFFSET(f) + i;
+			*mask = bytes[i];
+			return;
+		}
+	}
+}
+
+static i8080JitBuffer* jitBuffer(i8080State* state) {
+	i8080BlockCache* cache = state->blockCache;
+	if (cache->jit != NULL)
+		return cache->jit;
+
+	i8080JitBuffer* jit = malloc(sizeof(i8080JitBuffer));
+	if (jit == NULL) {
+		log_fatal("Failed to allocate the JIT buffer descriptor");
+		exit(-1);
+	}
+	jit->size = JIT_BUFFER_SIZE;
+	jit->used = 0;
+#if defined(_WIN32)
+	jit->code = VirtualAlloc(NULL, JIT_BUFFER_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+	jit->code = mmap(NULL, JIT_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (jit->code == MAP_FAILED)
+		jit->code = NULL;
+#endif
+	if (jit->code == NULL)
+		log_error("Failed to allocate executable memory, the JIT core will interpret every block");
+	jit->writable = true;
+
+	// The ac rules of i8080op_resolveFlags over the s, z and p bits of every result
+	for (int r = 0; r < 0x100; r++) {
+		uint8_t zsp = i8080_zspTable[r];
+		jit->flagTables[FLAGS_ADD][r] = zsp | ((r & 0xF) == 0 ? FLAG_AC : 0);
+		jit->flagTables[FLAGS_SUB][r] = zsp | ((r & 0xF) != 0 ? FLAG_AC : 0);
+		jit->flagTables[FLAGS_DCR][r] = zsp | ((r & 0xF) != 0xF ? FLAG_AC : 0);
+		jit->flagTables[FLAGS_LOGIC][r] = zsp;
+	}
+
+	cache->jit = jit;
+	return jit;
+}
+
+static void jitRelease(i8080JitBuffer* jit) {
+	if (jit->code == NULL)
+		return;
+#if defined(_WIN32)
+	VirtualFree(jit->code, 0, MEM_RELEASE);
+#else
+	munmap(jit->code, jit->size);
+#endif
+	jit->code = NULL;
+}
+
+// Switches the buffer between writable, while blocks are emitted into it, and executable, never both at once. If the
+// host refuses, the native code is dropped with the buffer and every block is interpreted from then on
+static bool jitProtect(i8080State* state, i8080JitBuffer* jit, bool writable) {
+	if (jit->writable == writable)
+		return true;
+#if defined(_WIN32)
+	DWORD previous;
+	bool changed = VirtualProtect(jit->code, jit->size, writable ? PAGE_READWRITE : PAGE_EXECUTE_READ, &previous) != 0;
+#else
+	bool changed = mprotect(jit->code, jit->size, writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC) == 0;
+#endif
+	if (!changed) {
+		log_error("Failed to change the protection of the JIT buffer, the JIT core will interpret every block");
+		i8080_jitFlush(state);
+		jitRelease(jit);
+		return false;
+	}
+	jit->writable = writable;
+	return true;
+}
+
+bool i8080_jitAvailable(void) {
+	return true;
+}
+
+bool i8080_jitCompile(i8080State* state, i8080Block* block) {
+	i8080JitBuffer* jit = jitBuffer(state);
+	if (jit->code == NULL)
+		return false;
+
+	// Start over once the buffer is full, every block gets compiled again when it next becomes hot
+	int limit = block->count * JIT_MAX_OP_BYTES + JIT_BLOCK_BYTES;
+	if (jit->used + limit > jit->size)
+		i8080_jitFlush(state);
+	if (!jitProtect(state, jit, true))
+		return false;
+
+	jitCompiler compiler;
+	jitCompiler* c = &compiler;
+	memset(c, 0, sizeof(jitCompiler));
+	c->jit = jit;
+	c->state = state;
+	c->block = block;
+	c->e.code = jit->code + jit->used;
+	c->e.limit = limit;
+	jitEmitter* e = &c->e;
+
+	// Flags still read after each instruction, from the end back. Leaving the block, calling a handler or writing memory,
+	// which may run a write handler or leave the block, needs every flag in the state
+	int needs[BLOCK_MAX_INSTRUCTIONS];
+	int live = OPF_ALL;
+	for (int i = block->count - 1; i >= 0; i--) {
+		uint8_t opcode = block->ops[i].opcode;
+		const i8080OpcodeInfo* info = &i8080_opcodeInfo[opcode];
+		bool translated = jitInline(opcode);
+		if (!translated || (info->kind & OPK_WRITE) || i == block->count - 1)
+			live = OPF_ALL;
+		needs[i] = info->flagsWritten & live;
+		live = translated ? (live & ~info->flagsWritten) | info->flagsRead : OPF_ALL;
+		if (translated)
+			c->groups |= jitGroups(opcode);
+	}
+
+	// Prologue: save the callee saved registers the block uses, keeping the stack 16 byte aligned for the calls
+	c->saved[c->savedCount++] = HOST_STATE;
+	if (c->groups & GROUP_HL)
+		c->saved[c->savedCount++] = X86_RBX;
+	if (c->groups & GROUP_PSW)
+		c->saved[c->savedCount++] = HOST_PSW;
+	if (c->groups & GROUP_SP)
+		c->saved[c->savedCount++] = HOST_SP;
+	if (c->groups & GROUP_MEMORY) {
+		c->saved[c->savedCount++] = HOST_BUS;
+		c->saved[c->savedCount++] = HOST_CACHE;
+	}
+#if defined(_WIN32)
+	c->saved[c->savedCount++] = X86_RSI;
+	c->saved[c->savedCount++] = X86_RDI;
+#endif
+	c->frame = SHADOW_SPACE + 8;
+	if ((8 + c->savedCount * 8 + c->frame) % 16 != 0)
+		c->frame += 8;
+
+	for (int i = 0; i < c->savedCount; i++)
+		emitPush(e, c->saved[i]);
+	emitStack(e, -c->frame);
+	emitRR(e, OP_W, 0x89, ARG0, HOST_STATE);
+	if (c->groups & GROUP_MEMORY) {
+		emitRM(e, OP_W, 0x8B, HOST_BUS, HOST_STATE, -1, OFFSET(bus));
+		emitRM(e, OP_W, 0x8B, HOST_CACHE, HOST_STATE, -1, OFFSET(blockCache));
+	}
+	emitLoad(c);
+
+	uint16_t pc = block->startPc;
+	int cycles = 0;
+	bool exitSet = false;
+	for (int i = 0; i < block->count; i++) {
+		const i8080MicroOp* op = &block->ops[i];
+		bool last = i == block->count - 1;
+
+		if (!jitInline(op->opcode)) {
+			emitHandler(c, op, pc, cycles, last);
+		}
+		else {
+			exitSet = emitOp(c, op, pc, cycles, needs[i]);
+
+			// Stop if the instruction wrote over the block
+			if (!last && (i8080_opcodeInfo[op->opcode].kind & OPK_WRITE)) {
+				emitRM(e, 0, 0x80, 7, HOST_CACHE, -1, (int32_t)((uint8_t*)&block->valid - (uint8_t*)state->blockCache));
+				emit8(e, 0);
+				jitStub* stub = addStub(c, STUB_EXIT);
+				stub->pc = pc + op->length;
+				stub->cycles = cycles + op->cycles;
+				stub->jumps[0] = emitJump(e, X86_CC_Z);
+			}
+		}
+		pc += op->length;
+		cycles += op->cycles;
+	}
+	if (jitInline(block->ops[block->count - 1].opcode) && !exitSet) {
+		emitMovImm(e, X86_RDI, pc);
+		emitMovImm(e, X86_RSI, cycles);
+	}
+
+	// Exit: EDI holds the pc and ESI the cycles
+	int32_t rxTxOffset = 0;
+	uint8_t rxTxMask = 0;
+	jitRxTx(&rxTxOffset, &rxTxMask);
+	c->exitPos = e->pos;
+	for (int i = 0; i < c->exitJumpCount; i++)
+		emitPatch(e, c->exitJumps[i], c->exitPos);
+	emitWriteBack(c);
+	emitRM(e, OP_16, 0x89, X86_RDI, HOST_STATE, -1, OFFSET(pc));
+	emitRM(e, 0, 0x80, 4, HOST_STATE, -1, rxTxOffset); // and byte [state + rx/tx], ~mask
+	emit8(e, (uint8_t)~rxTxMask);
+	emitRR(e, 0, 0x89, X86_RSI, X86_RAX);
+
+	c->epiloguePos = e->pos;
+	emitStack(e, c->frame);
+	for (int i = c->savedCount - 1; i >= 0; i--)
+		emitPop(e, c->saved[i]);
+	emit8(e, 0xC3); // ret
+
+	// Out of line paths
+	for (int i = 0; i < c->stubCount; i++) {
+		jitStub* stub = &c->stubs[i];
+		for (int j = 0; j < 2; j++) {
+			if (stub->jumps[j] != 0)
+				emitPatch(e, stub->jumps[j], e->pos);
+		}
+
+		switch (stub->kind) {
+		case STUB_READ:
+		case STUB_WRITE:
+			if (stub->kind == STUB_WRITE)
+				emitSource(e, X86_RDI, stub->value, stub->immediate);
+			emitRR(e, 0, 0x89, stub->address, X86_RSI);
+			for (int j = 0; j < STUB_SAVED_COUNT; j++)
+				emitPush(e, stubSaved[j]);
+			emitStack(e, -STUB_PAD);
+			if (stub->kind == STUB_WRITE)
+				emitRR(e, 0, 0x89, X86_RDI, ARG2);
+			if (ARG1 != X86_RSI)
+				emitRR(e, 0, 0x89, X86_RSI, ARG1);
+			emitRR(e, OP_W, 0x89, HOST_STATE, ARG0);
+			if (stub->kind == STUB_WRITE) {
+				emitCall(e, (uint64_t)(size_t)i8080op_writeMemory);
+			}
+			else {
+				emitCall(e, (uint64_t)(size_t)i8080op_readMemory);
+				emitRM(e, OP_BYTE_REG, 0x88, X86_AL, X86_RSP, -1, STUB_PAD + STUB_SAVED_COUNT * 8 + TEMP_OFFSET);
+			}
+			emitStack(e, STUB_PAD);
+			for (int j = STUB_SAVED_COUNT - 1; j >= 0; j--)
+				emitPop(e, stubSaved[j]);
+			if (stub->kind == STUB_READ)
+				emitRM(e, OP_W, 0x8D, X86_RSI, X86_RSP, -1, TEMP_OFFSET);
+			emitPatch(e, emitJump(e, X86_ALWAYS), stub->resume);
+			break;
+		case STUB_EXIT:
+			emitMovImm(e, X86_RDI, stub->pc);
+			emitMovImm(e, X86_RSI, stub->cycles);
+			emitPatch(e, emitJump(e, X86_ALWAYS), c->exitPos);
+			break;
+		case STUB_RETURN:
+			emitRR(e, 0, 0x0FB7, X86_RAX, X86_RAX); // movzx eax, ax
+			emitRR(e, 0, 0x81, 0, X86_RAX);
+			emit32(e, stub->cycles);
+			emitPatch(e, emitJump(e, X86_ALWAYS), c->epiloguePos);
+			break;
+		}
+	}
+
+	if (e->pos > e->limit) {
+		log_error("Native code for the block at %04X overran its %i bytes, it stays interpreted", block->startPc, e->limit);
+		jitProtect(state, jit, false);
+		return false;
+	}
+	if (!jitProtect(state, jit, false))
+		return false;
+
+	block->native = (i8080NativeBlock)(void*)e->code;
+	jit->used += (e->pos + 15) & ~15;
+	return true;
+}
+
+void i8080_jitFlush(i8080State* state) {
+	i8080BlockCache* cache = state->blockCache;
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		cache->blocks[i].native = NULL;
+	}
+	if (cache->jit != NULL)
+		cache->jit->used = 0;
+}
+
+void i8080_jitDestroy(i8080BlockCache* cache) {
+	if (cache == NULL || cache->jit == NULL)
+		return;
+	jitRelease(cache->jit);
+	free(cache->jit);
+	cache->jit = NULL;
+}
+
+#else
+
+bool i8080_jitAvailable(void) {
+	return false;
+}
+
+bool i8080_jitCompile(i8080State* state, i8080Block* block) {
+	// No backend for this host, the JIT core interprets the cached blocks
+	return false;
+}
+
+void i8080_jitFlush(i8080State* state) {
+	for (int i = 0; i < BLOCK_CACHE_SIZE; i++) {
+		state->blockCache->blocks[i].native = NULL;
+	}
+}
+
+void i8080_jitDestroy(i8080BlockCache* cache) {
+}
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+/*
+
+i8080_jit.h
+
+x86-64 translation of cached basic blocks into native code. The 8080 registers and flags stay in host registers for the
+whole block, memory is read and written through the bus page table inline, and flags are only worked out where something
+reads them. I/O, DAA, EI, DI, HLT and XTHL call their handlers. Other hosts keep running the blocks through the interpreter
+
+*/
+
+#include "i8080_blockcache.h"
+
+// Size of the buffer native blocks are written into, executable but only writable while a block is compiled
+#define JIT_BUFFER_SIZE (1024 * 1024)
+
+// Number of whole runs of a block before it is compiled. 0 compiles blocks the first time they run
+extern int jit_hotThreshold;
+
+// Flag tables of the native code, one per way of building the ac flag
+#define JIT_FLAG_TABLES 4
+
+typedef struct i8080JitBuffer {
+	uint8_t* code;
+	int size;
+	int used;
+	bool writable; // the code is either writable, while a block is compiled, or executable
+	uint8_t flagTables[JIT_FLAG_TABLES][0x100]; // the s, z, p and ac bits an 8 bit result leaves, by result
+} i8080JitBuffer;
+
+// Returns if native code can be generated on this host
+bool i8080_jitAvailable(void);
+
+// Compiles the block into native code and sets block->native. Returns false if it could not be compiled
+bool i8080_jitCompile(i8080State* state, i8080Block* block);
+
+// Drops the native code of every block and empties the buffer
+void i8080_jitFlush(i8080State* state);
+
+// Releases the executable buffer
+void i8080_jitDestroy(i8080BlockCache* cache);
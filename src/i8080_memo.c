@@ -0,0 +1,348 @@
+/*
+
+i8080_memo.c
+
+Memoisation of pure ROM subroutines, recorded from the CALL and RET handlers and replayed at their call sites
+
+*/
+
+#include "i8080_memo.h"
+#include "i8080.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Empties the routine slots, sites and recorder of a memo
+static void memoEmpty(i8080Memo* memo) {
+	for (int i = 0; i < MEMO_ROUTINES; i++) {
+		i8080MemoRoutine* routine = &memo->routines[i];
+		free(routine->results);
+		memset(routine, 0, sizeof(i8080MemoRoutine));
+		routine->entry = -1;
+	}
+	memset(memo->sites, 0, sizeof(memo->sites));
+	memo->recorder.state = NULL;
+}
+
+// The routine called at entry, from a slot probed from its address. A new one takes a free slot if create is set. NULL if
+// there is none, or no free slot is left
+static i8080MemoRoutine* memoRoutine(i8080Memo* memo, uint16_t entry, bool create) {
+	for (int i = 0; i < MEMO_ROUTINES; i++) {
+		i8080MemoRoutine* routine = &memo->routines[(entry + i) % MEMO_ROUTINES];
+		if (routine->entry == entry)
+			return routine;
+		if (routine->entry == -1) {
+			if (!create)
+				return NULL;
+			routine->results = malloc(MEMO_RESULTS * sizeof(i8080MemoResult));
+			if (routine->results == NULL) {
+				log_error("Failed to allocate memory for the results of the routine at %04X", entry);
+				return NULL;
+			}
+			routine->entry = entry;
+			return routine;
+		}
+	}
+	return NULL;
+}
+
+void i8080_memoCall(i8080State* state, uint16_t site, uint16_t address) {
+	i8080Memo* memo = state->bus->memo;
+	if (memo == NULL) {
+		memo = malloc(sizeof(i8080Memo));
+		if (memo == NULL) {
+			log_error("Failed to allocate memory for memoisation");
+			return;
+		}
+		for (int i = 0; i < MEMO_ROUTINES; i++) {
+			memo->routines[i].results = NULL;
+		}
+		memoEmpty(memo);
+		state->bus->memo = memo;
+	}
+
+	i8080MemoRecorder* recorder = &memo->recorder;
+	if (recorder->state == state) {
+		// The ROM is taken as fixed, code anywhere else could change under a held result
+		if (address >= i8080_ROM_SIZE)
+			i8080_memoAbort(state, "calls code outside the ROM");
+		else
+			recorder->depth++;
+		return;
+	}
+	if (recorder->state != NULL)
+		return;
+
+	// A map that lets the ROM be written can change it, the trace reads memory on its own, and the block cores only bring
+	// cyclesExecuted up to date at the end of each block
+	if (state->traced || state->core == CORE_BLOCK || state->core == CORE_JIT || address >= i8080_ROM_SIZE || !i8080_busReadOnly(state, 0, i8080_ROM_SIZE))
+		return;
+
+	i8080MemoRoutine* routine = memoRoutine(memo, address, true);
+	if (routine == NULL || routine->impure != NULL)
+		return;
+
+	uint8_t opcode = i8080_busRead(state, site);
+	recorder->state = state;
+	recorder->routine = routine;
+	recorder->site = site;
+	recorder->returnPc = site + i8080_getInstructionLength(opcode);
+	recorder->callCycles = i8080_getInstructionClockCycles(opcode);
+	recorder->startCycles = state->cyclesExecuted;
+	recorder->depth = 0;
+	recorder->ien = state->f.ien;
+
+	i8080MemoResult* result = &recorder->result;
+	result->a = state->a;
+	result->psw = I8080_FLAGS(state)->psw;
+	result->bc = state->bc;
+	result->de = state->de;
+	result->hl = state->hl;
+	result->sp = state->sp;
+	result->readCount = 0;
+	result->writeCount = 0;
+}
+
+void i8080_memoRead(i8080State* state, uint16_t address, uint8_t value) {
+	// Calls are only recorded while the map write protects the ROM, so reads of it are not inputs
+	if (address < i8080_ROM_SIZE)
+		return;
+
+	i8080MemoResult* result = &state->bus->memo->recorder.result;
+	for (int i = 0; i < result->writeCount; i++) {
+		if (result->writes[i].address == address)
+			return;
+	}
+	for (int i = 0; i < result->readCount; i++) {
+		if (result->reads[i].address == address)
+			return;
+	}
+	if (result->readCount == MEMO_ACCESSES) {
+		i8080_memoAbort(state, "reads too much memory");
+		return;
+	}
+	result->reads[result->readCount].address = address;
+	result->reads[result->readCount].value = value;
+	result->readCount++;
+}
+
+void i8080_memoWrite(i8080State* state, uint16_t address, uint8_t value) {
+	i8080MemoResult* result = &state->bus->memo->recorder.result;
+	for (int i = 0; i < result->writeCount; i++) {
+		if (result->writes[i].address == address) {
+			result->writes[i].value = value;
+			return;
+		}
+	}
+	if (result->writeCount == MEMO_ACCESSES) {
+		i8080_memoAbort(state, "writes too much memory");
+		return;
+	}
+	result->writes[result->writeCount].address = address;
+	result->writes[result->writeCount].value = value;
+	result->writeCount++;
+}
+
+// Whether two results have the same registers and reads, the reads being in the same order when they are
+static bool memoSameInputs(const i8080MemoResult* a, const i8080MemoResult* b) {
+	if (a->a != b->a || a->psw != b->psw || a->bc != b->bc || a->de != b->de || a->hl != b->hl || a->sp != b->sp
+		|| a->readCount != b->readCount)
+		return false;
+	return memcmp(a->reads, b->reads, a->readCount * sizeof(i8080MemoAccess)) == 0;
+}
+
+static bool memoSameOutputs(const i8080MemoResult* a, const i8080MemoResult* b) {
+	if (a->outA != b->outA || a->outPsw != b->outPsw || a->outBc != b->outBc || a->outDe != b->outDe || a->outHl != b->outHl
+		|| a->writeCount != b->writeCount || a->cycles != b->cycles)
+		return false;
+	return memcmp(a->writes, b->writes, a->writeCount * sizeof(i8080MemoAccess)) == 0;
+}
+
+void i8080_memoReturn(i8080State* state, uint16_t retPc) {
+	i8080MemoRecorder* recorder = &state->bus->memo->recorder;
+	if (recorder->depth > 0) {
+		recorder->depth--;
+		if (state->pc >= i8080_ROM_SIZE)
+			i8080_memoAbort(state, "runs code outside the ROM");
+		return;
+	}
+
+	// The trace may have been turned on part way, its reads are then among the inputs, as may a block core
+	if (state->traced || state->core == CORE_BLOCK || state->core == CORE_JIT) {
+		i8080_memoAbort(state, NULL);
+		return;
+	}
+	i8080MemoResult* result = &recorder->result;
+	if (state->pc != recorder->returnPc || state->sp != (uint16_t)(result->sp + 2)) {
+		i8080_memoAbort(state, "does not return to its caller");
+		return;
+	}
+	if (state->f.ien != recorder->ien) {
+		i8080_memoAbort(state, "changes the interrupt enable");
+		return;
+	}
+
+	result->outA = state->a;
+	result->outPsw = I8080_FLAGS(state)->psw;
+	result->outBc = state->bc;
+	result->outDe = state->de;
+	result->outHl = state->hl;
+	// cyclesExecuted stands at the start of the RET, the CALL was counted before the routine started
+	result->cycles = (int)(state->cyclesExecuted - recorder->startCycles) - recorder->callCycles
+		+ i8080_getInstructionClockCycles(i8080_busRead(state, retPc));
+	recorder->state = NULL;
+
+	i8080MemoRoutine* routine = recorder->routine;
+	routine->recorded++;
+	bool held = false;
+	for (int i = 0; i < routine->resultCount; i++) {
+		if (!memoSameInputs(&routine->results[i], result))
+			continue;
+		if (!memoSameOutputs(&routine->results[i], result)) {
+			routine->impure = "gives different results for the same inputs";
+			return;
+		}
+		routine->repeats++;
+		held = true;
+		break;
+	}
+	if (!held) {
+		int slot = routine->resultCount;
+		if (slot < MEMO_RESULTS)
+			routine->resultCount++;
+		else
+			slot = routine->nextResult++ % MEMO_RESULTS;
+		routine->results[slot] = *result;
+	}
+
+	// Only plain CALLs are replayed, a conditional call would need its condition checked first
+	if (i8080_busRead(state, recorder->site) == CALL)
+		state->bus->memo->sites[recorder->site >> 3] |= 1 << (recorder->site & 7);
+}
+
+void i8080_memoAbort(i8080State* state, const char* reason) {
+	if (!I8080_MEMO_RECORDING(state))
+		return;
+	i8080MemoRecorder* recorder = &state->bus->memo->recorder;
+	if (reason != NULL && recorder->routine->impure == NULL)
+		recorder->routine->impure = reason;
+	recorder->state = NULL;
+}
+
+int i8080_memoReplay(i8080State* state, int cyclesUsed, int cycleBudget) {
+	// As for HLE, a replayed call suits neither the trace nor the accurate timing
+	if (state->traced || state->timing == TIMING_ACCURATE)
+		return 0;
+
+	uint8_t byte1, byte2;
+	if (i8080_fetch(state, &byte1, &byte2) != CALL)
+		return 0;
+	i8080MemoRoutine* routine = memoRoutine(state->bus->memo, byte1 | (byte2 << 8), false);
+	if (routine == NULL || routine->impure != NULL || routine->repeats == 0 || !i8080_busReadOnly(state, 0, i8080_ROM_SIZE))
+		return 0;
+
+	int room = cycleBudget - cyclesUsed - 1;
+	int toInterrupt = (int)state->bus->board->interruptPeriod - (int)state->interruptAccumulator - 1;
+	if (toInterrupt < room)
+		room = toInterrupt;
+
+	// The routine reads its registers and memory after the CALL pushed the return address
+	flagRegister* f = I8080_FLAGS(state);
+	uint16_t sp = state->sp - 2;
+	uint16_t returnPc = state->pc + 3;
+	uint16_t pushLow = i8080op_mirrorAddress(state, sp);
+	uint16_t pushHigh = i8080op_mirrorAddress(state, sp + 1);
+	for (int i = 0; i < routine->resultCount; i++) {
+		i8080MemoResult* result = &routine->results[i];
+		if (result->a != state->a || result->psw != f->psw || result->bc != state->bc || result->de != state->de
+			|| result->hl != state->hl || result->sp != sp)
+			continue;
+
+		bool matches = true;
+		for (int j = 0; j < result->readCount && matches; j++) {
+			uint16_t address = result->reads[j].address;
+			uint8_t value = address == pushLow ? (returnPc & 0xFF) : address == pushHigh ? (returnPc >> 8) : state->memory[address];
+			matches = value == result->reads[j].value;
+		}
+		if (!matches)
+			continue;
+
+		int cycles = i8080_getInstructionClockCycles(CALL) + result->cycles;
+		if (cycles > room)
+			return 0;
+
+		i8080op_pushStack(state, returnPc);
+		// A call being recorded around this one sees its reads and writes as if it had run
+		if (I8080_MEMO_RECORDING(state)) {
+			for (int j = 0; j < result->readCount; j++) {
+				i8080_memoRead(state, result->reads[j].address, result->reads[j].value);
+			}
+		}
+		for (int j = 0; j < result->writeCount; j++) {
+			i8080op_writeMemory(state, result->writes[j].address, result->writes[j].value);
+		}
+		i8080op_setSP(state, state->sp + 2);
+		state->a = result->outA;
+		state->f.psw = result->outPsw;
+		state->bc = result->outBc;
+		state->de = result->outDe;
+		state->hl = result->outHl;
+		state->f.isi = 0;
+		state->pc = returnPc;
+
+		state->cyclesExecuted += cycles;
+		state->interruptAccumulator += cycles;
+		routine->hits++;
+		routine->cyclesSaved += cycles;
+		return cycles;
+	}
+	routine->misses++;
+	return 0;
+}
+
+void i8080_memoClear(i8080State* state) {
+	if (state->bus->memo != NULL)
+		memoEmpty(state->bus->memo);
+}
+
+void i8080_memoFree(i8080State* state) {
+	if (state->bus->memo == NULL)
+		return;
+	memoEmpty(state->bus->memo);
+	free(state->bus->memo);
+	state->bus->memo = NULL;
+}
+
+i8080MemoRoutine* i8080_memoFind(i8080State* state, uint16_t entry) {
+	return state->bus->memo == NULL ? NULL : memoRoutine(state->bus->memo, entry, false);
+}
+
+unsigned long i8080_memoCyclesSaved(i8080State* state) {
+	unsigned long cycles = 0;
+	for (int i = 0; state->bus->memo != NULL && i < MEMO_ROUTINES; i++) {
+		cycles += state->bus->memo->routines[i].cyclesSaved;
+	}
+	return cycles;
+}
+
+static int memoCompareEntries(const void* a, const void* b) {
+	return (*(const i8080MemoRoutine**)a)->entry - (*(const i8080MemoRoutine**)b)->entry;
+}
+
+void i8080_memoReport(i8080State* state, FILE* file) {
+	i8080MemoRoutine* routines[MEMO_ROUTINES];
+	int count = 0;
+	for (int i = 0; state->bus->memo != NULL && i < MEMO_ROUTINES; i++) {
+		if (state->bus->memo->routines[i].entry != -1)
+			routines[count++] = &state->bus->memo->routines[i];
+	}
+	qsort(routines, count, sizeof(i8080MemoRoutine*), memoCompareEntries);
+
+	fprintf(file, "Memoised routines: %i\n", count);
+	for (int i = 0; i < count; i++) {
+		i8080MemoRoutine* routine = routines[i];
+		fprintf(file, "%04X: recorded %lu, repeats %lu, results %i, hits %lu, misses %lu, cycles saved %lu, %s\n",
+			routine->entry, routine->recorded, routine->repeats, routine->resultCount, routine->hits, routine->misses,
+			routine->cyclesSaved, routine->impure == NULL ? "pure" : routine->impure);
+	}
+}
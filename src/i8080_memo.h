@@ -0,0 +1,131 @@
+#pragma once
+/*
+
+i8080_memo.h
+
+Memoisation of pure ROM subroutines. Under MEMO_PROFILE or MEMO_ON every CALL into the ROM starts a recording, unless
+one is already going, of the registers the routine starts with, the RAM it reads before writing it and what it leaves
+behind: registers, flags, the RAM it wrote and the cycles it took up to its RET. A routine that touches a port, halts,
+changes the interrupt enable, runs code outside the ROM, does not return to its caller or gives two results for the same
+inputs is marked impure for good, an interrupted call is only dropped. Under MEMO_ON a CALL to a routine that has given
+the same result twice is looked up in its results first, and a result whose registers and memory reads match is replayed
+in one step with the cycles the routine took, if they end before the budget runs out and the next interrupt is due. The
+ROM is taken as fixed, so nothing is recorded or replayed unless the memory map write protects it. Each machine keeps its
+own routines with its bus, recorded from its own ROM, and reset8080 forgets them. The block and JIT cores refuse
+memoisation: they run a CALL in the middle of a block and count cycles a block at a time, so they turn it off when they run
+
+*/
+
+#include "i8080_util.h"
+
+#include <stdio.h>
+
+// Routines tracked, by the address they are called at
+#define MEMO_ROUTINES 256
+// Results kept per routine, the oldest is replaced once they are all used
+#define MEMO_RESULTS 32
+// Most addresses a routine may read before writing them, and most it may write, for its call to be recorded
+#define MEMO_ACCESSES 32
+
+typedef struct i8080MemoAccess {
+	uint16_t address; // as stored in memory, after mirroring
+	uint8_t value;
+} i8080MemoAccess;
+
+typedef struct i8080MemoResult {
+	// Inputs, the registers after the CALL pushed its return address and the memory read in the order it was first read
+	uint8_t a, psw;
+	uint16_t bc, de, hl, sp;
+	int readCount;
+	i8080MemoAccess reads[MEMO_ACCESSES];
+	// Outputs, the registers after the RET and the last value written to each address, in the order first written
+	uint8_t outA, outPsw;
+	uint16_t outBc, outDe, outHl;
+	int writeCount;
+	i8080MemoAccess writes[MEMO_ACCESSES];
+	int cycles; // from the first instruction of the routine to the end of its RET
+} i8080MemoResult;
+
+typedef struct i8080MemoRoutine {
+	int entry; // address called, -1 for a free slot
+	const char* impure; // why the routine can not be memoised, NULL while it looks pure
+	int resultCount;
+	int nextResult; // the slot the next new result goes in once they are all used
+	i8080MemoResult* results; // MEMO_RESULTS, allocated when the first call is recorded
+	// Counters, never cleared
+	unsigned long recorded; // calls recorded to the end
+	unsigned long repeats; // recorded calls that gave a result already held for the same inputs
+	unsigned long hits; // calls replayed from a result
+	unsigned long misses; // calls looked up under MEMO_ON without a result to replay
+	unsigned long cyclesSaved; // cycles of the replayed calls, CALL included
+} i8080MemoRoutine;
+
+// The call being recorded by a machine
+typedef struct i8080MemoRecorder {
+	i8080State* state; // the state recording, NULL when nothing is being recorded
+	i8080MemoRoutine* routine;
+	uint16_t site; // address of the calling instruction
+	uint16_t returnPc;
+	int callCycles; // cycles of the calling instruction
+	unsigned long startCycles; // cyclesExecuted as the calling instruction started
+	int depth; // calls made by the routine that have not returned yet
+	bool ien; // interrupt enable at the call
+	i8080MemoResult result;
+} i8080MemoRecorder;
+
+// What a machine has memoised, in state->bus->memo. Allocated by the first call recorded, NULL until then
+typedef struct i8080Memo {
+	i8080MemoRoutine routines[MEMO_ROUTINES];
+	i8080MemoRecorder recorder;
+	// One bit per address, set for the CALL instructions of recorded calls so the run loops only look up calls made there
+	uint8_t sites[0x10000 / 8];
+} i8080Memo;
+
+// From i8080op_executeCALL, after the return address is pushed. site is the address of the calling instruction
+void i8080_memoCall(i8080State* state, uint16_t site, uint16_t address);
+
+// From i8080op_executeRET, after the pc is popped. retPc is the address of the returning instruction
+void i8080_memoReturn(i8080State* state, uint16_t retPc);
+
+// From i8080op_readMemory and i8080op_writeMemory, for the state being recorded
+void i8080_memoRead(i8080State* state, uint16_t address, uint8_t value);
+void i8080_memoWrite(i8080State* state, uint16_t address, uint8_t value);
+
+// Drops the call being recorded for the state, if any. A reason marks the routine impure
+void i8080_memoAbort(i8080State* state, const char* reason);
+
+// For a pc that is a call site. Replays the call from a result of its routine if one matches and it ends before the
+// budget runs out and the next interrupt is due, adding its cycles to cyclesExecuted and interruptAccumulator. Returns
+// the cycles replayed
+int i8080_memoReplay(i8080State* state, int cyclesUsed, int cycleBudget);
+
+// Forgets every routine and result of the machine and clears its counters
+void i8080_memoClear(i8080State* state);
+
+// Frees what the machine has memoised, for i8080_destroyState
+void i8080_memoFree(i8080State* state);
+
+// The routine of the machine called at entry, NULL if it is not tracked
+i8080MemoRoutine* i8080_memoFind(i8080State* state, uint16_t entry);
+
+// Cycles of the replayed calls over every routine of the machine
+unsigned long i8080_memoCyclesSaved(i8080State* state);
+
+// Writes a line per routine the machine tracks with its purity, hits, misses and cycles saved
+void i8080_memoReport(i8080State* state, FILE* file);
+
+// Whether the state is recording a call
+#define I8080_MEMO_RECORDING(state) ((state)->bus->memo != NULL && (state)->bus->memo->recorder.state == (state))
+
+// Records the memory accesses of the call being recorded, for i8080op_readMemory and i8080op_writeMemory
+#define I8080_MEMO_READ(state, address, value) \
+	if (I8080_MEMO_RECORDING(state)) \
+		i8080_memoRead((state), (address), (value))
+#define I8080_MEMO_WRITE(state, address, value) \
+	if (I8080_MEMO_RECORDING(state)) \
+		i8080_memoWrite((state), (address), (value))
+
+// Replays memoised calls, for the run loops of the interpreting cores straight after I8080_HLE_CHECK
+#define I8080_MEMO_CHECK(state, cyclesUsed, cycleBudget) \
+	if ((state)->memo == MEMO_ON && (state)->bus->memo != NULL && ((state)->bus->memo->sites[(state)->pc >> 3] >> ((state)->pc & 7) & 1)) \
+		(cyclesUsed) += i8080_memoReplay((state), (cyclesUsed), (cycleBudget))
@@ -0,0 +1,316 @@
+#pragma once
+/*
+
+i8080_opcodes.h
+
+Every opcode described once. I8080_OPCODE_LIST is the one place the mnemonic, operand format, length, cycle counts, flag
+use and memory, stack and I/O behaviour of an opcode are written down: the opcode enum, instructionParams, i8080_opcodeInfo,
+the disassembler and trace line, the handler and label tables of the dispatch cores and the opcode classes used by the
+block builders, the fused core and the idle loop detection are all expanded from it
+
+*/
+
+// How the operand bytes of an instruction are shown
+enum i8080OperandFormat {
+	OPFMT_NONE,
+	OPFMT_BYTE, // d8, after a comma when the mnemonic already names a register: MVI B,12 ADI 12
+	OPFMT_WORD, // d16: LXI H,2400
+	OPFMT_ADDRESS, // a16: JMP 1A32 LDA 20C0
+	OPFMT_PORT // p8: IN 01
+};
+
+// Flags an instruction reads or writes, as bits of the PSW. These are the flags the cores write, which for XRA and ORA
+// leave the carry and for DAA leave S, Z and P as they were
+#define OPF_NONE 0
+#define OPF_S FLAG_S
+#define OPF_Z FLAG_Z
+#define OPF_AC FLAG_AC
+#define OPF_P FLAG_P
+#define OPF_C FLAG_C
+#define OPF_SZAP (FLAG_S | FLAG_Z | FLAG_AC | FLAG_P)
+#define OPF_ALL FLAG_MASK
+
+// What an instruction does besides moving data between registers
+#define OPK_READ 0x0001 // reads memory, the stack included
+#define OPK_WRITE 0x0002 // writes memory, the stack included
+#define OPK_STACK 0x0004 // reads or writes memory at the stack pointer
+#define OPK_IO 0x0008 // IN, OUT
+#define OPK_INTERRUPT 0x0010 // changes the interrupt enable: EI, DI
+#define OPK_HALT 0x0020 // HLT
+#define OPK_JUMP 0x0040 // sets the pc, taken or not, which ends a block
+#define OPK_CONDITIONAL 0x0080 // a jump, call or return that may fall through, taking the failed cycle count if it is a call or return
+#define OPK_CALL 0x0100 // pushes the return address: CALL, Cxx, RST
+#define OPK_RETURN 0x0200 // pops the pc: RET, Rxx
+#define OPK_UNDOCUMENTED 0x0400 // not run by the cores, which treat it as unimplemented
+
+// X(<opcode hex>, <enum name>, <dispatch handler>, <mnemonic>, <operand format>, <length>, <cycles>, <failed cycles>, <flags read>, <flags written>, <kind>)
+// One opcode per line, in order. Failed cycles are only set for the conditional calls and returns, a conditional jump
+// takes as long either way
+#define I8080_OPCODE_LIST(X) \
+	X(00, NOP, op_NOP, "NOP", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, 0) \
+	X(01, LXI_B, op_LXI_B, "LXI B", OPFMT_WORD, 3, 10, 0, OPF_NONE, OPF_NONE, 0) \
+	X(02, STAX_B, op_STAX_B, "STAX B", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(03, INX_B, op_INX_B, "INX B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(04, INR_B, op_INR_B, "INR B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(05, DCR_B, op_DCR_B, "DCR B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(06, MVI_B, op_MVI_B, "MVI B", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(07, RLC, op_RLC, "RLC", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_C, 0) \
+	X(08, UNDOC_08, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(09, DAD_B, op_DAD_B, "DAD B", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_C, 0) \
+	X(0A, LDAX_B, op_LDAX_B, "LDAX B", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(0B, DCX_B, op_DCX_B, "DCX B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(0C, INR_C, op_INR_C, "INR C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(0D, DCR_C, op_DCR_C, "DCR C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(0E, MVI_C, op_MVI_C, "MVI C", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(0F, RRC, op_RRC, "RRC", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_C, 0) \
+	X(10, UNDOC_10, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(11, LXI_D, op_LXI_D, "LXI D", OPFMT_WORD, 3, 10, 0, OPF_NONE, OPF_NONE, 0) \
+	X(12, STAX_D, op_STAX_D, "STAX D", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(13, INX_D, op_INX_D, "INX D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(14, INR_D, op_INR_D, "INR D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(15, DCR_D, op_DCR_D, "DCR D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(16, MVI_D, op_MVI_D, "MVI D", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(17, RAL, op_RAL, "RAL", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_C, 0) \
+	X(18, UNDOC_18, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(19, DAD_D, op_DAD_D, "DAD D", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_C, 0) \
+	X(1A, LDAX_D, op_LDAX_D, "LDAX D", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(1B, DCX_D, op_DCX_D, "DCX D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(1C, INR_E, op_INR_E, "INR E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(1D, DCR_E, op_DCR_E, "DCR E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(1E, MVI_E, op_MVI_E, "MVI E", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(1F, RAR, op_RAR, "RAR", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_C, 0) \
+	X(20, UNDOC_20, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(21, LXI_H, op_LXI_H, "LXI H", OPFMT_WORD, 3, 10, 0, OPF_NONE, OPF_NONE, 0) \
+	X(22, SHLD, op_SHLD, "SHLD", OPFMT_ADDRESS, 3, 16, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(23, INX_H, op_INX_H, "INX H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(24, INR_H, op_INR_H, "INR H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(25, DCR_H, op_DCR_H, "DCR H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(26, MVI_H, op_MVI_H, "MVI H", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(27, DAA, op_DAA, "DAA", OPFMT_NONE, 1, 4, 0, OPF_AC | OPF_C, OPF_AC | OPF_C, 0) \
+	X(28, UNDOC_28, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(29, DAD_H, op_DAD_H, "DAD H", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_C, 0) \
+	X(2A, LHLD, op_LHLD, "LHLD", OPFMT_ADDRESS, 3, 16, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(2B, DCX_H, op_DCX_H, "DCX H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(2C, INR_L, op_INR_L, "INR L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(2D, DCR_L, op_DCR_L, "DCR L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(2E, MVI_L, op_MVI_L, "MVI L", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(2F, CMA, op_CMA, "CMA", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, 0) \
+	X(30, UNDOC_30, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(31, LXI_SP, op_LXI_SP, "LXI SP", OPFMT_WORD, 3, 10, 0, OPF_NONE, OPF_NONE, 0) \
+	X(32, STA, op_STA, "STA", OPFMT_ADDRESS, 3, 13, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(33, INX_SP, op_INX_SP, "INX SP", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(34, INR_M, op_INR_M, "INR M", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_SZAP, OPK_READ | OPK_WRITE) \
+	X(35, DCR_M, op_DCR_M, "DCR M", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_SZAP, OPK_READ | OPK_WRITE) \
+	X(36, MVI_M, op_MVI_M, "MVI M", OPFMT_BYTE, 2, 10, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(37, STC, op_STC, "STC", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_C, 0) \
+	X(38, UNDOC_38, op_unimplemented, "unknown", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(39, DAD_SP, op_DAD_SP, "DAD SP", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_C, 0) \
+	X(3A, LDA, op_LDA, "LDA", OPFMT_ADDRESS, 3, 13, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(3B, DCX_SP, op_DCX_SP, "DCX SP", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(3C, INR_A, op_INR_A, "INR A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(3D, DCR_A, op_DCR_A, "DCR A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_SZAP, 0) \
+	X(3E, MVI_A, op_MVI_A, "MVI A", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_NONE, 0) \
+	X(3F, CMC, op_CMC, "CMC", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_C, 0) \
+	X(40, MOV_BB, op_MOV_BB, "MOV B,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(41, MOV_BC, op_MOV_BC, "MOV B,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(42, MOV_BD, op_MOV_BD, "MOV B,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(43, MOV_BE, op_MOV_BE, "MOV B,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(44, MOV_BH, op_MOV_BH, "MOV B,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(45, MOV_BL, op_MOV_BL, "MOV B,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(46, MOV_BM, op_MOV_BM, "MOV B,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(47, MOV_BA, op_MOV_BA, "MOV B,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(48, MOV_CB, op_MOV_CB, "MOV C,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(49, MOV_CC, op_MOV_CC, "MOV C,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(4A, MOV_CD, op_MOV_CD, "MOV C,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(4B, MOV_CE, op_MOV_CE, "MOV C,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(4C, MOV_CH, op_MOV_CH, "MOV C,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(4D, MOV_CL, op_MOV_CL, "MOV C,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(4E, MOV_CM, op_MOV_CM, "MOV C,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(4F, MOV_CA, op_MOV_CA, "MOV C,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(50, MOV_DB, op_MOV_DB, "MOV D,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(51, MOV_DC, op_MOV_DC, "MOV D,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(52, MOV_DD, op_MOV_DD, "MOV D,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(53, MOV_DE, op_MOV_DE, "MOV D,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(54, MOV_DH, op_MOV_DH, "MOV D,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(55, MOV_DL, op_MOV_DL, "MOV D,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(56, MOV_DM, op_MOV_DM, "MOV D,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(57, MOV_DA, op_MOV_DA, "MOV D,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(58, MOV_EB, op_MOV_EB, "MOV E,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(59, MOV_EC, op_MOV_EC, "MOV E,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(5A, MOV_ED, op_MOV_ED, "MOV E,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(5B, MOV_EE, op_MOV_EE, "MOV E,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(5C, MOV_EH, op_MOV_EH, "MOV E,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(5D, MOV_EL, op_MOV_EL, "MOV E,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(5E, MOV_EM, op_MOV_EM, "MOV E,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(5F, MOV_EA, op_MOV_EA, "MOV E,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(60, MOV_HB, op_MOV_HB, "MOV H,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(61, MOV_HC, op_MOV_HC, "MOV H,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(62, MOV_HD, op_MOV_HD, "MOV H,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(63, MOV_HE, op_MOV_HE, "MOV H,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(64, MOV_HH, op_MOV_HH, "MOV H,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(65, MOV_HL, op_MOV_HL, "MOV H,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(66, MOV_HM, op_MOV_HM, "MOV H,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(67, MOV_HA, op_MOV_HA, "MOV H,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(68, MOV_LB, op_MOV_LB, "MOV L,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(69, MOV_LC, op_MOV_LC, "MOV L,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(6A, MOV_LD, op_MOV_LD, "MOV L,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(6B, MOV_LE, op_MOV_LE, "MOV L,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(6C, MOV_LH, op_MOV_LH, "MOV L,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(6D, MOV_LL, op_MOV_LL, "MOV L,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(6E, MOV_LM, op_MOV_LM, "MOV L,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(6F, MOV_LA, op_MOV_LA, "MOV L,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(70, MOV_MB, op_MOV_MB, "MOV M,B", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(71, MOV_MC, op_MOV_MC, "MOV M,C", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(72, MOV_MD, op_MOV_MD, "MOV M,D", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(73, MOV_ME, op_MOV_ME, "MOV M,E", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(74, MOV_MH, op_MOV_MH, "MOV M,H", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(75, MOV_ML, op_MOV_ML, "MOV M,L", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(76, HLT, op_HLT, "HLT", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_HALT) \
+	X(77, MOV_MA, op_MOV_MA, "MOV M,A", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_WRITE) \
+	X(78, MOV_AB, op_MOV_AB, "MOV A,B", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(79, MOV_AC, op_MOV_AC, "MOV A,C", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(7A, MOV_AD, op_MOV_AD, "MOV A,D", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(7B, MOV_AE, op_MOV_AE, "MOV A,E", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(7C, MOV_AH, op_MOV_AH, "MOV A,H", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(7D, MOV_AL, op_MOV_AL, "MOV A,L", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(7E, MOV_AM, op_MOV_AM, "MOV A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_NONE, OPK_READ) \
+	X(7F, MOV_AA, op_MOV_AA, "MOV A,A", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(80, ADD_B, op_ADD_B, "ADD A,B", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(81, ADD_C, op_ADD_C, "ADD A,C", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(82, ADD_D, op_ADD_D, "ADD A,D", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(83, ADD_E, op_ADD_E, "ADD A,E", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(84, ADD_H, op_ADD_H, "ADD A,H", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(85, ADD_L, op_ADD_L, "ADD A,L", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(86, ADD_M, op_ADD_M, "ADD A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_ALL, OPK_READ) \
+	X(87, ADD_A, op_ADD_A, "ADD A,A", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(88, ADC_B, op_ADC_B, "ADC A,B", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(89, ADC_C, op_ADC_C, "ADC A,C", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(8A, ADC_D, op_ADC_D, "ADC A,D", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(8B, ADC_E, op_ADC_E, "ADC A,E", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(8C, ADC_H, op_ADC_H, "ADC A,H", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(8D, ADC_L, op_ADC_L, "ADC A,L", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(8E, ADC_M, op_ADC_M, "ADC A,M", OPFMT_NONE, 1, 7, 0, OPF_C, OPF_ALL, OPK_READ) \
+	X(8F, ADC_A, op_ADC_A, "ADC A,A", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(90, SUB_B, op_SUB_B, "SUB A,B", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(91, SUB_C, op_SUB_C, "SUB A,C", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(92, SUB_D, op_SUB_D, "SUB A,D", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(93, SUB_E, op_SUB_E, "SUB A,E", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(94, SUB_H, op_SUB_H, "SUB A,H", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(95, SUB_L, op_SUB_L, "SUB A,L", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(96, SUB_M, op_SUB_M, "SUB A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_ALL, OPK_READ) \
+	X(97, SUB_A, op_SUB_A, "SUB A,A", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(98, SBB_B, op_SBB_B, "SBB A,B", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(99, SBB_C, op_SBB_C, "SBB A,C", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(9A, SBB_D, op_SBB_D, "SBB A,D", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(9B, SBB_E, op_SBB_E, "SBB A,E", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(9C, SBB_H, op_SBB_H, "SBB A,H", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(9D, SBB_L, op_SBB_L, "SBB A,L", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(9E, SBB_M, op_SBB_M, "SBB A,M", OPFMT_NONE, 1, 7, 0, OPF_C, OPF_ALL, OPK_READ) \
+	X(9F, SBB_A, op_SBB_A, "SBB A,A", OPFMT_NONE, 1, 4, 0, OPF_C, OPF_ALL, 0) \
+	X(A0, ANA_B, op_ANA_B, "ANA A,B", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A1, ANA_C, op_ANA_C, "ANA A,C", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A2, ANA_D, op_ANA_D, "ANA A,D", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A3, ANA_E, op_ANA_E, "ANA A,E", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A4, ANA_H, op_ANA_H, "ANA A,H", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A5, ANA_L, op_ANA_L, "ANA A,L", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A6, ANA_M, op_ANA_M, "ANA A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_ALL, OPK_READ) \
+	X(A7, ANA_A, op_ANA_A, "ANA A,A", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(A8, XRA_B, op_XRA_B, "XRA A,B", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(A9, XRA_C, op_XRA_C, "XRA A,C", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(AA, XRA_D, op_XRA_D, "XRA A,D", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(AB, XRA_E, op_XRA_E, "XRA A,E", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(AC, XRA_H, op_XRA_H, "XRA A,H", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(AD, XRA_L, op_XRA_L, "XRA A,L", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(AE, XRA_M, op_XRA_M, "XRA A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, OPK_READ) \
+	X(AF, XRA_A, op_XRA_A, "XRA A,A", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B0, ORA_B, op_ORA_B, "ORA A,B", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B1, ORA_C, op_ORA_C, "ORA A,C", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B2, ORA_D, op_ORA_D, "ORA A,D", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B3, ORA_E, op_ORA_E, "ORA A,E", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B4, ORA_H, op_ORA_H, "ORA A,H", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B5, ORA_L, op_ORA_L, "ORA A,L", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B6, ORA_M, op_ORA_M, "ORA A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, OPK_READ) \
+	X(B7, ORA_A, op_ORA_A, "ORA A,A", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_S | OPF_Z | OPF_AC | OPF_P, 0) \
+	X(B8, CMP_B, op_CMP_B, "CMP A,B", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(B9, CMP_C, op_CMP_C, "CMP A,C", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(BA, CMP_D, op_CMP_D, "CMP A,D", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(BB, CMP_E, op_CMP_E, "CMP A,E", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(BC, CMP_H, op_CMP_H, "CMP A,H", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(BD, CMP_L, op_CMP_L, "CMP A,L", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(BE, CMP_M, op_CMP_M, "CMP A,M", OPFMT_NONE, 1, 7, 0, OPF_NONE, OPF_ALL, OPK_READ) \
+	X(BF, CMP_A, op_CMP_A, "CMP A,A", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_ALL, 0) \
+	X(C0, RNZ, op_RNZ, "RNZ", OPFMT_NONE, 1, 11, 5, OPF_Z, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(C1, POP_B, op_POP_B, "POP B", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, OPK_READ | OPK_STACK) \
+	X(C2, JNZ, op_JNZ, "JNZ", OPFMT_ADDRESS, 3, 10, 0, OPF_Z, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(C3, JMP, op_JMP, "JMP", OPFMT_ADDRESS, 3, 10, 0, OPF_NONE, OPF_NONE, OPK_JUMP) \
+	X(C4, CNZ, op_CNZ, "CNZ", OPFMT_ADDRESS, 3, 17, 11, OPF_Z, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(C5, PUSH_B, op_PUSH_B, "PUSH B", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_WRITE | OPK_STACK) \
+	X(C6, ADI, op_ADD_I, "ADI", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_ALL, 0) \
+	X(C7, RST_0, op_RST_0, "RST 0", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(C8, RZ, op_RZ, "RZ", OPFMT_NONE, 1, 11, 5, OPF_Z, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(C9, RET, op_RET, "RET", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(CA, JZ, op_JZ, "JZ", OPFMT_ADDRESS, 3, 10, 0, OPF_Z, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(CB, UNDOC_CB, op_unimplemented, "unknown", OPFMT_ADDRESS, 3, 10, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(CC, CZ, op_CZ, "CZ", OPFMT_ADDRESS, 3, 17, 11, OPF_Z, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(CD, CALL, op_CALL, "CALL", OPFMT_ADDRESS, 3, 17, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(CE, ACI, op_ADC_I, "ACI", OPFMT_BYTE, 2, 7, 0, OPF_C, OPF_ALL, 0) \
+	X(CF, RST_1, op_RST_1, "RST 1", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(D0, RNC, op_RNC, "RNC", OPFMT_NONE, 1, 11, 5, OPF_C, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(D1, POP_D, op_POP_D, "POP D", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, OPK_READ | OPK_STACK) \
+	X(D2, JNC, op_JNC, "JNC", OPFMT_ADDRESS, 3, 10, 0, OPF_C, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(D3, OUT, op_OUT, "OUT", OPFMT_PORT, 2, 10, 0, OPF_NONE, OPF_NONE, OPK_IO) \
+	X(D4, CNC, op_CNC, "CNC", OPFMT_ADDRESS, 3, 17, 11, OPF_C, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(D5, PUSH_D, op_PUSH_D, "PUSH D", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_WRITE | OPK_STACK) \
+	X(D6, SUI, op_SUB_I, "SUI", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_ALL, 0) \
+	X(D7, RST_2, op_RST_2, "RST 2", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(D8, RC, op_RC, "RC", OPFMT_NONE, 1, 11, 5, OPF_C, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(D9, UNDOC_D9, op_unimplemented, "unknown", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(DA, JC, op_JC, "JC", OPFMT_ADDRESS, 3, 10, 0, OPF_C, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(DB, IN, op_IN, "IN", OPFMT_PORT, 2, 10, 0, OPF_NONE, OPF_NONE, OPK_IO) \
+	X(DC, CC, op_CC, "CC", OPFMT_ADDRESS, 3, 17, 11, OPF_C, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(DD, UNDOC_DD, op_unimplemented, "unknown", OPFMT_ADDRESS, 3, 17, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(DE, SBI, op_SBB_I, "SBI", OPFMT_BYTE, 2, 7, 0, OPF_C, OPF_ALL, 0) \
+	X(DF, RST_3, op_RST_3, "RST 3", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(E0, RPO, op_RPO, "RPO", OPFMT_NONE, 1, 11, 5, OPF_P, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(E1, POP_H, op_POP_H, "POP H", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, OPK_READ | OPK_STACK) \
+	X(E2, JPO, op_JPO, "JPO", OPFMT_ADDRESS, 3, 10, 0, OPF_P, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(E3, XTHL, op_XTHL, "XTHL", OPFMT_NONE, 1, 18, 0, OPF_NONE, OPF_NONE, OPK_READ | OPK_WRITE | OPK_STACK) \
+	X(E4, CPO, op_CPO, "CPO", OPFMT_ADDRESS, 3, 17, 11, OPF_P, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(E5, PUSH_H, op_PUSH_H, "PUSH H", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_WRITE | OPK_STACK) \
+	X(E6, ANI, op_ANA_I, "ANI", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_ALL, 0) \
+	X(E7, RST_4, op_RST_4, "RST 4", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(E8, RPE, op_RPE, "RPE", OPFMT_NONE, 1, 11, 5, OPF_P, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(E9, PCHL, op_PCHL, "PCHL", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, OPK_JUMP) \
+	X(EA, JPE, op_JPE, "JPE", OPFMT_ADDRESS, 3, 10, 0, OPF_P, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(EB, XCHG, op_XCHG, "XCHG", OPFMT_NONE, 1, 5, 0, OPF_NONE, OPF_NONE, 0) \
+	X(EC, CPE, op_CPE, "CPE", OPFMT_ADDRESS, 3, 17, 11, OPF_P, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(ED, UNDOC_ED, op_unimplemented, "unknown", OPFMT_ADDRESS, 3, 17, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(EE, XRI, op_XRI, "XRI", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_ALL, 0) \
+	X(EF, RST_5, op_RST_5, "RST 5", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(F0, RP, op_RP, "RP", OPFMT_NONE, 1, 11, 5, OPF_S, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(F1, POP_PSW, op_POP_PSW, "POP PSW", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_ALL, OPK_READ | OPK_STACK) \
+	X(F2, JP, op_JP, "JP", OPFMT_ADDRESS, 3, 10, 0, OPF_S, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(F3, DI, op_DI, "DI", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_INTERRUPT) \
+	X(F4, CP, op_CP, "CP", OPFMT_ADDRESS, 3, 17, 11, OPF_S, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(F5, PUSH_PSW, op_PUSH_PSW, "PUSH PSW", OPFMT_NONE, 1, 11, 0, OPF_ALL, OPF_NONE, OPK_WRITE | OPK_STACK) \
+	X(F6, ORI, op_ORI, "ORI", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_ALL, 0) \
+	X(F7, RST_6, op_RST_6, "RST 6", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(F8, RM, op_RM, "RM", OPFMT_NONE, 1, 11, 5, OPF_S, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_RETURN | OPK_READ | OPK_STACK) \
+	X(F9, SPHL, op_SPHL, "SPHL", OPFMT_NONE, 1, 10, 0, OPF_NONE, OPF_NONE, 0) \
+	X(FA, JM, op_JM, "JM", OPFMT_ADDRESS, 3, 10, 0, OPF_S, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL) \
+	X(FB, EI, op_EI, "EI", OPFMT_NONE, 1, 4, 0, OPF_NONE, OPF_NONE, OPK_INTERRUPT) \
+	X(FC, CM, op_CM, "CM", OPFMT_ADDRESS, 3, 17, 11, OPF_S, OPF_NONE, OPK_JUMP | OPK_CONDITIONAL | OPK_CALL | OPK_WRITE | OPK_STACK) \
+	X(FD, UNDOC_FD, op_unimplemented, "unknown", OPFMT_ADDRESS, 3, 17, 0, OPF_NONE, OPF_NONE, OPK_UNDOCUMENTED) \
+	X(FE, CPI, op_CMP_I, "CPI", OPFMT_BYTE, 2, 7, 0, OPF_NONE, OPF_ALL, 0) \
+	X(FF, RST_7, op_RST_7, "RST 7", OPFMT_NONE, 1, 11, 0, OPF_NONE, OPF_NONE, OPK_JUMP | OPK_CALL | OPK_WRITE | OPK_STACK)
+
+typedef struct i8080OpcodeInfo {
+	const char* mnemonic; // "unknown" for the undocumented opcodes
+	uint8_t format; // i8080OperandFormat
+	uint8_t length;
+	uint8_t cycles;
+	uint8_t failedCycles;
+	uint8_t flagsRead;
+	uint8_t flagsWritten;
+	uint16_t kind; // OPK_ bits
+} i8080OpcodeInfo;
@@ -0,0 +1,118 @@
+/*
+
+i8080_predecode.c
+
+Predecoded ROM. Every address of the ROM the memory map write protects is decoded once into a micro-op that the core walks directly
+
+*/
+
+#include "i8080_predecode.h"
+
+#include <stdlib.h>
+
+void i8080_predecode(i8080State* state) {
+	if (state->microOps == NULL) {
+		state->microOps = malloc(i8080_ROM_SIZE * sizeof(i8080MicroOp));
+		if (state->microOps == NULL) {
+			log_fatal("Failed to allocate memory for the predecoded ROM");
+			exit(-1);
+		}
+	}
+
+	// Decode at every address, not just the instruction starts, so a jump into the middle of an instruction still hits the table
+	for (int pc = 0; pc < i8080_ROM_SIZE; pc++) {
+		i8080MicroOp* op = &state->microOps[pc];
+		op->opcode = *i8080_hostPointer(state, pc);
+		op->length = i8080_getInstructionLength(op->opcode);
+		op->cycles = i8080_getInstructionClockCycles(op->opcode);
+		op->failedCycles = i8080_getFailedInstructionClockCycles(op->opcode);
+		op->byte1 = *i8080_hostPointer(state, pc + 1);
+		op->byte2 = *i8080_hostPointer(state, pc + 2);
+
+		// Code the map does not write protect, operands included, is left to the normal decoder
+		op->handler = (pc + op->length <= i8080_ROM_SIZE && i8080_busReadOnly(state, pc, op->length)) ? i8080_opHandlers[op->opcode] : NULL;
+	}
+
+	// Pair up the instructions with the one after them, both have to be decoded
+	for (int pc = 0; pc < i8080_ROM_SIZE; pc++) {
+		i8080MicroOp* op = &state->microOps[pc];
+		op->fused = NULL;
+		if (op->handler != NULL && pc + op->length < i8080_ROM_SIZE && op[op->length].handler != NULL)
+			op->fused = i8080_findFusedHandler(op->opcode, op[op->length].opcode);
+	}
+
+	state->microOpsValid = true;
+	log_debug("Predecoded %i bytes of ROM", i8080_ROM_SIZE);
+}
+
+void i8080_invalidateMicroOps(i8080State* state) {
+	state->microOpsValid = false;
+}
+
+int i8080_runPredecoded(i8080State* state, int cycleBudget) {
+	int cyclesUsed = 0;
+
+	if (!state->microOpsValid)
+		i8080_predecode(state);
+	unsigned int interruptPeriod = state->bus->board->interruptPeriod;
+
+	while (cyclesUsed < cycleBudget) {
+		checkInterrupts(state);
+		I8080_IDLE_CHECK(state, cyclesUsed, cycleBudget);
+		I8080_HLE_CHECK(state, cyclesUsed, cycleBudget);
+		I8080_MEMO_CHECK(state, cyclesUsed, cycleBudget);
+
+		int cycles;
+		uint16_t pc = state->pc;
+		// Only code the memory map write protects is predecoded, the rest has a NULL handler
+		const i8080MicroOp* op = pc < i8080_ROM_SIZE ? &state->microOps[pc] : NULL;
+
+		// A fused pair only runs whole if the first instruction could not have reached the end of the budget or the next interrupt on its own
+		if (op != NULL && op->fused != NULL && state->core == CORE_FUSED && cyclesUsed + op->cycles < cycleBudget && state->interruptAccumulator + op->cycles < interruptPeriod) {
+			const i8080MicroOp* second = op + op->length;
+			if (state->traced) {
+				i8080_traceInstruction(state, op->opcode);
+				state->debug->opcodeUse[second->opcode]++;
+				state->debug->fusedPairs++;
+			}
+
+			state->f.rx = false;
+			state->f.tx = false;
+
+			uint8_t result = op->fused(state, op);
+			cycles = op->cycles + ((result & OPRESULT_FAILED) ? second->failedCycles : second->cycles);
+		}
+		else if (op != NULL && op->handler != NULL) {
+			if (state->traced)
+				i8080_traceInstruction(state, op->opcode);
+
+			state->f.rx = false;
+			state->f.tx = false;
+
+			uint8_t result = op->handler(state, op->opcode, op->byte1, op->byte2);
+			if (!(result & OPRESULT_JUMPED))
+				state->pc += op->length;
+			cycles = (result & OPRESULT_FAILED) ? op->failedCycles : op->cycles;
+		}
+		else {
+			// RAM, or an instruction straddling the end of the ROM
+			uint8_t byte1;
+			uint8_t byte2;
+			uint8_t opcode = i8080_fetch(state, &byte1, &byte2);
+			if (state->traced)
+				i8080_traceInstruction(state, opcode);
+
+			bool success = i8080_dispatchOpcode(state, opcode, byte1, byte2);
+			cycles = success ? i8080_getInstructionClockCycles(opcode) : i8080_getFailedInstructionClockCycles(opcode);
+		}
+
+		cyclesUsed += cycles;
+		state->cyclesExecuted += cycles;
+		state->interruptAccumulator += cycles;
+
+		if (state->mode == MODE_HLT || state->mode == MODE_PANIC)
+			break;
+	}
+
+	return cyclesUsed;
+}
@@ -0,0 +1,30 @@
+#pragma once
+/*
+
+i8080_predecode.h
+
+Predecoded ROM. Every address of the write protected ROM is decoded once into a micro-op that the core walks directly
+
+*/
+
+#include "i8080_dispatch.h"
+
+typedef struct i8080MicroOp {
+	i8080OpHandler handler; // NULL if the instruction can't be predecoded, decode it from memory instead
+	uint8_t opcode;
+	uint8_t byte1;
+	uint8_t byte2;
+	uint8_t length;
+	uint8_t cycles;
+	uint8_t failedCycles;
+	i8080FusedHandler fused; // runs this instruction and the next one together on the fused core, NULL if the pair isn't in I8080_FUSED_LIST
+} i8080MicroOp;
+
+// Decodes every address of the ROM into state->microOps, allocating it on first use
+void i8080_predecode(i8080State* state);
+
+// Marks the predecoded ROM as stale, it is decoded again on the next run. Call after loading into the ROM area
+void i8080_invalidateMicroOps(i8080State* state);
+
+// Runs instructions from the predecoded ROM, falling back to the handler table outside of it. The fused core also runs the fused pairs. Same contract as i8080_run, but does not drain waitCycles
+int i8080_runPredecoded(i8080State* state, int cycleBudget);
@@ -0,0 +1,300 @@
+/*
+
+i8080_system.c
+
+Several processors on one memory bus, each run on a host thread of its own and synchronised every quantum
+
+*/
+
+#include "i8080_system.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+I8080_THREAD_LOCAL i8080SystemCpu* i8080_systemCpu = NULL;
+
+// Taken by log.c over each line it writes while the processor threads run
+static volatile long systemLogLock = 0;
+
+static void systemLockLog(void* udata, int lock) {
+	if (lock) {
+		while (!i8080_atomicSwap(&systemLogLock, 0, 1))
+			i8080_threadYield();
+	}
+	else {
+		i8080_atomicStore(&systemLogLock, 0);
+	}
+}
+
+// The processor of the system running the state on this thread, NULL when the state is not being run by its system
+I8080_INLINE i8080SystemCpu* systemRunning(i8080State* state) {
+	i8080SystemCpu* cpu = i8080_systemCpu;
+	return cpu != NULL && cpu->state == state ? cpu : NULL;
+}
+
+// Reads of a page with contended bytes: the processor sees its own held writes over the shared memory
+static uint8_t systemRead(i8080State* state, uint16_t address) {
+	i8080SystemCpu* cpu = systemRunning(state);
+	int region = cpu == NULL ? 0 : cpu->system->regionMap[address];
+	if (region != 0) {
+		int byte = cpu->system->regions[region - 1].offset + address - cpu->system->regions[region - 1].start;
+		if (cpu->heldSet[byte])
+			return cpu->heldValues[byte];
+	}
+	return state->memory[address];
+}
+
+// Writes to a page with contended bytes: those of a running processor are held back to the end of the quantum, the
+// lowest numbered writer taking the region, and the rest of the page is written straight away
+static void systemWrite(i8080State* state, uint16_t address, uint8_t value) {
+	i8080SystemCpu* cpu = systemRunning(state);
+	int index = cpu == NULL ? 0 : cpu->system->regionMap[address];
+	if (index == 0) {
+		state->memory[address] = value;
+		return;
+	}
+
+	i8080SystemRegion* region = &cpu->system->regions[index - 1];
+	long owner = i8080_atomicLoad(&region->owner);
+	while ((owner == SYSTEM_NO_OWNER || owner > cpu->index) && !i8080_atomicSwap(&region->owner, owner, cpu->index))
+		owner = i8080_atomicLoad(&region->owner);
+
+	int byte = region->offset + address - region->start;
+	if (!cpu->heldSet[byte]) {
+		cpu->heldSet[byte] = true;
+		cpu->heldAddresses[cpu->heldCount++] = address;
+	}
+	cpu->heldValues[byte] = value;
+	cpu->heldWrites++;
+}
+
+// Builds the memory map of the processors over the shared memory, with the handlers on the pages holding contended bytes,
+// and maps every processor through it
+static void systemMap(i8080System* system) {
+	system->map.name = "system";
+	system->map.regions = system->busRegions;
+	system->map.regionCount = 0;
+	for (int page = 0; page < BUS_PAGES; page++) {
+		bool contended = false;
+		for (int i = 0; i < system->regionCount; i++) {
+			contended = contended || (system->regions[i].start >> 8 <= page && system->regions[i].end >> 8 >= page);
+		}
+
+		// Runs of pages alike share a region of the map
+		i8080BusRegion* last = system->map.regionCount == 0 ? NULL : &system->busRegions[system->map.regionCount - 1];
+		if (last != NULL && (last->onRead != NULL) == contended) {
+			last->length += BUS_PAGE_SIZE;
+			continue;
+		}
+		i8080BusRegion* region = &system->busRegions[system->map.regionCount++];
+		region->start = page * BUS_PAGE_SIZE;
+		region->length = BUS_PAGE_SIZE;
+		region->target = page * BUS_PAGE_SIZE;
+		region->window = 0;
+		region->onRead = contended ? systemRead : NULL;
+		region->onWrite = contended ? systemWrite : NULL;
+	}
+
+	for (int i = 0; i < system->cpuCount; i++) {
+		i8080_busMap(system->cpus[i].state, &system->map);
+	}
+}
+
+i8080System* i8080_systemCreate(int cpuCount, int quantum) {
+	if (cpuCount < 1 || cpuCount > SYSTEM_MAX_CPUS || quantum < 1) {
+		log_error("A system takes 1 to %d processors and a quantum of at least 1 cycle, not %d and %d", SYSTEM_MAX_CPUS, cpuCount, quantum);
+		return NULL;
+	}
+
+#if defined(_MSC_VER)
+	i8080System* system = _aligned_malloc(sizeof(i8080System), I8080_CACHE_LINE);
+#else
+	i8080System* system = aligned_alloc(I8080_CACHE_LINE, sizeof(i8080System));
+#endif
+	uint8_t* memory = calloc(i8080_MEMORY_SIZE, sizeof(uint8_t));
+	if (system == NULL || memory == NULL) {
+		log_fatal("Failed to allocate space for an i8080 system");
+		exit(-1);
+	}
+	memset(system, 0, sizeof(i8080System));
+	system->cpuCount = cpuCount;
+	system->quantum = quantum;
+	system->memory = memory;
+
+	for (int i = 0; i < cpuCount; i++) {
+		i8080SystemCpu* cpu = &system->cpus[i];
+		cpu->system = system;
+		cpu->index = i;
+		cpu->state = i8080_createState();
+		free(cpu->state->memory);
+		cpu->state->memory = memory;
+		cpu->state->mode = MODE_TEST;
+		i8080_boardAttach(cpu->state, &i8080_bareBoard);
+	}
+	systemMap(system);
+	return system;
+}
+
+void i8080_systemDestroy(i8080System* system) {
+	for (int i = 0; i < system->cpuCount; i++) {
+		// The memory is the system's, not the state's
+		system->cpus[i].state->memory = NULL;
+		i8080_destroyState(system->cpus[i].state);
+		free(system->cpus[i].heldAddresses);
+		free(system->cpus[i].heldValues);
+		free(system->cpus[i].heldSet);
+	}
+	free(system->memory);
+#if defined(_MSC_VER)
+	_aligned_free(system);
+#else
+	free(system);
+#endif
+}
+
+bool i8080_systemAddRegion(i8080System* system, uint16_t start, int length) {
+	if (system->regionCount >= SYSTEM_MAX_REGIONS || length < 1 || start + length > 0x10000) {
+		log_error("Contended region of %d bytes at %04X does not fit the system", length, start);
+		return false;
+	}
+	for (int address = start; address < start + length; address++) {
+		if (system->regionMap[address] != 0) {
+			log_error("Contended region at %04X overlaps another at %04X", start, address);
+			return false;
+		}
+	}
+
+	i8080SystemRegion* region = &system->regions[system->regionCount++];
+	region->start = start;
+	region->end = start + length - 1;
+	region->offset = system->contendedBytes;
+	region->owner = SYSTEM_NO_OWNER;
+	region->claims = 0;
+	memset(system->regionMap + start, system->regionCount, length);
+	system->contendedBytes += length;
+
+	// Room for a held write to every contended byte
+	for (int i = 0; i < system->cpuCount; i++) {
+		i8080SystemCpu* cpu = &system->cpus[i];
+		free(cpu->heldAddresses);
+		free(cpu->heldValues);
+		free(cpu->heldSet);
+		cpu->heldAddresses = malloc(system->contendedBytes * sizeof(uint16_t));
+		cpu->heldValues = malloc(system->contendedBytes * sizeof(uint8_t));
+		cpu->heldSet = calloc(system->contendedBytes, sizeof(bool));
+		if (cpu->heldAddresses == NULL || cpu->heldValues == NULL || cpu->heldSet == NULL) {
+			log_fatal("Failed to allocate the held writes of processor %d", i);
+			exit(-1);
+		}
+		cpu->heldCount = 0;
+	}
+	systemMap(system);
+	return true;
+}
+
+// The end of a quantum, from the last processor to reach it while every other one waits: makes the held writes in
+// processor order, the owner of each region last, and frees the regions
+static void systemEndQuantum(i8080System* system) {
+	for (int pass = 0; pass < 2; pass++) {
+		for (int i = 0; i < system->cpuCount; i++) {
+			i8080SystemCpu* cpu = &system->cpus[i];
+			for (int j = 0; j < cpu->heldCount; j++) {
+				uint16_t address = cpu->heldAddresses[j];
+				const i8080SystemRegion* region = &system->regions[system->regionMap[address] - 1];
+				if ((region->owner == cpu->index) == (pass == 1))
+					system->memory[address] = cpu->heldValues[region->offset + address - region->start];
+			}
+		}
+	}
+	for (int i = 0; i < system->cpuCount; i++) {
+		i8080SystemCpu* cpu = &system->cpus[i];
+		for (int j = 0; j < cpu->heldCount; j++) {
+			uint16_t address = cpu->heldAddresses[j];
+			const i8080SystemRegion* region = &system->regions[system->regionMap[address] - 1];
+			cpu->heldSet[region->offset + address - region->start] = false;
+		}
+		cpu->heldCount = 0;
+	}
+	for (int i = 0; i < system->regionCount; i++) {
+		if (system->regions[i].owner != SYSTEM_NO_OWNER)
+			system->regions[i].claims++;
+		i8080_atomicStore(&system->regions[i].owner, SYSTEM_NO_OWNER);
+	}
+	system->time += system->quantum;
+}
+
+// Waits for every processor to reach the end of the quantum
+static void systemSynchronise(i8080System* system) {
+	long generation = i8080_atomicLoad(&system->generation);
+	if (i8080_atomicIncrement(&system->arrived) == system->cpuCount) {
+		systemEndQuantum(system);
+		i8080_atomicStore(&system->arrived, 0);
+		i8080_atomicStore(&system->generation, generation + 1);
+	}
+	else {
+		while (i8080_atomicLoad(&system->generation) == generation)
+			i8080_threadYield();
+	}
+}
+
+static I8080_THREAD_PROC(systemThread, arg) {
+	i8080SystemCpu* cpu = arg;
+	i8080System* system = cpu->system;
+
+	i8080_systemCpu = cpu;
+
+	for (int quantum = 0; quantum < system->quantaLeft; quantum++) {
+		// Up to the end of the quantum, so the cycles an instruction runs past one come off the next
+		unsigned long end = system->time + system->quantum;
+		if (cpu->cycles < end)
+			cpu->cycles += i8080_run(cpu->state, (int)(end - cpu->cycles));
+		systemSynchronise(system);
+	}
+
+	i8080_systemCpu = NULL;
+	return I8080_THREAD_END;
+}
+
+unsigned long i8080_systemRun(i8080System* system, int quanta) {
+	unsigned long cyclesBefore = 0;
+	for (int i = 0; i < system->cpuCount; i++) {
+		i8080State* state = system->cpus[i].state;
+		if (state->core != CORE_SWITCH && state->core != CORE_TABLE && state->core != CORE_THREADED) {
+			// The other cores keep code decoded from memory the other processors could write behind their back
+			log_warn("Processor %d of a system can not run on the %s core, running it on the switch core", i, getCoreStr(state->core));
+			state->core = CORE_SWITCH;
+		}
+		state->idle.enabled = false;
+		state->hle = HLE_OFF;
+		state->memo = MEMO_OFF;
+		cyclesBefore += system->cpus[i].cycles;
+	}
+
+	system->quantaLeft = quanta;
+	system->arrived = 0;
+	log_set_lock(systemLockLog);
+	int started = 0;
+	for (; started < system->cpuCount; started++) {
+		if (!i8080_threadStart(&system->cpus[started].thread, systemThread, &system->cpus[started]))
+			break;
+	}
+	if (started < system->cpuCount) {
+		// The started threads would wait at the end of their first quantum for good
+		log_fatal("Failed to start a host thread for processor %d of %d", started, system->cpuCount);
+		exit(-1);
+	}
+	for (int i = 0; i < system->cpuCount; i++) {
+		i8080_threadJoin(system->cpus[i].thread);
+	}
+	log_set_lock(NULL);
+
+	unsigned long cycles = 0;
+	for (int i = 0; i < system->cpuCount; i++) {
+		cycles += system->cpus[i].cycles;
+	}
+	return cycles - cyclesBefore;
+}
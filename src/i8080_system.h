@@ -0,0 +1,95 @@
+#pragma once
+/*
+
+i8080_system.h
+
+Several processors on one memory bus. A system holds up to SYSTEM_MAX_CPUS states over one shared memory, each with its
+own registers, ports and interrupt timing, and runs each on a host thread of its own. The processors run in quanta of
+system->quantum cycles and wait for each other at the end of every one, so none gets more than a quantum ahead.
+
+Writes go straight to the shared memory, except in the contended regions. Every write to one is held back in a buffer of
+the processor that made it until every processor reaches the end of the quantum, and that processor's own reads and fetches
+see its held writes first, so a store and a load, or a PUSH and a RET, in a region agree. The others see the region as it
+was at the start of the quantum, so what a processor reads there does not depend on how the host threads are scheduled.
+The lowest numbered processor to write a region in a quantum owns it, taken with a compare and swap loop and no lock. At
+the end of the quantum the held writes are made in processor order, the owner of each region last so its writes stand,
+and the regions are freed. The system pages with contended bytes are given read and write handlers on the bus of each
+processor, the other pages are plain memory.
+
+The processors run on the switch, table or threaded core without the idle loop skip, HLE or memoisation, which all assume
+nobody else writes the memory they read
+
+*/
+
+#include "i8080.h"
+#include "i8080_thread.h"
+
+// Processors a system can hold
+#define SYSTEM_MAX_CPUS 16
+// Contended regions a system can hold
+#define SYSTEM_MAX_REGIONS 8
+// Owner of a free region
+#define SYSTEM_NO_OWNER -1
+
+typedef struct i8080SystemRegion {
+	uint16_t start;
+	uint16_t end; // last address in the region
+	int offset; // of its first byte among the contended bytes of the system, which index the held writes
+	volatile long owner; // lowest index of the processors that wrote it this quantum, SYSTEM_NO_OWNER while free
+	unsigned long claims; // quanta it was written in, counted at the end of each
+} i8080SystemRegion;
+
+// One processor, on a cache line of its own so the threads do not share lines for their counters
+typedef struct I8080_CACHE_ALIGNED i8080SystemCpu {
+	struct i8080System* system;
+	int index;
+	i8080State* state; // its memory is the system memory
+	i8080Thread thread;
+	// Writes to the contended regions held back to the end of the quantum, by contended byte. A write to a byte already held
+	// replaces its value, so there is room for every byte the regions have
+	int heldCount;
+	uint16_t* heldAddresses; // the bytes written this quantum, in the order first written
+	uint8_t* heldValues; // the last value written to each
+	bool* heldSet; // whether each has been written this quantum
+	// Counters, never cleared
+	unsigned long cycles; // run since the system was created
+	unsigned long heldWrites; // writes held back for the end of a quantum
+} i8080SystemCpu;
+
+typedef struct i8080System {
+	int cpuCount;
+	int quantum; // cycles each processor runs between synchronisations
+	uint8_t* memory; // i8080_MEMORY_SIZE bytes shared by every processor
+	int regionCount;
+	int contendedBytes; // in every region together
+	i8080SystemRegion regions[SYSTEM_MAX_REGIONS];
+	uint8_t regionMap[0x10000]; // 1 + the index of the region each address is in, 0 outside them
+	// The memory map of the processors: the shared memory, with handlers on the pages the regions are on
+	i8080MemoryMap map;
+	i8080BusRegion busRegions[BUS_PAGES];
+	// Synchronisation
+	int quantaLeft; // quanta the threads run in the current i8080_systemRun
+	unsigned long time; // cycle count every processor runs up to in the current quantum
+	volatile long arrived; // processors at the end of the current quantum
+	volatile long generation; // quanta completed, the processors waiting at the end of one watch it move on
+	i8080SystemCpu cpus[SYSTEM_MAX_CPUS];
+} i8080System;
+
+// The processor the host thread is running, NULL outside i8080_systemRun
+extern I8080_THREAD_LOCAL i8080SystemCpu* i8080_systemCpu;
+
+// Makes a system of cpuCount processors over zeroed shared memory, each reset with init8080 in test mode on the bare board with
+// its pc at 0, mapped through the system map.
+// Returns NULL if cpuCount is out of range
+i8080System* i8080_systemCreate(int cpuCount, int quantum);
+
+// Frees the system, its processors and its memory
+void i8080_systemDestroy(i8080System* system);
+
+// Marks length bytes from start as a contended region and maps the processors again. Returns false if the system has no
+// regions left or the bytes overlap another region
+bool i8080_systemAddRegion(i8080System* system, uint16_t start, int length);
+
+// Runs every processor for quanta quanta, each on its own host thread, and returns once they all finish. Returns the
+// cycles run over every processor
+unsigned long i8080_systemRun(i8080System* system, int quanta);
@@ -19,6 +19,7 @@ void i8080_testProtocol(i8080State* state) {
 	init8080(state);
 
 	state->mode = MODE_TEST; // Set us to test mode
+	i8080_busMap(state, &i8080_flatMap);
 
 	sfClock* timer = sfClock_create();
 	fprintf(testLog, "i8080 Test protocol.\n");
@@ -45,853 +46,2230 @@ void i8080_testProtocol(i8080State* state) {
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test i8080_isParityEven(0xFE)=%i\t\t\t\t: [%s]\n", i8080_isParityEven(0xFE), success ? "OK" : "FAIL");
 
+	success = i8080_isParityEven(0x0101) && !i8080_isParityEven(0x0100);
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test i8080_isParityEven(0x0101, 0x0100)\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	success = true;
+	for (int v = 0; v < 0x100; v++) {
+		int oneBits = 0;
+		for (int i = 0; i < 8; i++)
+			oneBits += (v >> i) & 1;
+		uint8_t expected = (i8080_isNegative(v) ? FLAG_S : 0) | (i8080_isZero(v) ? FLAG_Z : 0) | (v != 0 && oneBits % 2 == 0 ? FLAG_P : 0);
+		if (i8080_zspTable[v] != expected)
+			success = false;
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test i8080_zspTable\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	state->b = 0x12; state->c = 0x34; state->d = 0x56; state->e = 0x78; state->h = 0x9A; state->l = 0xBC;
+	success = state->bc == 0x1234 && state->de == 0x5678 && state->hl == 0x9ABC && i8080op_getHL(state) == 0x9ABC;
+	state->hl = 0xDEF0;
+	success = success && state->h == 0xDE && state->l == 0xF0;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test register pair layout\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// The fetch has to see the same bytes as a memory read, across the end of a page and through the 0xFFFF wrap
+	uint16_t pc = state->pc;
+	uint8_t byte1, byte2;
+	i8080op_writeMemory(state, 0x00FE, LXI_B); i8080op_writeMemory(state, 0x00FF, 0x34); i8080op_writeMemory(state, 0x0100, 0x12);
+	state->pc = 0x00FE;
+	success = i8080_fetch(state, &byte1, &byte2) == LXI_B && byte1 == 0x34 && byte2 == 0x12;
+	i8080op_writeMemory(state, 0xFFFF, MVI_A); i8080op_writeMemory(state, 0x0000, 0x42);
+	state->pc = 0xFFFF;
+	success = success && i8080_fetch(state, &byte1, &byte2) == MVI_A && byte1 == 0x42 && byte2 == 0x00;
+	state->pc = 0x00FF;
+	success = success && i8080_fetch(state, &byte1, &byte2) == 0x34 && byte1 == 0x00 && byte2 == 0x00;
+	state->pc = pc;
+	for (int map = 0; map < 2; map++) {
+		i8080_busMap(state, map ? &i8080_flatMap : &i8080_invadersMap);
+		for (int address = 0; address < 0x10000; address++) {
+			if (*i8080_hostPointer(state, address) != i8080op_readMemory(state, address))
+				success = false;
+		}
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test i8080_fetch\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// The hot fields share the first cache line of a state on a line of its own, plugged into the invaders board
+	i8080State* aligned = i8080_createState();
+	success = (size_t)aligned % I8080_CACHE_LINE == 0 && offsetof(i8080State, cyclesExecuted) + sizeof(aligned->cyclesExecuted) <= I8080_CACHE_LINE
+		&& aligned->debug != NULL && aligned->bus->board == &i8080_invadersBoard && aligned->debug->vid.width == 256 && aligned->inPorts[2] == 0x80;
+	i8080_destroyState(aligned);
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test i8080_createState\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
 	i8080op_addCarry16(state, 0xFFFF, 0x0001);
-	success = state->f.c;
+	success = GET_FLAG(state, FLAG_C);
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test i8080op_addCarry16(0xFFFF, 0x01)=%i\t\t: [%s]\n", i8080op_addCarry16(state, 0xFFFF, 0x0001), success ? "OK" : "FAIL");
 
 	i8080op_subCarry16(state, 0x02, 0x03);
-	success = state->f.c;
+	success = GET_FLAG(state, FLAG_C);
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test i8080op_subCarry16(0x02, 0x03)=%i\t: [%s]\n", i8080op_subCarry16(state, 0x02, 0x03), success ? "OK" : "FAIL");
 
 	i8080op_addCarry8(state, 0xFF, 0x1);
-	success = state->f.c;
+	success = GET_FLAG(state, FLAG_C);
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test i8080op_addCarry8(0xFF, 0x01)=%i\t\t: [%s]\n", i8080op_addCarry8(state, 0xFF, 0x1), success ? "OK" : "FAIL");
 
 	i8080op_subCarry8(state, 0x02, 0x03);
-	success = state->f.c;
+	success = GET_FLAG(state, FLAG_C);
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test i8080op_subCarry8(0x02, 0x03)=%i\t\t: [%s]\n", i8080op_subCarry8(state, 0x02, 0x03), success ? "OK" : "FAIL");
 
-	fprintf(testLog, "\n--- instruction tests ---\n");
+	// Run the instruction tests against every core, then check the cores against each other. The JIT compiles every block straight away so the tests reach the native code
+	int hotThreshold = jit_hotThreshold;
+	jit_hotThreshold = 0;
+	for (int core = 0; core < CORE_COUNT; core++) {
+		state->core = core;
+		fprintf(testLog, "\n--- instruction tests (core %s) ---\n", getCoreStr(core));
+		failedTests += utilTest_instructions(state, testLog);
+	}
+	state->core = CORE_SWITCH;
+	state->traced = true;
+	fprintf(testLog, "\n--- instruction tests (core switch, traced) ---\n");
+	failedTests += utilTest_instructions(state, testLog);
+
+	// Only the traced cores keep the opcode use table and instruction trace
+	unsigned int inrUse = state->debug->opcodeUse[INR_B];
+	utilTest_prepNext(state, INR_B, 0x00, 0x00);
+	i8080_run(state, 1);
+	success = state->debug->opcodeUse[INR_B] == inrUse + 1 && state->debug->previousInstructions[0].opcode == INR_B;
+	state->traced = false;
+	unsigned int dcrUse = state->debug->opcodeUse[DCR_B];
+	utilTest_prepNext(state, DCR_B, 0x00, 0x00);
+	i8080_run(state, 1);
+	success = success && state->debug->opcodeUse[DCR_B] == dcrUse && state->debug->previousInstructions[0].opcode == INR_B;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test lean core skips the trace\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	failedTests += utilTest_opcodeList(state, testLog);
+
+	fprintf(testLog, "\n--- core equivalence tests ---\n");
+	for (int core = CORE_SWITCH + 1; core < CORE_COUNT; core++) {
+		failedTests += utilTest_coreEquivalence(state, testLog, core);
+	}
+	jit_hotThreshold = hotThreshold;
+	failedTests += utilTest_wideCore(state, testLog);
+	failedTests += utilTest_fusedPairs(state, testLog);
+	failedTests += utilTest_idleLoop(state, testLog);
+	failedTests += utilTest_haltSleep(state, testLog);
+	failedTests += utilTest_timing(state, testLog);
+	failedTests += utilTest_hle(state, testLog);
+	failedTests += utilTest_memo(state, testLog);
+	failedTests += utilTest_aot(state, testLog);
+	failedTests += utilTest_system(state, testLog);
+	failedTests += utilTest_bus(state, testLog);
+	failedTests += utilTest_board(state, testLog);
+	failedTests += utilTest_aluTables(state, testLog);
+
+	// Output statistics
+	float elapsedTimeMs = sfTime_asMilliseconds(sfClock_getElapsedTime(timer));
+	float elapsedTimeSec = elapsedTimeMs / 1000.0f;
+	fprintf(testLog, "--------------------------------------------------\nTest complete!\nTime to complete test: %f seconds\nTests failed: %i\n", elapsedTimeSec, failedTests);
+
+	// cloe test file
+	fclose(testLog);
+}
+
+int utilTest_instructions(i8080State* state, FILE* testLog) {
+	bool success = false;
+	int failedTests = 0;
 
 	utilTest_prepNext(state, LXI_B, 0x0F, 0xF0); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->c == 0x0F && state->b == 0xF0; // Check success conditions
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LXI_B\t(%02X)\t\t: [%s]\n", LXI_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, STAX_B, 0x00, 0x00); state->a = 128; i8080op_putBC16(state, 0xF00F); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_readMemory(state, 0xF00F) == 128;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test STAX_B\t(%02X)\t\t: [%s]\n", STAX_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INX_B, 0x00, 0x00); i8080op_putBC16(state, 0x2); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getBC(state) == 0x3;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INX_B\t(%02X)\t\t: [%s]\n", INX_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_B, 0x00, 0x00); state->b = 255; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->b == 0x00 && state->f.z == 1 && state->f.s == 0 && state->f.p == 0 && state->f.ac == 1;
+	i8080_run(state, 1); // Execute command
+	success = state->b == 0x00 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_S) == 0 && GET_FLAG(state, FLAG_P) == 0 && GET_FLAG(state, FLAG_AC) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_B\t(%02X)\t\t: [%s]\n", INR_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_B, 0x00, 0x00); state->b = 0x0; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->b == 0xFF && state->f.z == 0 && state->f.s == 1 && state->f.p == 1 && state->f.ac == 0;
-	//log_debug("b:%i z:%i s:%i p:%i ac:%i", state->b, state->f.z, state->f.s, state->f.p, state->f.ac);
+	i8080_run(state, 1); // Execute command
+	success = state->b == 0xFF && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_S) == 1 && GET_FLAG(state, FLAG_P) == 1 && GET_FLAG(state, FLAG_AC) == 0;
+	//log_debug("b:%i z:%i s:%i p:%i ac:%i", state->b, GET_FLAG(state, FLAG_Z), GET_FLAG(state, FLAG_S), GET_FLAG(state, FLAG_P), GET_FLAG(state, FLAG_AC));
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_B\t(%02X)\t\t: [%s]\n", DCR_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_B, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->b == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_B\t(%02X)\t\t: [%s]\n", MVI_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, RLC, 0x00, 0x00); state->a = 0xF0; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->a == 0xE1 && state->f.c == 1;
+	i8080_run(state, 1); // Execute command
+	success = state->a == 0xE1 && GET_FLAG(state, FLAG_C) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test RLC\t(%02X)\t\t: [%s]\n", RLC, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DAD_B, 0x00, 0x00); i8080op_putBC16(state, 0x1); i8080op_putHL16(state, 0xFFFF); // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = i8080op_getHL(state) == 0x0 && state->f.c == 1;
+	i8080_run(state, 1); // Execute command
+	success = i8080op_getHL(state) == 0x0 && GET_FLAG(state, FLAG_C) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DAD_B\t(%02X)\t\t: [%s]\n", DAD_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LDAX_B, LDAX_B, 0x00); i8080op_putBC16(state, 0x1); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == LDAX_B;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LDAX_B\t(%02X)\t\t: [%s]\n", LDAX_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCX_B, 0x00, 0x00); i8080op_putBC16(state, 0x1); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getBC(state) == 0x00;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCX_B\t(%02X)\t\t: [%s]\n", DCX_B, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_C, 0x00, 0x00); state->c = 0x1; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->c == 0x02 && state->f.z == 0 && state->f.s == 0 && state->f.p == 0 && state->f.ac == 0;
+	i8080_run(state, 1); // Execute command
+	success = state->c == 0x02 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_S) == 0 && GET_FLAG(state, FLAG_P) == 0 && GET_FLAG(state, FLAG_AC) == 0;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_C\t(%02X)\t\t: [%s]\n", INR_C, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_C, 0x00, 0x00); state->c = 0x2; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->c == 0x01;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_C\t(%02X)\t\t: [%s]\n", DCR_C, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_C, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->c == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_C\t(%02X)\t\t: [%s]\n", MVI_C, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, RRC, 0x00, 0x00); state->a = 0x01; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->a == 0x80 && state->f.c == 1;
+	i8080_run(state, 1); // Execute command
+	success = state->a == 0x80 && GET_FLAG(state, FLAG_C) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test RRC\t(%02X)\t\t: [%s]\n", RRC, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LXI_D, 0x0F, 0xF0); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->e == 0x0F && state->d == 0xF0; // Check success conditions
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LXI_D\t(%02X)\t\t: [%s]\n", LXI_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, STAX_D, 0x00, 0x00); state->a = 128; i8080op_putBC16(state, 0xF00F); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_readMemory(state, 0xF00F) == 128;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test STAX_D\t(%02X)\t\t: [%s]\n", STAX_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INX_D, 0x00, 0x00); i8080op_putDE16(state, 0xF0); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getDE(state) == 0xF1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INX_D\t(%02X)\t\t: [%s]\n", INX_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_D, 0x00, 0x00); state->d = 255; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->d == 0x00 && state->f.z == 1 && state->f.s == 0 && state->f.p == 0 && state->f.ac == 1;
+	i8080_run(state, 1); // Execute command
+	success = state->d == 0x00 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_S) == 0 && GET_FLAG(state, FLAG_P) == 0 && GET_FLAG(state, FLAG_AC) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_D\t(%02X)\t\t: [%s]\n", INR_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_D, 0x00, 0x00); state->d = 0x0; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->d == 0xFF && state->f.z == 0 && state->f.s == 1 && state->f.p == 1 && state->f.ac == 0;
-	//log_debug("d:%i z:%i s:%i p:%i ac:%i", state->d, state->f.z, state->f.s, state->f.p, state->f.ac);
+	i8080_run(state, 1); // Execute command
+	success = state->d == 0xFF && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_S) == 1 && GET_FLAG(state, FLAG_P) == 1 && GET_FLAG(state, FLAG_AC) == 0;
+	//log_debug("d:%i z:%i s:%i p:%i ac:%i", state->d, GET_FLAG(state, FLAG_Z), GET_FLAG(state, FLAG_S), GET_FLAG(state, FLAG_P), GET_FLAG(state, FLAG_AC));
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_D\t(%02X)\t\t: [%s]\n", DCR_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_D, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->d == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_D\t(%02X)\t\t: [%s]\n", MVI_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, RAL, 0x00, 0x00); state->a = 0x40; state->f.c = 1;// Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->a == 0x81 && state->f.c == 0;
+	utilTest_prepNext(state, RAL, 0x00, 0x00); state->a = 0x40; SET_FLAG(state, FLAG_C, 1);// Setup the command
+	i8080_run(state, 1); // Execute command
+	success = state->a == 0x81 && GET_FLAG(state, FLAG_C) == 0;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test RAL\t(%02X)\t\t: [%s]\n", RAL, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DAD_D, 0x00, 0x00); i8080op_putDE16(state, 0x1); i8080op_putHL16(state, 0xFFFF); // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = i8080op_getHL(state) == 0x0 && state->f.c == 1;
+	i8080_run(state, 1); // Execute command
+	success = i8080op_getHL(state) == 0x0 && GET_FLAG(state, FLAG_C) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DAD_D\t(%02X)\t\t: [%s]\n", DAD_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LDAX_D, LDAX_D, 0x00); i8080op_putDE16(state, 0x1); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == LDAX_D;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LDAX_D\t(%02X)\t\t: [%s]\n", LDAX_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCX_D, 0x00, 0x00); i8080op_putDE16(state, 0x1); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getDE(state) == 0x00;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCX_D\t(%02X)\t\t: [%s]\n", DCX_D, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_E, 0x00, 0x00); state->e = 0x1; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->e == 0x02;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_E\t(%02X)\t\t: [%s]\n", INR_E, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_E, 0x00, 0x00); state->e = 0x2; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->e == 0x01;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_E\t(%02X)\t\t: [%s]\n", DCR_E, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_E, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->e == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_E\t(%02X)\t\t: [%s]\n", MVI_E, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, RAR, 0x00, 0x00); state->a = 0x81; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->a == 0xC0 && state->f.c == 1;
+	i8080_run(state, 1); // Execute command
+	success = state->a == 0xC0 && GET_FLAG(state, FLAG_C) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test RAR\t(%02X)\t\t: [%s]\n", RAR, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LXI_H, 0x0F, 0xF0); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->l == 0x0F && state->h == 0xF0; // Check success conditions
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LXI_B\t(%02X)\t\t: [%s]\n", LXI_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, SHLD, 0xFF, 0x00); i8080op_putHL16(state, 0xFFEE); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_readMemory(state, 0x00FF) == 0xEE && i8080op_readMemory(state, 0x0100) == 0xFF;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test SHLD\t(%02X)\t\t: [%s]\n", SHLD, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INX_H, 0x00, 0x00); i8080op_putHL16(state, 0x2); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getHL(state) == 0x3;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INX_H\t(%02X)\t\t: [%s]\n", INX_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_H, 0x00, 0x00); state->h = 255; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->h == 0x00 && state->f.z == 1 && state->f.s == 0 && state->f.p == 0 && state->f.ac == 1;
+	i8080_run(state, 1); // Execute command
+	success = state->h == 0x00 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_S) == 0 && GET_FLAG(state, FLAG_P) == 0 && GET_FLAG(state, FLAG_AC) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_H\t(%02X)\t\t: [%s]\n", INR_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_H, 0x00, 0x00); state->h = 0x0; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->h == 0xFF && state->f.z == 0 && state->f.s == 1 && state->f.p == 1 && state->f.ac == 0;
-	//log_debug("b:%i z:%i s:%i p:%i ac:%i", state->b, state->f.z, state->f.s, state->f.p, state->f.ac);
+	i8080_run(state, 1); // Execute command
+	success = state->h == 0xFF && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_S) == 1 && GET_FLAG(state, FLAG_P) == 1 && GET_FLAG(state, FLAG_AC) == 0;
+	//log_debug("b:%i z:%i s:%i p:%i ac:%i", state->b, GET_FLAG(state, FLAG_Z), GET_FLAG(state, FLAG_S), GET_FLAG(state, FLAG_P), GET_FLAG(state, FLAG_AC));
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_H\t(%02X)\t\t: [%s]\n", DCR_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_H, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->h == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_H\t(%02X)\t\t: [%s]\n", MVI_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DAD_H, 0x00, 0x00); i8080op_putHL16(state, 0x1); // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = i8080op_getHL(state) == 0x2 && state->f.c == 0;
+	i8080_run(state, 1); // Execute command
+	success = i8080op_getHL(state) == 0x2 && GET_FLAG(state, FLAG_C) == 0;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DAD_H\t(%02X)\t\t: [%s]\n", DAD_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LHLD, 0xFF, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getHL(state) == 0xFFEE;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LHLD\t(%02X)\t\t: [%s]\n", LHLD, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCX_H, 0x00, 0x00); i8080op_putHL16(state, 0x1); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_getHL(state) == 0x00;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCX_H\t(%02X)\t\t: [%s]\n", DCX_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_L, 0x00, 0x00); state->l = 0x1; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->l == 0x02;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_L\t(%02X)\t\t: [%s]\n", INR_L, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_L, 0x00, 0x00); state->l = 0x2; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->l == 0x01;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_L\t(%02X)\t\t: [%s]\n", DCR_L, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_L, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->l == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_L\t(%02X)\t\t: [%s]\n", MVI_L, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, CMA, 0x00, 0x00); state->a = 0xFF; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == 0x00;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMA\t(%02X)\t\t: [%s]\n", CMA, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LXI_SP, 0x01, 0x24); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->sp == 0x2401; // Check success conditions
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LXI_SP\t(%02X)\t\t: [%s]\n", LXI_H, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, STA, 0xFF, 0x00); state->a = 0x42; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_readMemory(state, 0x00FF) == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test STA\t(%02X)\t\t: [%s]\n", STA, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INX_SP, 0x00, 0x00); state->sp = 0x2401; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->sp == 0x2402; // Check success conditions
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INX_SP\t(%02X)\t\t: [%s]\n", INX_SP, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_M, 0x00, 0x00); i8080op_writeMemory(state, 0x00FF, 0xFF); i8080op_putHL16(state, 0x00FF); // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = i8080op_readMemory(state, 0x00FF) == 0x00 && state->f.z == 1 && state->f.s == 0 && state->f.p == 0 && state->f.ac == 1;
+	i8080_run(state, 1); // Execute command
+	success = i8080op_readMemory(state, 0x00FF) == 0x00 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_S) == 0 && GET_FLAG(state, FLAG_P) == 0 && GET_FLAG(state, FLAG_AC) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_M\t(%02X)\t\t: [%s]\n", INR_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_M, 0x00, 0x00); i8080op_writeMemory(state, 0x00FF, 0x00); i8080op_putHL16(state, 0x00FF); // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = i8080op_readMemory(state, 0x00FF) == 0xFF && state->f.z == 0 && state->f.s == 1 && state->f.p == 1 && state->f.ac == 0;
-	//log_debug("b:%i z:%i s:%i p:%i ac:%i", state->b, state->f.z, state->f.s, state->f.p, state->f.ac);
+	i8080_run(state, 1); // Execute command
+	success = i8080op_readMemory(state, 0x00FF) == 0xFF && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_S) == 1 && GET_FLAG(state, FLAG_P) == 1 && GET_FLAG(state, FLAG_AC) == 0;
+	//log_debug("b:%i z:%i s:%i p:%i ac:%i", state->b, GET_FLAG(state, FLAG_Z), GET_FLAG(state, FLAG_S), GET_FLAG(state, FLAG_P), GET_FLAG(state, FLAG_AC));
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_M\t(%02X)\t\t: [%s]\n", DCR_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_M, 0x42, 0x00); i8080op_putHL16(state, 0x40); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = i8080op_readMemory(state, 0x40) == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_M\t(%02X)\t\t: [%s]\n", MVI_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DAD_SP, 0x00, 0x00); i8080op_putHL16(state, 0x1); state->sp = 0x2;// Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = i8080op_getHL(state) == 0x3 && state->f.c == 0;
+	i8080_run(state, 1); // Execute command
+	success = i8080op_getHL(state) == 0x3 && GET_FLAG(state, FLAG_C) == 0;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DAD_SP\t(%02X)\t\t: [%s]\n", DAD_SP, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, LDA, 0x00, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == LDA;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test LDA\t(%02X)\t\t: [%s]\n", LDA, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCX_SP, 0x00, 0x00); state->sp = 0x2; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->sp == 0x01;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCX_SP\t(%02X)\t\t: [%s]\n", DCX_SP, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, INR_A, 0x00, 0x00); state->a = 0x1; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == 0x02;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test INR_A\t(%02X)\t\t: [%s]\n", INR_A, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, DCR_A, 0x00, 0x00); state->a = 0x2; // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == 0x01;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test DCR_A\t(%02X)\t\t: [%s]\n", DCR_A, success ? "OK" : "FAIL"); // Print the result of the test
 
 	utilTest_prepNext(state, MVI_A, 0x42, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
+	i8080_run(state, 1); // Execute command
 	success = state->a == 0x42;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test MVI_A\t(%02X)\t\t: [%s]\n", MVI_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMC, 0x00, 0x00); state->f.c = 1; // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->f.c == 0;
+	utilTest_prepNext(state, CMC, 0x00, 0x00); SET_FLAG(state, FLAG_C, 1); // Setup the command
+	i8080_run(state, 1); // Execute command
+	success = GET_FLAG(state, FLAG_C) == 0;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMC\t(%02X)\t\t: [%s]\n", CMC, success ? "OK" : "FAIL"); // Print the result of the test
 
+	utilTest_prepNext(state, CMC, 0x00, 0x00); SET_FLAG(state, FLAG_C, 0); // Setup the command
+	i8080_run(state, 1); // Execute command
+	success = GET_FLAG(state, FLAG_C) == 1;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test CMC carry clear\t(%02X)\t: [%s]\n", CMC, success ? "OK" : "FAIL"); // Print the result of the test
+
 	utilTest_prepNext(state, STC, 0x00, 0x00); // Setup the command
-	i8080_cpuTick(state); // Execute command
-	success = state->f.c == 1;
+	i8080_run(state, 1); // Execute command
+	success = GET_FLAG(state, FLAG_C) == 1;
 	if (!success) { failedTests++; }
 	fprintf(testLog, "Test STC\t(%02X)\t\t: [%s]\n", STC, success ? "OK" : "FAIL"); // Print the result of the test
 
+	utilTest_prepNext(state, PUSH_PSW, 0x00, 0x00); state->a = 0x12; i8080op_putFlags(state, 0xFF); state->sp = 0x2400; // Setup the command
+	i8080_run(state, 1); // Execute command
+	success = i8080op_readMemory(state, 0x23FF) == 0x12 && i8080op_readMemory(state, 0x23FE) == 0xD7 && state->sp == 0x23FE;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test PUSH_PSW\t(%02X)\t\t: [%s]\n", PUSH_PSW, success ? "OK" : "FAIL"); // Print the result of the test
+
+	utilTest_prepNext(state, POP_PSW, 0x00, 0x00); state->sp = 0x23FE; i8080op_writeMemory(state, 0x23FE, 0x28); i8080op_writeMemory(state, 0x23FF, 0x34); // Setup the command
+	i8080_run(state, 1); // Execute command
+	success = state->a == 0x34 && state->f.psw == FLAG_ONE && state->sp == 0x2400;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test POP_PSW\t(%02X)\t\t: [%s]\n", POP_PSW, success ? "OK" : "FAIL"); // Print the result of the test
+
 	// Mov test B
-	utilTest_prepNext(state, MOV_BB, 0x00, 0x00); state->b = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BB, 0x00, 0x00); state->b = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BB\t(%02X)\t\t: [%s]\n", MOV_BB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BC, 0x00, 0x00); state->b = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BC, 0x00, 0x00); state->b = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BC\t(%02X)\t\t: [%s]\n", MOV_BC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BD, 0x00, 0x00); state->b = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BD, 0x00, 0x00); state->b = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BD\t(%02X)\t\t: [%s]\n", MOV_BD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BE, 0x00, 0x00); state->b = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BE, 0x00, 0x00); state->b = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BE\t(%02X)\t\t: [%s]\n", MOV_BE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BH, 0x00, 0x00); state->b = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BH, 0x00, 0x00); state->b = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BH\t(%02X)\t\t: [%s]\n", MOV_BH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BL, 0x00, 0x00); state->b = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BL, 0x00, 0x00); state->b = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BL\t(%02X)\t\t: [%s]\n", MOV_BL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BA, 0x00, 0x00); state->b = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BA, 0x00, 0x00); state->b = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BA\t(%02X)\t\t: [%s]\n", MOV_BA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_BM, 0x00, 0x00); state->b = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_BM, 0x00, 0x00); state->b = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->b == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_BM\t(%02X)\t\t: [%s]\n", MOV_BM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test C
-	utilTest_prepNext(state, MOV_CB, 0x00, 0x00); state->c = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CB, 0x00, 0x00); state->c = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CB\t(%02X)\t\t: [%s]\n", MOV_CB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CC, 0x00, 0x00); state->c = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CC, 0x00, 0x00); state->c = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CC\t(%02X)\t\t: [%s]\n", MOV_CC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CD, 0x00, 0x00); state->c = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CD, 0x00, 0x00); state->c = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CD\t(%02X)\t\t: [%s]\n", MOV_CD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CE, 0x00, 0x00); state->c = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CE, 0x00, 0x00); state->c = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CE\t(%02X)\t\t: [%s]\n", MOV_CE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CH, 0x00, 0x00); state->c = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CH, 0x00, 0x00); state->c = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CH\t(%02X)\t\t: [%s]\n", MOV_CH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CL, 0x00, 0x00); state->c = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CL, 0x00, 0x00); state->c = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CL\t(%02X)\t\t: [%s]\n", MOV_CL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CA, 0x00, 0x00); state->c = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CA, 0x00, 0x00); state->c = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CA\t(%02X)\t\t: [%s]\n", MOV_CA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_CM, 0x00, 0x00); state->c = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_CM, 0x00, 0x00); state->c = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->c == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_CM\t(%02X)\t\t: [%s]\n", MOV_CM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test D
-	utilTest_prepNext(state, MOV_DB, 0x00, 0x00); state->d = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DB, 0x00, 0x00); state->d = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DB\t(%02X)\t\t: [%s]\n", MOV_DB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DC, 0x00, 0x00); state->d = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DC, 0x00, 0x00); state->d = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DC\t(%02X)\t\t: [%s]\n", MOV_DC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DD, 0x00, 0x00); state->d = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DD, 0x00, 0x00); state->d = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DD\t(%02X)\t\t: [%s]\n", MOV_DD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DE, 0x00, 0x00); state->d = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DE, 0x00, 0x00); state->d = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DE\t(%02X)\t\t: [%s]\n", MOV_DE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DH, 0x00, 0x00); state->d = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DH, 0x00, 0x00); state->d = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DH\t(%02X)\t\t: [%s]\n", MOV_DH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DL, 0x00, 0x00); state->d = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DL, 0x00, 0x00); state->d = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DL\t(%02X)\t\t: [%s]\n", MOV_DL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DA, 0x00, 0x00); state->d = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DA, 0x00, 0x00); state->d = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DA\t(%02X)\t\t: [%s]\n", MOV_DA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_DM, 0x00, 0x00); state->d = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_DM, 0x00, 0x00); state->d = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->d == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_DM\t(%02X)\t\t: [%s]\n", MOV_DM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test E
-	utilTest_prepNext(state, MOV_EB, 0x00, 0x00); state->e = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EB, 0x00, 0x00); state->e = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EB\t(%02X)\t\t: [%s]\n", MOV_EB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_EC, 0x00, 0x00); state->e = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EC, 0x00, 0x00); state->e = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EC\t(%02X)\t\t: [%s]\n", MOV_EC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_ED, 0x00, 0x00); state->e = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_ED, 0x00, 0x00); state->e = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_ED\t(%02X)\t\t: [%s]\n", MOV_ED, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_EE, 0x00, 0x00); state->e = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EE, 0x00, 0x00); state->e = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EE\t(%02X)\t\t: [%s]\n", MOV_EE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_EH, 0x00, 0x00); state->e = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EH, 0x00, 0x00); state->e = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EH\t(%02X)\t\t: [%s]\n", MOV_EH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_EL, 0x00, 0x00); state->e = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EL, 0x00, 0x00); state->e = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EL\t(%02X)\t\t: [%s]\n", MOV_EL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_EA, 0x00, 0x00); state->e = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EA, 0x00, 0x00); state->e = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EA\t(%02X)\t\t: [%s]\n", MOV_EA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_EM, 0x00, 0x00); state->e = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_EM, 0x00, 0x00); state->e = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->e == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_EM\t(%02X)\t\t: [%s]\n", MOV_EM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test H
-	utilTest_prepNext(state, MOV_HB, 0x00, 0x00); state->h = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HB, 0x00, 0x00); state->h = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HB\t(%02X)\t\t: [%s]\n", MOV_HB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HC, 0x00, 0x00); state->h = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HC, 0x00, 0x00); state->h = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HC\t(%02X)\t\t: [%s]\n", MOV_HC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HD, 0x00, 0x00); state->h = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HD, 0x00, 0x00); state->h = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HD\t(%02X)\t\t: [%s]\n", MOV_HD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HE, 0x00, 0x00); state->h = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HE, 0x00, 0x00); state->h = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HE\t(%02X)\t\t: [%s]\n", MOV_HE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HH, 0x00, 0x00); state->h = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HH, 0x00, 0x00); state->h = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HH\t(%02X)\t\t: [%s]\n", MOV_HH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HL, 0x00, 0x00); state->h = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HL, 0x00, 0x00); state->h = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HL\t(%02X)\t\t: [%s]\n", MOV_HL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HA, 0x00, 0x00); state->h = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HA, 0x00, 0x00); state->h = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HA\t(%02X)\t\t: [%s]\n", MOV_HA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_HM, 0x00, 0x00); state->h = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_HM, 0x00, 0x00); state->h = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->h == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_HM\t(%02X)\t\t: [%s]\n", MOV_HM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test L
-	utilTest_prepNext(state, MOV_LB, 0x00, 0x00); state->l = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LB, 0x00, 0x00); state->l = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LB\t(%02X)\t\t: [%s]\n", MOV_LB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LC, 0x00, 0x00); state->l = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LC, 0x00, 0x00); state->l = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LC\t(%02X)\t\t: [%s]\n", MOV_LC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LD, 0x00, 0x00); state->l = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LD, 0x00, 0x00); state->l = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LD\t(%02X)\t\t: [%s]\n", MOV_LD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LE, 0x00, 0x00); state->l = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LE, 0x00, 0x00); state->l = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LE\t(%02X)\t\t: [%s]\n", MOV_LE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LH, 0x00, 0x00); state->l = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LH, 0x00, 0x00); state->l = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LH\t(%02X)\t\t: [%s]\n", MOV_LH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LL, 0x00, 0x00); state->l = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LL, 0x00, 0x00); state->l = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LL\t(%02X)\t\t: [%s]\n", MOV_LL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LA, 0x00, 0x00); state->l = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LA, 0x00, 0x00); state->l = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LA\t(%02X)\t\t: [%s]\n", MOV_LA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_LM, 0x00, 0x00); state->l = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_LM, 0x00, 0x00); state->l = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->l == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_LM\t(%02X)\t\t: [%s]\n", MOV_LM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test A
-	utilTest_prepNext(state, MOV_AB, 0x00, 0x00); state->a = 0xF; state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AB, 0x00, 0x00); state->a = 0xF; state->b = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AB\t(%02X)\t\t: [%s]\n", MOV_AB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AC, 0x00, 0x00); state->a = 0xF; state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AC, 0x00, 0x00); state->a = 0xF; state->c = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AC\t(%02X)\t\t: [%s]\n", MOV_AC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AD, 0x00, 0x00); state->a = 0xF; state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AD, 0x00, 0x00); state->a = 0xF; state->d = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AD\t(%02X)\t\t: [%s]\n", MOV_AD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AE, 0x00, 0x00); state->a = 0xF; state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AE, 0x00, 0x00); state->a = 0xF; state->e = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AE\t(%02X)\t\t: [%s]\n", MOV_AE, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AH, 0x00, 0x00); state->a = 0xF; state->h = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AH, 0x00, 0x00); state->a = 0xF; state->h = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AH\t(%02X)\t\t: [%s]\n", MOV_AH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AL, 0x00, 0x00); state->a = 0xF; state->l = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AL, 0x00, 0x00); state->a = 0xF; state->l = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AL\t(%02X)\t\t: [%s]\n", MOV_AL, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AA, 0x00, 0x00); state->a = 0xF; state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AA, 0x00, 0x00); state->a = 0xF; state->a = 0xA; i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AA\t(%02X)\t\t: [%s]\n", MOV_AA, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_AM, 0x00, 0x00); state->a = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_AM, 0x00, 0x00); state->a = 0xF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xA); i8080_run(state, 1);
 	success = state->a == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_AM\t(%02X)\t\t: [%s]\n", MOV_AM, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// Mov test M
-	utilTest_prepNext(state, MOV_MB, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->b = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_MB, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->b = 0xA; i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_MB\t(%02X)\t\t: [%s]\n", MOV_MB, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_MC, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->c = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_MC, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->c = 0xA; i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_MC\t(%02X)\t\t: [%s]\n", MOV_MC, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_MD, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->d = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_MD, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->d = 0xA; i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_MD\t(%02X)\t\t: [%s]\n", MOV_MD, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_ME, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->e = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_ME, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->e = 0xA; i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_ME\t(%02X)\t\t: [%s]\n", MOV_ME, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_MH, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_MH, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0x00; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_MH\t(%02X)\t\t: [%s]\n", MOV_MH, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_ML, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_ML, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0xAA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_ML\t(%02X)\t\t: [%s]\n", MOV_ML, success ? "OK" : "FAIL"); // Print the result of the test
-	utilTest_prepNext(state, MOV_MA, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->a = 0xA; i8080_cpuTick(state);
+	utilTest_prepNext(state, MOV_MA, 0x00, 0x00); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xF); state->a = 0xA; i8080_run(state, 1);
 	success = i8080op_readMemory(state, 0x00AA) == 0xA; if (!success) { failedTests++; } fprintf(testLog, "Test MOV_MA\t(%02X)\t\t: [%s]\n", MOV_MA, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ADD test
-	utilTest_prepNext(state, ADD_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; } 
+	utilTest_prepNext(state, ADD_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x1; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; } 
 	fprintf(testLog, "Test ADD_B\t(%02X)\t\t: [%s]\n", ADD_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x1; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_C\t(%02X)\t\t: [%s]\n", ADD_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x1; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_D\t(%02X)\t\t: [%s]\n", ADD_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_E, 0x00, 0x00); state->a = 0xFF; state->e = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_E, 0x00, 0x00); state->a = 0xFF; state->e = 0x1; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_E\t(%02X)\t\t: [%s]\n", ADD_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x1; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_H\t(%02X)\t\t: [%s]\n", ADD_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x1; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_L\t(%02X)\t\t: [%s]\n", ADD_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_A, 0x00, 0x00); state->a = 0x1; i8080_cpuTick(state);
-	success = state->a == 0x02 && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_A, 0x00, 0x00); state->a = 0x1; i8080_run(state, 1);
+	success = state->a == 0x02 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_A\t(%02X)\t\t: [%s]\n", ADD_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADD_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x1); i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 1 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADD_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x1); i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADD_M\t(%02X)\t\t: [%s]\n", ADD_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ADC test
-	utilTest_prepNext(state, ADC_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_B\t(%02X)\t\t: [%s]\n", ADC_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_C\t(%02X)\t\t: [%s]\n", ADC_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_D\t(%02X)\t\t: [%s]\n", ADC_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_E, 0x00, 0x00); state->a = 0xFF; state->e = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_E, 0x00, 0x00); state->a = 0xFF; state->e = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_E\t(%02X)\t\t: [%s]\n", ADC_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_H\t(%02X)\t\t: [%s]\n", ADC_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_L\t(%02X)\t\t: [%s]\n", ADC_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_A, 0x00, 0x00); state->a = 0x1; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x03 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_A, 0x00, 0x00); state->a = 0x1; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x03 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_A\t(%02X)\t\t: [%s]\n", ADC_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ADC_M, 0x00, 0x00); state->a = 0xFF; state->f.c = 1; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x1); i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADC_M, 0x00, 0x00); state->a = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x1); i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADC_M\t(%02X)\t\t: [%s]\n", ADC_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// SUB test
-	utilTest_prepNext(state, SUB_B, 0x00, 0x00); state->a = 0xFE; state->b = 0xFF; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_B, 0x00, 0x00); state->a = 0xFE; state->b = 0xFF; i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_B\t(%02X)\t\t: [%s]\n", SUB_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_C, 0x00, 0x00); state->a = 0xFE; state->c = 0xFF; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_C, 0x00, 0x00); state->a = 0xFE; state->c = 0xFF; i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_C\t(%02X)\t\t: [%s]\n", SUB_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_D, 0x00, 0x00); state->a = 0xFE; state->d = 0xFF; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_D, 0x00, 0x00); state->a = 0xFE; state->d = 0xFF; i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_D\t(%02X)\t\t: [%s]\n", SUB_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_E, 0x00, 0x00); state->a = 0xFE; state->e = 0x01; i8080_cpuTick(state);
-	success = state->a == 0xFD && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_E, 0x00, 0x00); state->a = 0xFE; state->e = 0x01; i8080_run(state, 1);
+	success = state->a == 0xFD && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_E\t(%02X)\t\t: [%s]\n", SUB_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_H, 0x00, 0x00); state->a = 0xFE; state->h = 0x01; i8080_cpuTick(state);
-	success = state->a == 0xFD && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_H, 0x00, 0x00); state->a = 0xFE; state->h = 0x01; i8080_run(state, 1);
+	success = state->a == 0xFD && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_H\t(%02X)\t\t: [%s]\n", SUB_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_L, 0x00, 0x00); state->a = 0xFE; state->l = 0x01; i8080_cpuTick(state);
-	success = state->a == 0xFD && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_L, 0x00, 0x00); state->a = 0xFE; state->l = 0x01; i8080_run(state, 1);
+	success = state->a == 0xFD && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_L\t(%02X)\t\t: [%s]\n", SUB_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_A, 0x00, 0x00); state->a = 0x01; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 0 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_A, 0x00, 0x00); state->a = 0x01; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_A\t(%02X)\t\t: [%s]\n", SUB_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SUB_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x1); i8080_cpuTick(state);
-	success = state->a == 0xFE && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUB_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x1); i8080_run(state, 1);
+	success = state->a == 0xFE && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUB_M\t(%02X)\t\t: [%s]\n", SUB_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// SBB test
-	utilTest_prepNext(state, SBB_B, 0x00, 0x00); state->a = 0xFF; state->b = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_B, 0x00, 0x00); state->a = 0xFF; state->b = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_B\t(%02X)\t\t: [%s]\n", SBB_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_C, 0x00, 0x00); state->a = 0xFF; state->c = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_C, 0x00, 0x00); state->a = 0xFF; state->c = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_C\t(%02X)\t\t: [%s]\n", SBB_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_D, 0x00, 0x00); state->a = 0xFF; state->d = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_D, 0x00, 0x00); state->a = 0xFF; state->d = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_D\t(%02X)\t\t: [%s]\n", SBB_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_E, 0x00, 0x00); state->a = 0xFF; state->e = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_E, 0x00, 0x00); state->a = 0xFF; state->e = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_E\t(%02X)\t\t: [%s]\n", SBB_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_H, 0x00, 0x00); state->a = 0xFF; state->h = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_H, 0x00, 0x00); state->a = 0xFF; state->h = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_H\t(%02X)\t\t: [%s]\n", SBB_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_L, 0x00, 0x00); state->a = 0xFF; state->l = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_L, 0x00, 0x00); state->a = 0xFF; state->l = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_L\t(%02X)\t\t: [%s]\n", SBB_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_A, 0x00, 0x00); state->a = 0xFF; state->a = 0xFF; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_A, 0x00, 0x00); state->a = 0xFF; state->a = 0xFF; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_A\t(%02X)\t\t: [%s]\n", SBB_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, SBB_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xFF); state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBB_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0xFF); SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBB_M\t(%02X)\t\t: [%s]\n", SBB_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ANA testing
-	utilTest_prepNext(state, ANA_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_B\t(%02X)\t\t: [%s]\n", ANA_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_C\t(%02X)\t\t: [%s]\n", ANA_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_D\t(%02X)\t\t: [%s]\n", ANA_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_E, 0x00, 0x00); state->a = 0xFF; state->e = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_E, 0x00, 0x00); state->a = 0xFF; state->e = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_E\t(%02X)\t\t: [%s]\n", ANA_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_H\t(%02X)\t\t: [%s]\n", ANA_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_L\t(%02X)\t\t: [%s]\n", ANA_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_A, 0x00, 0x00); state->a = 0xFF; state->a = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_A, 0x00, 0x00); state->a = 0xFF; state->a = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_A\t(%02X)\t\t: [%s]\n", ANA_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ANA_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x0F); i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANA_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x0F); i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANA_M\t(%02X)\t\t: [%s]\n", ANA_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// XRA testing
-	utilTest_prepNext(state, XRA_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_B, 0x00, 0x00); state->a = 0xFF; state->b = 0x0F; i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_B\t(%02X)\t\t: [%s]\n", XRA_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_C, 0x00, 0x00); state->a = 0xFF; state->c = 0x0F; i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_C\t(%02X)\t\t: [%s]\n", XRA_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_D, 0x00, 0x00); state->a = 0xFF; state->d = 0x0F; i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_D\t(%02X)\t\t: [%s]\n", XRA_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_E, 0x00, 0x00); state->a = 0xFF; state->b = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_E, 0x00, 0x00); state->a = 0xFF; state->b = 0x0F; i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_B\t(%02X)\t\t: [%s]\n", XRA_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_H, 0x00, 0x00); state->a = 0xFF; state->h = 0x0F; i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_H\t(%02X)\t\t: [%s]\n", XRA_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_L, 0x00, 0x00); state->a = 0xFF; state->l = 0x0F; i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_L\t(%02X)\t\t: [%s]\n", XRA_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_A, 0x00, 0x00); state->a = 0xFF; i8080_cpuTick(state);
-	success = state->a == 0x00 && state->f.c == 0 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_A, 0x00, 0x00); state->a = 0xFF; i8080_run(state, 1);
+	success = state->a == 0x00 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_B\t(%02X)\t\t: [%s]\n", XRA_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, XRA_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x0F); i8080_cpuTick(state);
-	success = state->a == 0xF0 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRA_M, 0x00, 0x00); state->a = 0xFF; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x0F); i8080_run(state, 1);
+	success = state->a == 0xF0 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRA_M\t(%02X)\t\t: [%s]\n", XRA_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ORA testing
-	utilTest_prepNext(state, ORA_B, 0x00, 0x00); state->a = 0x10; state->b = 0x0C; i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_B, 0x00, 0x00); state->a = 0x10; state->b = 0x0C; i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_B\t(%02X)\t\t: [%s]\n", ORA_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_C, 0x00, 0x00); state->a = 0x10; state->c = 0x0C; i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_C, 0x00, 0x00); state->a = 0x10; state->c = 0x0C; i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_C\t(%02X)\t\t: [%s]\n", ORA_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_D, 0x00, 0x00); state->a = 0x10; state->d = 0x0C; i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_D, 0x00, 0x00); state->a = 0x10; state->d = 0x0C; i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_D\t(%02X)\t\t: [%s]\n", ORA_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_E, 0x00, 0x00); state->a = 0x10; state->e = 0x0C; i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_E, 0x00, 0x00); state->a = 0x10; state->e = 0x0C; i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_E\t(%02X)\t\t: [%s]\n", ORA_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_H, 0x00, 0x00); state->a = 0x10; state->h = 0x0C; i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_H, 0x00, 0x00); state->a = 0x10; state->h = 0x0C; i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_H\t(%02X)\t\t: [%s]\n", ORA_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_L, 0x00, 0x00); state->a = 0x10; state->l = 0x0C; i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_L, 0x00, 0x00); state->a = 0x10; state->l = 0x0C; i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_L\t(%02X)\t\t: [%s]\n", ORA_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_A, 0x00, 0x00); state->a = 0x0F; i8080_cpuTick(state);
-	success = state->a == 0x0F && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_A, 0x00, 0x00); state->a = 0x0F; i8080_run(state, 1);
+	success = state->a == 0x0F && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_A\t(%02X)\t\t: [%s]\n", ORA_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, ORA_M, 0x00, 0x00); state->a = 0x10; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x0C); i8080_cpuTick(state);
-	success = state->a == 0x1C && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORA_M, 0x00, 0x00); state->a = 0x10; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x0C); i8080_run(state, 1);
+	success = state->a == 0x1C && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORA_M\t(%02X)\t\t: [%s]\n", ORA_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// CMP testing
-	utilTest_prepNext(state, CMP_B, 0x00, 0x00); state->a = 0x10; state->b = 0x10; i8080_cpuTick(state);
-	success = state->f.c == 0 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_B, 0x00, 0x00); state->a = 0x10; state->b = 0x10; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_B\t(%02X)\t\t: [%s]\n", CMP_B, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_C, 0x00, 0x00); state->a = 0x10; state->c = 0x10; i8080_cpuTick(state);
-	success = state->f.c == 0 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_C, 0x00, 0x00); state->a = 0x10; state->c = 0x10; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_C\t(%02X)\t\t: [%s]\n", CMP_C, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_D, 0x00, 0x00); state->a = 0x10; state->d = 0x10; i8080_cpuTick(state);
-	success = state->f.c == 0 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_D, 0x00, 0x00); state->a = 0x10; state->d = 0x10; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_D\t(%02X)\t\t: [%s]\n", CMP_D, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_E, 0x00, 0x00); state->a = 0x10; state->e = 0x11; i8080_cpuTick(state);
-	success = state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_E, 0x00, 0x00); state->a = 0x10; state->e = 0x11; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_E\t(%02X)\t\t: [%s]\n", CMP_E, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_H, 0x00, 0x00); state->a = 0x10; state->h = 0x11; i8080_cpuTick(state);
-	success = state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_H, 0x00, 0x00); state->a = 0x10; state->h = 0x11; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_H\t(%02X)\t\t: [%s]\n", CMP_H, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_L, 0x00, 0x00); state->a = 0x10; state->l = 0x11; i8080_cpuTick(state);
-	success = state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_L, 0x00, 0x00); state->a = 0x10; state->l = 0x11; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_L\t(%02X)\t\t: [%s]\n", CMP_L, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_A, 0x00, 0x00); state->a = 0x10; i8080_cpuTick(state);
-	success = state->f.c == 0 && state->f.z == 1 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_A, 0x00, 0x00); state->a = 0x10; i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 1 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_A\t(%02X)\t\t: [%s]\n", CMP_A, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, CMP_M, 0x00, 0x00); state->a = 0x10; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x11);  i8080_cpuTick(state);
-	success = state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, CMP_M, 0x00, 0x00); state->a = 0x10; i8080op_putHL16(state, 0x00AA); i8080op_writeMemory(state, 0x00AA, 0x11);  i8080_run(state, 1);
+	success = GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test CMP_M\t(%02X)\t\t: [%s]\n", CMP_M, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ADI test
-	utilTest_prepNext(state, ADI, 0x01, 0x00); state->a = 0x10; i8080_cpuTick(state);
-	success = state->a == 0x11 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ADI, 0x01, 0x00); state->a = 0x10; i8080_run(state, 1);
+	success = state->a == 0x11 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ADI\t(%02X)\t\t: [%s]\n", ADI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ACI test
-	utilTest_prepNext(state, ACI, 0x01, 0x00); state->a = 0x10; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0x12 && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ACI, 0x01, 0x00); state->a = 0x10; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0x12 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ACI\t(%02X)\t\t: [%s]\n", ACI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// SUI test
-	utilTest_prepNext(state, SUI, 0xFF, 0x00); state->a = 0xFE; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 1 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SUI, 0xFF, 0x00); state->a = 0xFE; i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SUI\t(%02X)\t\t: [%s]\n", SUI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// SBI test
-	utilTest_prepNext(state, SBI, 0xFF, 0x00); state->a = 0xFE; state->f.c = 1; i8080_cpuTick(state);
-	success = state->a == 0xFE && state->f.c == 1 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, SBI, 0xFF, 0x00); state->a = 0xFE; SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
+	success = state->a == 0xFE && GET_FLAG(state, FLAG_C) == 1 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test SBI\t(%02X)\t\t: [%s]\n", SBI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ANI test
-	utilTest_prepNext(state, ANI, 0x01, 0x00); state->a = 0xFF; i8080_cpuTick(state);
-	success = state->a == 0x01 && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ANI, 0x01, 0x00); state->a = 0xFF; i8080_run(state, 1);
+	success = state->a == 0x01 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ANI\t(%02X)\t\t: [%s]\n", ANI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// XRI test
-	utilTest_prepNext(state, XRI, 0x18, 0x00); state->a = 0x08; i8080_cpuTick(state);
-	success = state->a == 0x10 && state->f.c == 0 && state->f.z == 0 && state->f.p == 0; if (!success) { failedTests++; }
+	utilTest_prepNext(state, XRI, 0x18, 0x00); state->a = 0x08; i8080_run(state, 1);
+	success = state->a == 0x10 && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 0; if (!success) { failedTests++; }
 	fprintf(testLog, "Test XRI\t(%02X)\t\t: [%s]\n", XRI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	// ORI test
-	utilTest_prepNext(state, ORI, 0x0F, 0x00); state->a = 0xF0; i8080_cpuTick(state);
-	success = state->a == 0xFF && state->f.c == 0 && state->f.z == 0 && state->f.p == 1; if (!success) { failedTests++; }
+	utilTest_prepNext(state, ORI, 0x0F, 0x00); state->a = 0xF0; i8080_run(state, 1);
+	success = state->a == 0xFF && GET_FLAG(state, FLAG_C) == 0 && GET_FLAG(state, FLAG_Z) == 0 && GET_FLAG(state, FLAG_P) == 1; if (!success) { failedTests++; }
 	fprintf(testLog, "Test ORI\t(%02X)\t\t: [%s]\n", ORI, success ? "OK" : "FAIL"); // Print the result of the test
 
 	/* Move into the stack related functions */
 
 	// Jumping functions
-	utilTest_prepNext(state, JNZ, 0xFF, 0xFF); state->f.z = 0; i8080_cpuTick(state);
+	utilTest_prepNext(state, JNZ, 0xFF, 0xFF); SET_FLAG(state, FLAG_Z, 0); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JNZ\t(%02X)\t\t: [%s]\n", JNZ, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JMP, 0xFF, 0xFF); i8080_cpuTick(state);
+	utilTest_prepNext(state, JMP, 0xFF, 0xFF); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JMP\t(%02X)\t\t: [%s]\n", JMP, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JZ, 0xFF, 0xFF); state->f.z = 1; i8080_cpuTick(state);
+	utilTest_prepNext(state, JZ, 0xFF, 0xFF); SET_FLAG(state, FLAG_Z, 1); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JZ \t(%02X)\t\t: [%s]\n", JZ, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JNC, 0xFF, 0xFF); state->f.c = 0; i8080_cpuTick(state);
+	utilTest_prepNext(state, JNC, 0xFF, 0xFF); SET_FLAG(state, FLAG_C, 0); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JNC\t(%02X)\t\t: [%s]\n", JNC, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JC, 0xFF, 0xFF); state->f.c = 1; i8080_cpuTick(state);
+	utilTest_prepNext(state, JC, 0xFF, 0xFF); SET_FLAG(state, FLAG_C, 1); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JC \t(%02X)\t\t: [%s]\n", JC, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JNC, 0xFF, 0xFF); state->f.c = 0; i8080_cpuTick(state);
+	utilTest_prepNext(state, JNC, 0xFF, 0xFF); SET_FLAG(state, FLAG_C, 0); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JNC\t(%02X)\t\t: [%s]\n", JNC, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JPO, 0xFF, 0xFF); state->f.p = 0; i8080_cpuTick(state);
+	utilTest_prepNext(state, JPO, 0xFF, 0xFF); SET_FLAG(state, FLAG_P, 0); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JPO\t(%02X)\t\t: [%s]\n", JPO, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JPE, 0xFF, 0xFF); state->f.p = 1; i8080_cpuTick(state);
+	utilTest_prepNext(state, JPE, 0xFF, 0xFF); SET_FLAG(state, FLAG_P, 1); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JPE\t(%02X)\t\t: [%s]\n", JPE, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JP, 0xFF, 0xFF); state->f.s = 0; i8080_cpuTick(state);
+	utilTest_prepNext(state, JP, 0xFF, 0xFF); SET_FLAG(state, FLAG_S, 0); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JP \t(%02X)\t\t: [%s]\n", JP, success ? "OK" : "FAIL"); // Print the result of the test
 
-	utilTest_prepNext(state, JM, 0xFF, 0xFF); state->f.s = 1; i8080_cpuTick(state);
+	utilTest_prepNext(state, JM, 0xFF, 0xFF); SET_FLAG(state, FLAG_S, 1); i8080_run(state, 1);
 	success = state->pc == 0xFFFF; if (!success) { failedTests++; }
 	fprintf(testLog, "Test JM \t(%02X)\t\t: [%s]\n", JM, success ? "OK" : "FAIL"); // Print the result of the test
-	
-	// Output statistics
-	float elapsedTimeMs = sfTime_asMilliseconds(sfClock_getElapsedTime(timer));
-	float elapsedTimeSec = elapsedTimeMs / 1000.0f;
-	fprintf(testLog, "--------------------------------------------------\nTest complete!\nTime to complete test: %f seconds\nTests failed: %i\n", elapsedTimeSec, failedTests);
 
-	// cloe test file
-	fclose(testLog);
+	return failedTests;
+}
+
+int utilTest_opcodeList(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	uint32_t seed = 0x0DEF;
+	fprintf(testLog, "\n--- opcode list tests ---\n");
+
+	char text[I8080_DISASSEMBLY_LEN];
+	bool success = strcmp(i8080_disassemble(text, MVI_B, 0x12, 0x00), "MVI B,12") == 0
+		&& strcmp(i8080_disassemble(text, LXI_H, 0x00, 0x24), "LXI H,2400") == 0
+		&& strcmp(i8080_disassemble(text, JMP, 0x32, 0x1A), "JMP 1A32") == 0
+		&& strcmp(i8080_disassemble(text, IN, 0x01, 0x00), "IN 01") == 0
+		&& strcmp(i8080_disassemble(text, ADI, 0x05, 0x00), "ADI 05") == 0
+		&& strcmp(i8080_disassemble(text, MOV_MA, 0x00, 0x00), "MOV M,A") == 0
+		&& strcmp(i8080_disassemble(text, RST_7, 0x00, 0x00), "RST 7") == 0;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test disassembler\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// Each opcode runs on the switch core from a pseudo random state, and again with the flags its entry says it does not
+	// read flipped. Flags it does not write keep their value, memory only changes for OPK_WRITE, the ports for OPK_IO and
+	// the pc only goes anywhere but the next instruction for OPK_JUMP and OPK_HALT. The flipped run has to end the same
+	// apart from the flags passed through
+	i8080State* before = i8080_createState();
+	i8080State* flipped = i8080_createState();
+	for (int opcode = 0; opcode < 0x100; opcode++) {
+		const i8080OpcodeInfo* info = &i8080_opcodeInfo[opcode];
+		if (info->kind & OPK_UNDOCUMENTED)
+			continue;
+
+		success = true;
+		for (int trial = 0; trial < 8 && success; trial++) {
+			utilTest_randomState(state, &seed, false);
+			state->memory[0x1000] = opcode;
+			utilTest_copyState(before, state);
+			utilTest_copyState(flipped, state);
+			i8080op_putFlags(flipped, I8080_FLAGS(flipped)->psw ^ (FLAG_MASK & ~info->flagsRead));
+
+			state->interruptAccumulator = 0;
+			int cycles = i8080_run(state, 1);
+			flipped->interruptAccumulator = 0;
+			int flippedCycles = i8080_run(flipped, 1);
+
+			uint8_t psw = I8080_FLAGS(state)->psw;
+			success = ((psw ^ I8080_FLAGS(before)->psw) & FLAG_MASK & ~info->flagsWritten) == 0
+				&& (cycles == info->cycles || ((info->kind & OPK_CONDITIONAL) && cycles == info->failedCycles))
+				&& ((info->kind & OPK_WRITE) || memcmp(state->memory, before->memory, i8080_MEMORY_SIZE) == 0)
+				&& ((info->kind & OPK_IO) || memcmp(state->outPorts, before->outPorts, sizeof(state->outPorts)) == 0)
+				&& ((info->kind & (OPK_JUMP | OPK_HALT)) || state->pc == 0x1000 + info->length);
+
+			success = success && flippedCycles == cycles && flipped->pc == state->pc && flipped->sp == state->sp && flipped->mode == state->mode
+				&& flipped->a == state->a && flipped->bc == state->bc && flipped->de == state->de && flipped->hl == state->hl
+				&& ((I8080_FLAGS(flipped)->psw ^ psw) & info->flagsWritten) == 0
+				&& memcmp(flipped->memory, state->memory, i8080_MEMORY_SIZE) == 0;
+		}
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test opcode list entry\t%s\t(%02X)\t\t: [%s]\n", i8080_decompile(opcode), opcode, success ? "OK" : "FAIL");
+	}
+
+	i8080_destroyState(before);
+	i8080_destroyState(flipped);
+	state->mode = MODE_TEST;
+	return failedTests;
+}
+
+int utilTest_coreEquivalence(i8080State* state, FILE* testLog, int core) {
+	int failedTests = 0;
+	uint32_t seed = 0x8080;
+
+	i8080State* ref = i8080_createState();
+	ref->mode = MODE_TEST;
+	ref->core = CORE_SWITCH;
+	ref->traced = true; // the lean cores are checked against the instrumented switch
+	state->core = core;
+
+	for (int opcode = 0; opcode < 0x100; opcode++) {
+		// Skip the undocumented opcodes, they panic on every core
+		if (strcmp(i8080_decompile(opcode), "unknown") == 0)
+			continue;
+
+		bool success = true;
+		for (int trial = 0; trial < 8 && success; trial++) {
+			// Same pseudo random registers, flags and memory in both states with the opcode at 0x1000
+			utilTest_randomState(ref, &seed, false);
+			ref->memory[0x1000] = opcode;
+
+			// Odd trials run outside of test mode on the invaders map so the opcode at 0x1000 comes from the predecoded ROM
+			if (trial % 2 == 1) {
+				ref->mode = MODE_NORMAL;
+				i8080_busMap(ref, &i8080_invadersMap);
+			}
+
+			utilTest_copyState(state, ref);
+
+			ref->interruptAccumulator = 0;
+			int refCycles = i8080_run(ref, 1);
+			state->interruptAccumulator = 0;
+			int cycles = i8080_run(state, 1);
+
+			success = cycles == refCycles && utilTest_statesMatch(state, ref);
+		}
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test core %s matches switch\t%s\t(%02X)\t: [%s]\n", getCoreStr(core), i8080_decompile(opcode), opcode, success ? "OK" : "FAIL");
+	}
+
+	// Whole pseudo random programs, long enough to run multi instruction blocks and take a frame interrupt part way through
+	bool success = true;
+	for (int trial = 0; trial < 32 && success; trial++) {
+		utilTest_randomState(ref, &seed, true);
+		if (trial % 2 == 1) {
+			ref->mode = MODE_NORMAL;
+			i8080_busMap(ref, &i8080_invadersMap);
+		}
+		ref->f.ien = trial % 4 < 2;
+
+		utilTest_copyState(state, ref);
+
+		ref->interruptAccumulator = i8080_invadersBoard.interruptPeriod - 300;
+		ref->interruptIndex = 0;
+		int refCycles = i8080_run(ref, 3000);
+		state->interruptAccumulator = i8080_invadersBoard.interruptPeriod - 300;
+		state->interruptIndex = 0;
+		int cycles = i8080_run(state, 3000);
+
+		success = cycles == refCycles && state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test core %s matches switch\trandom programs\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+
+	i8080_destroyState(ref);
+	state->mode = MODE_TEST;
+	state->core = CORE_SWITCH;
+	return failedTests;
+}
+
+int utilTest_wideCore(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	uint32_t seed = 0x8086;
+
+	// Every lane has a twin run on its own on the switch core
+	i8080State* lanes[WIDE_LANES];
+	i8080State* refs[WIDE_LANES];
+	for (int i = 0; i < WIDE_LANES; i++) {
+		lanes[i] = i8080_createState();
+		refs[i] = i8080_createState();
+	}
+	i8080Wide wide;
+	i8080_wideInit(&wide, lanes, WIDE_LANES);
+
+	fprintf(testLog, "\n--- wide core tests ---\n");
+	int runs = 0;
+	for (int opcode = 0; opcode < 0x100; opcode++) {
+		if (strcmp(i8080_decompile(opcode), "unknown") == 0)
+			continue;
+
+		bool success = true;
+		for (int trial = 0; trial < 4 && success; trial++) {
+			utilTest_randomState(state, &seed, false);
+			state->memory[0x1000] = opcode;
+
+			// The same instruction on every lane, with A and the flags differing by lane so the conditional ones split the group. The upper half runs outside of test mode on the invaders map
+			for (int i = 0; i < WIDE_LANES; i++) {
+				utilTest_copyState(refs[i], state);
+				refs[i]->a ^= i * 0x11;
+				i8080op_putFlags(refs[i], refs[i]->f.psw ^ (i * 0x45));
+				if (i >= WIDE_LANES / 2) {
+					refs[i]->mode = MODE_NORMAL;
+					i8080_busMap(refs[i], &i8080_invadersMap);
+				}
+				refs[i]->interruptAccumulator = 0;
+				utilTest_copyState(lanes[i], refs[i]);
+			}
+
+			i8080_runWide(&wide, 1);
+			runs++;
+			for (int i = 0; i < WIDE_LANES; i++) {
+				i8080_run(refs[i], 1);
+				success = success && lanes[i]->cyclesExecuted == refs[i]->cyclesExecuted && utilTest_statesMatch(lanes[i], refs[i]);
+			}
+		}
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test core wide matches switch\t%s\t(%02X)\t: [%s]\n", i8080_decompile(opcode), opcode, success ? "OK" : "FAIL");
+	}
+
+	// Every lane started on the same instruction, so each run was one step taken by all of them
+	bool success = wide.steps == (unsigned long)runs && wide.laneInstructions + wide.peeled == (unsigned long)runs * WIDE_LANES;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test core wide groups lanes\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// Whole pseudo random programs, the lanes branch apart and take their frame interrupts at different times
+	success = true;
+	for (int trial = 0; trial < 8 && success; trial++) {
+		utilTest_randomState(state, &seed, true);
+		state->f.ien = trial % 2 == 0;
+		for (int i = 0; i < WIDE_LANES; i++) {
+			utilTest_copyState(refs[i], state);
+			refs[i]->a ^= i * 0x11;
+			i8080op_putFlags(refs[i], refs[i]->f.psw ^ (i * 0x45));
+			if (i >= WIDE_LANES / 2) {
+				refs[i]->mode = MODE_NORMAL;
+				i8080_busMap(refs[i], &i8080_invadersMap);
+			}
+			refs[i]->interruptAccumulator = i8080_invadersBoard.interruptPeriod - 300 - i * 100;
+			refs[i]->interruptIndex = 0;
+			utilTest_copyState(lanes[i], refs[i]);
+		}
+
+		i8080_runWide(&wide, 3000);
+		for (int i = 0; i < WIDE_LANES; i++) {
+			i8080_run(refs[i], 3000);
+			success = success && lanes[i]->cyclesExecuted == refs[i]->cyclesExecuted && utilTest_statesMatch(lanes[i], refs[i]);
+		}
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test core wide matches switch\trandom programs\t: [%s]\n", success ? "OK" : "FAIL");
+
+	for (int i = 0; i < WIDE_LANES; i++) {
+		i8080_destroyState(lanes[i]);
+		i8080_destroyState(refs[i]);
+	}
+	return failedTests;
+}
+
+int utilTest_fusedPairs(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	uint32_t seed = 0xF05E;
+
+	i8080State* ref = i8080_createState();
+	ref->core = CORE_SWITCH;
+	state->core = CORE_FUSED;
+	i8080State* traced = i8080_createState(); // only the traced form counts the pairs it fuses
+	traced->core = CORE_FUSED;
+
+	uint8_t pairs[][2] = {
+		#define FUSED_PAIR(FIRST, SECOND) { FIRST, SECOND },
+		I8080_FUSED_LIST(FUSED_PAIR)
+	};
+	for (int i = 0; i < sizeof(pairs) / sizeof(pairs[0]); i++) {
+		bool success = true;
+		for (int trial = 0; trial < 8 && success; trial++) {
+			// The pair at 0x1000 in the predecoded ROM, with random registers, flags and operands
+			utilTest_randomState(ref, &seed, false);
+			ref->mode = MODE_NORMAL;
+			i8080_busMap(ref, &i8080_invadersMap);
+			ref->memory[0x1000] = pairs[i][0];
+			ref->memory[0x1000 + i8080_getInstructionLength(pairs[i][0])] = pairs[i][1];
+
+			utilTest_copyState(state, ref);
+			utilTest_copyState(traced, ref);
+			traced->traced = true;
+			traced->debug->fusedPairs = 0;
+
+			ref->interruptAccumulator = 0;
+			int refCycles = i8080_run(ref, 40);
+			state->interruptAccumulator = 0;
+			int cycles = i8080_run(state, 40);
+			traced->interruptAccumulator = 0;
+			int tracedCycles = i8080_run(traced, 40);
+
+			success = traced->debug->fusedPairs > 0 && cycles == refCycles && tracedCycles == refCycles && utilTest_statesMatch(state, ref) && utilTest_statesMatch(traced, ref);
+		}
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test fused pair %s; %s\t: [%s]\n", i8080_decompile(pairs[i][0]), i8080_decompile(pairs[i][1]), success ? "OK" : "FAIL");
+	}
+
+	i8080_destroyState(ref);
+	i8080_destroyState(traced);
+	state->mode = MODE_TEST;
+	state->core = CORE_SWITCH;
+	return failedTests;
+}
+
+int utilTest_idleLoop(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- idle loop tests ---\n");
+
+	// Waits on a counter the interrupt handler counts down, then halts
+	const uint8_t program[] = {
+		LXI_SP, 0x00, 0x30,
+		MVI_A, 0x03,
+		STA, 0x00, 0x20,
+		EI,
+		LDA, 0x00, 0x20, // 0x0109, the idle loop
+		ANA_A,
+		JNZ, 0x09, 0x01,
+		DI,
+		HLT
+	};
+	const uint8_t handler[] = { PUSH_PSW, LDA, 0x00, 0x20, DCR_A, STA, 0x00, 0x20, POP_PSW, EI, RET };
+
+	i8080State* ref = i8080_createState();
+
+	for (int core = 0; core < CORE_COUNT; core++) {
+		// The same program run every instruction on the switch core, and skipping on the core
+		i8080State* runs[2] = { ref, state };
+		for (int i = 0; i < 2; i++) {
+			i8080State* run = runs[i];
+			reset8080(run);
+			run->mode = MODE_TEST;
+			run->core = i == 0 ? CORE_SWITCH : core;
+			run->idle.enabled = i == 1;
+			memcpy(run->memory + 0x0100, program, sizeof(program));
+			memcpy(run->memory + 0x0040, handler, sizeof(handler));
+			run->memory[INTERRUPT_1] = JMP; run->memory[INTERRUPT_1 + 1] = 0x40;
+			run->memory[INTERRUPT_2] = JMP; run->memory[INTERRUPT_2 + 1] = 0x40;
+			run->pc = 0x0100;
+
+			run->interruptAccumulator = 0;
+			run->interruptIndex = 0;
+			for (int slice = 0; slice < 100 && run->mode == MODE_TEST; slice++)
+				i8080_run(run, 5000);
+		}
+
+		bool success = ref->mode == MODE_HLT && utilTest_statesMatch(state, ref) && state->cyclesExecuted == ref->cyclesExecuted
+			&& state->idle.head == 0x0109 && state->idle.skippedCycles > 0 && ref->idle.skippedCycles == 0;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test idle loop skip (core %s)\t\t\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+
+	// Waits in the same loop three times with a halt between, all in one run, so the passes after each wake are timed
+	// across the sleep
+	const uint8_t halting[] = {
+		LXI_SP, 0x00, 0x30,
+		MVI_A, 0x03,
+		STA, 0x01, 0x20,
+		EI,
+		MVI_A, 0x03, // 0x0109
+		STA, 0x00, 0x20,
+		LDA, 0x00, 0x20, // 0x010E, the idle loop
+		ANA_A,
+		JNZ, 0x0E, 0x01,
+		HLT,
+		LDA, 0x01, 0x20,
+		DCR_A,
+		STA, 0x01, 0x20,
+		JNZ, 0x09, 0x01,
+		DI,
+		HLT
+	};
+	for (int core = 0; core < CORE_COUNT; core++) {
+		i8080State* runs[2] = { ref, state };
+		for (int i = 0; i < 2; i++) {
+			i8080State* run = runs[i];
+			reset8080(run);
+			run->mode = MODE_TEST;
+			run->core = i == 0 ? CORE_SWITCH : core;
+			run->idle.enabled = i == 1;
+			memcpy(run->memory + 0x0100, halting, sizeof(halting));
+			memcpy(run->memory + 0x0040, handler, sizeof(handler));
+			run->memory[INTERRUPT_1] = JMP; run->memory[INTERRUPT_1 + 1] = 0x40;
+			run->memory[INTERRUPT_2] = JMP; run->memory[INTERRUPT_2 + 1] = 0x40;
+			run->pc = 0x0100;
+
+			run->interruptAccumulator = 0;
+			run->interruptIndex = 0;
+			i8080_run(run, 1000000);
+		}
+
+		bool success = ref->mode == MODE_HLT && !ref->f.ien && utilTest_statesMatch(state, ref) && state->cyclesExecuted == ref->cyclesExecuted
+			&& state->idle.head == 0x010E && state->idle.skippedCycles > 0;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test idle loop skip over halts (core %s)\t\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+
+	i8080_destroyState(ref);
+	state->idle.enabled = true;
+	state->mode = MODE_TEST;
+	state->core = CORE_SWITCH;
+	return failedTests;
+}
+
+int utilTest_haltSleep(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- halt tests ---\n");
+
+	// Halts with interrupts on, the handler counts the interrupts that wake it
+	const uint8_t program[] = {
+		LXI_SP, 0x00, 0x30,
+		EI,
+		HLT, // 0x0104
+		JMP, 0x04, 0x01
+	};
+	const uint8_t handler[] = { PUSH_PSW, LDA, 0x00, 0x20, INR_A, STA, 0x00, 0x20, POP_PSW, EI, RET };
+	const int budget = 3 * 17066 + 100;
+
+	i8080State* ref = i8080_createState();
+
+	// The switch core first, then every core and the wide core has to sleep the same way. CORE_COUNT stands for the wide core
+	int refCycles = 0;
+	for (int core = 0; core <= CORE_COUNT; core++) {
+		i8080State* run = core == CORE_SWITCH ? ref : state;
+		reset8080(run);
+		run->mode = MODE_TEST;
+		run->core = core == CORE_COUNT ? CORE_SWITCH : core;
+		memcpy(run->memory + 0x0100, program, sizeof(program));
+		memcpy(run->memory + 0x0040, handler, sizeof(handler));
+		run->memory[INTERRUPT_1] = JMP; run->memory[INTERRUPT_1 + 1] = 0x40;
+		run->memory[INTERRUPT_2] = JMP; run->memory[INTERRUPT_2 + 1] = 0x40;
+		run->pc = 0x0100;
+
+		int cycles;
+		if (core == CORE_COUNT) {
+			i8080Wide wide;
+			i8080_wideInit(&wide, &run, 1);
+			cycles = i8080_runWide(&wide, budget);
+		}
+		else {
+			cycles = i8080_run(run, budget);
+		}
+		if (core == CORE_SWITCH)
+			refCycles = cycles;
+
+		// One run sleeps through all three frames, and is woken by each interrupt
+		bool success = run->memory[0x2000] == 3 && run->mode == MODE_HLT && cycles >= budget && cycles == refCycles
+			&& run->cyclesExecuted == (unsigned long)cycles && utilTest_statesMatch(run, ref);
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test HLT sleeps to the interrupt (core %s)\t\t: [%s]\n", core == CORE_COUNT ? "wide" : getCoreStr(core), success ? "OK" : "FAIL");
+	}
+
+	// With interrupts off nothing can wake it, the run stops at the HLT and later runs take no time
+	reset8080(state);
+	state->mode = MODE_TEST;
+	state->pc = 0x0100;
+	state->memory[0x0100] = DI;
+	state->memory[0x0101] = HLT;
+	state->interruptAccumulator = 0;
+	int cycles = i8080_run(state, budget);
+	bool success = cycles == 11 && state->mode == MODE_HLT && i8080_run(state, budget) == 0 && state->cyclesExecuted == 11;
+	state->mode = MODE_TEST;
+	success = success && i8080_run(state, 4) == 4 && state->pc == 0x0103;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test HLT with interrupts off stays halted\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	i8080_destroyState(ref);
+	state->mode = MODE_TEST;
+	state->core = CORE_SWITCH;
+	return failedTests;
+}
+
+int utilTest_timing(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	uint32_t seed = 0x7157;
+	fprintf(testLog, "\n--- timing tests ---\n");
+
+	i8080State* ref = i8080_createState();
+	ref->core = CORE_SWITCH;
+
+	// Without interrupts the two timings run the same instructions for the same cycles, whatever core runs them
+	for (int core = 0; core < CORE_COUNT; core++) {
+		state->core = core;
+		bool success = true;
+		for (int trial = 0; trial < 16 && success; trial++) {
+			utilTest_randomState(ref, &seed, true);
+			utilTest_copyState(state, ref);
+			state->timing = TIMING_ACCURATE;
+
+			ref->interruptAccumulator = 0;
+			int refCycles = i8080_run(ref, 200);
+			state->interruptAccumulator = 0;
+			int cycles = i8080_run(state, 200);
+			success = cycles == refCycles && state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+		}
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test accurate timing runs as fast (core %s)\t\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+	state->core = CORE_SWITCH;
+
+	// IN and OUT reach the bus 7 T-states into the instruction, the fast timing stamps them with its start
+	const uint8_t io[] = { NOP, OUT, 0x03, HLT, NOP, IN, 0x01, HLT };
+	unsigned long ioCycles[2][2];
+	for (int timing = 0; timing < 2; timing++) {
+		reset8080(state);
+		state->mode = MODE_TEST;
+		state->timing = timing;
+		memcpy(state->memory + 0x0100, io, sizeof(io));
+		state->pc = 0x0100;
+		state->interruptAccumulator = 0;
+		i8080_run(state, 100);
+		ioCycles[timing][0] = state->ioCycle;
+		state->mode = MODE_TEST;
+		i8080_run(state, 100);
+		ioCycles[timing][1] = state->ioCycle;
+	}
+	bool success = ioCycles[TIMING_FAST][0] == 4 && ioCycles[TIMING_ACCURATE][0] == 4 + 7 && ioCycles[TIMING_FAST][1] == 25 && ioCycles[TIMING_ACCURATE][1] == 25 + 7;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test IN/OUT bus cycle\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// Acknowledging the frame interrupt costs the accurate timing the 11 T-states of an RST
+	const uint8_t spin[] = { EI, JMP, 0x01, 0x01 };
+	unsigned long haltedAt[2];
+	for (int timing = 0; timing < 2; timing++) {
+		reset8080(state);
+		state->mode = MODE_TEST;
+		state->timing = timing;
+		memcpy(state->memory + 0x0100, spin, sizeof(spin));
+		state->memory[INTERRUPT_1] = DI;
+		state->memory[INTERRUPT_1 + 1] = HLT;
+		state->pc = 0x0100;
+		state->sp = 0x3000;
+		state->interruptAccumulator = 0;
+		state->interruptIndex = 1;
+		i8080_run(state, 20000);
+		haltedAt[timing] = state->mode == MODE_HLT && state->pc == INTERRUPT_1 + 2 ? state->cyclesExecuted : 0;
+	}
+	success = haltedAt[TIMING_FAST] > 0 && haltedAt[TIMING_ACCURATE] == haltedAt[TIMING_FAST] + 11;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test interrupt acknowledge cycles\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	i8080_destroyState(ref);
+	state->timing = TIMING_FAST;
+	state->mode = MODE_TEST;
+	return failedTests;
+}
+
+// Runs the machine has counted for a routine of the HLE registry, and its mismatches over the whole registry
+static unsigned long hleTestRuns(i8080State* state, int routine) {
+	i8080HleFound* found = i8080_hleFind(state, routine);
+	return found == NULL ? 0 : found->runs;
+}
+
+static unsigned long hleTestMismatches(i8080State* state) {
+	unsigned long mismatches = 0;
+	for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+		i8080HleFound* found = i8080_hleFind(state, i);
+		mismatches += found == NULL ? 0 : found->mismatches;
+	}
+	return mismatches;
+}
+
+int utilTest_hle(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- HLE tests ---\n");
+
+	i8080State* ref = i8080_createState();
+	unsigned long runs[HLE_ROUTINE_COUNT];
+
+	// Each core with HLE on has to stay with the switch core running every instruction slice after slice, with the frame
+	// interrupts landing part way through the routines
+	for (int core = 0; core <= CORE_COUNT; core++) {
+		// CORE_COUNT runs the switch core again under HLE_VERIFY
+		int hle = core == CORE_COUNT ? HLE_VERIFY : HLE_ON;
+		utilTest_hleProgram(ref, CORE_SWITCH, HLE_OFF);
+		utilTest_hleProgram(state, core == CORE_COUNT ? CORE_SWITCH : core, hle);
+		unsigned long mismatches = hleTestMismatches(state);
+		for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+			runs[i] = hleTestRuns(state, i);
+		}
+
+		bool success = true;
+		while (success && ref->mode != MODE_HLT && ref->cyclesExecuted < 1000000) {
+			i8080_run(ref, 5000);
+			i8080_run(state, 5000);
+
+			success = state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+		}
+		// Every routine was taken at least once, and the interrupts counted by the handler came part way through them
+		success = success && ref->mode == MODE_HLT && ref->memory[0x20F0] > 10;
+		for (int i = 0; i < HLE_ROUTINE_COUNT; i++) {
+			success = success && hleTestRuns(state, i) > runs[i];
+		}
+		success = success && hleTestMismatches(state) == mismatches && hleTestRuns(ref, 0) == 0;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test HLE matches the ROM code (core %s%s)\t\t: [%s]\n", getCoreStr(state->core), hle == HLE_VERIFY ? ", verify" : "", success ? "OK" : "FAIL");
+	}
+
+	// Changed code no longer hashes as the routine, and runs as it is
+	utilTest_hleProgram(ref, CORE_SWITCH, HLE_OFF);
+	utilTest_hleProgram(state, CORE_SWITCH, HLE_ON);
+	ref->memory[0x1A37] = state->memory[0x1A37] = INX_H; // JNZ 1A32 to INX H, so BlockCopy copies a single byte
+	runs[1] = hleTestRuns(state, 1);
+	ref->interruptAccumulator = 0;
+	i8080_run(ref, 1000000);
+	state->interruptAccumulator = 0;
+	i8080_run(state, 1000000);
+	bool success = hleTestRuns(state, 1) == runs[1] && state->mode == MODE_HLT && state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test HLE leaves changed code to the ROM\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// A native routine that does not do what the ROM code does is caught under HLE_VERIFY, and the run still follows the ROM
+	void (*run)(i8080State* state, int passes) = i8080_hleRoutines[1].run;
+	i8080_hleRoutines[1].run = i8080_hleRoutines[0].run;
+	unsigned long mismatches = hleTestMismatches(state);
+	unsigned long cycles = i8080_hleCycles(state);
+	utilTest_hleProgram(state, CORE_SWITCH, HLE_VERIFY);
+	state->interruptAccumulator = 0;
+	i8080_run(state, 1000000);
+	utilTest_hleProgram(ref, CORE_SWITCH, HLE_OFF);
+	ref->interruptAccumulator = 0;
+	i8080_run(ref, 1000000);
+	i8080_hleRoutines[1].run = run;
+	success = hleTestMismatches(state) > mismatches && i8080_hleCycles(state) > cycles && state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test HLE_VERIFY catches a wrong routine\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// A store into a routine found before forgets it: the program copies a block, turns the JNZ of BlockCopy into INX H and
+	// copies again, which has to run the changed code. The JIT compiles every block, so its own stores are checked too
+	const uint8_t rewrite[] = {
+		LXI_SP, 0x00, 0x24,
+		LXI_H, 0x00, 0x30, LXI_D, 0x00, 0x02, MVI_B, 0x20, CALL, 0x32, 0x1A,
+		MVI_A, INX_H, STA, 0x37, 0x1A,
+		LXI_H, 0x00, 0x31, LXI_D, 0x00, 0x02, MVI_B, 0x20, CALL, 0x32, 0x1A,
+		DI,
+		HLT
+	};
+	int hotThreshold = jit_hotThreshold;
+	jit_hotThreshold = 0;
+	for (int core = 0; core < CORE_COUNT; core++) {
+		utilTest_hleProgram(ref, CORE_SWITCH, HLE_OFF);
+		utilTest_hleProgram(state, core, HLE_ON);
+		memcpy(ref->memory + 0x0100, rewrite, sizeof(rewrite));
+		memcpy(state->memory + 0x0100, rewrite, sizeof(rewrite));
+		runs[1] = hleTestRuns(state, 1);
+		i8080_run(ref, 1000000);
+		i8080_run(state, 1000000);
+		success = hleTestRuns(state, 1) == runs[1] + 1 && i8080_hleFind(state, 1)->match == HLE_MATCH_NONE && state->mode == MODE_HLT
+			&& state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test HLE forgets a routine written over (core %s)\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+	jit_hotThreshold = hotThreshold;
+
+	i8080_destroyState(ref);
+	reset8080(state);
+	state->hle = HLE_OFF;
+	state->mode = MODE_TEST;
+	return failedTests;
+}
+
+void utilTest_hleProgram(i8080State* state, int core, int hle) {
+	// The routines as the invaders ROM has them
+	const uint8_t clearScreen[] = { LXI_H, 0x00, 0x24, MVI_M, 0x00, INX_H, MOV_AH, CPI, 0x40, JNZ, 0x5F, 0x1A, RET };
+	const uint8_t blockCopy[] = { LDAX_D, MOV_MA, INX_H, INX_D, DCR_B, JNZ, 0x32, 0x1A, RET };
+	const uint8_t drawSprite[] = { PUSH_B, LDAX_D, MOV_MA, INX_D, LXI_B, 0x20, 0x00, DAD_B, POP_B, DCR_B, JNZ, 0x39, 0x14, RET };
+	// Clears the screen, copies 256 bytes onto it and draws a column of 64 more down it
+	const uint8_t program[] = {
+		LXI_SP, 0x00, 0x24,
+		EI,
+		CALL, 0x5C, 0x1A,
+		LXI_H, 0x00, 0x30, LXI_D, 0x00, 0x02, MVI_B, 0x00, CALL, 0x32, 0x1A,
+		LXI_H, 0x10, 0x28, LXI_D, 0x80, 0x02, MVI_B, 0x40, CALL, 0x39, 0x14,
+		DI,
+		HLT
+	};
+	// Counts the interrupts
+	const uint8_t handler[] = { PUSH_PSW, LDA, 0xF0, 0x20, INR_A, STA, 0xF0, 0x20, POP_PSW, EI, RET };
+
+	reset8080(state);
+	state->mode = MODE_TEST;
+	i8080_busMap(state, &i8080_flatMap);
+	state->core = core;
+	state->hle = hle;
+	state->idle.enabled = false;
+	memcpy(state->memory + 0x1A5C, clearScreen, sizeof(clearScreen));
+	memcpy(state->memory + 0x1A32, blockCopy, sizeof(blockCopy));
+	memcpy(state->memory + 0x1439, drawSprite, sizeof(drawSprite));
+	memcpy(state->memory + 0x0100, program, sizeof(program));
+	memcpy(state->memory + 0x0040, handler, sizeof(handler));
+	state->memory[INTERRUPT_1] = JMP; state->memory[INTERRUPT_1 + 1] = 0x40;
+	state->memory[INTERRUPT_2] = JMP; state->memory[INTERRUPT_2 + 1] = 0x40;
+	for (int i = 0; i < 0x100; i++) {
+		state->memory[0x0200 + i] = (uint8_t)(i * 37 + 11);
+	}
+	// Leftovers on the screen for the clear to wipe
+	memset(state->memory + 0x2400, 0xA5, 0x1C00);
+	state->pc = 0x0100;
+	state->cyclesExecuted = 0;
+}
+
+int utilTest_memo(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- memoisation tests ---\n");
+
+	i8080State* ref = i8080_createState();
+
+	// Each core with memoisation on has to stay with the switch core running every call slice after slice, with the frame
+	// interrupts landing part way through the calls and the memory the pure routine reads changed part way through the run
+	for (int core = 0; core <= CORE_COUNT; core++) {
+		// CORE_COUNT runs the switch core again under MEMO_PROFILE
+		int memo = core == CORE_COUNT ? MEMO_PROFILE : MEMO_ON;
+		utilTest_memoProgram(ref, CORE_SWITCH, MEMO_OFF);
+		utilTest_memoProgram(state, core == CORE_COUNT ? CORE_SWITCH : core, memo);
+
+		bool success = true;
+		bool changed = false;
+		while (success && ref->mode != MODE_HLT && ref->cyclesExecuted < 2000000) {
+			if (!changed && ref->cyclesExecuted > 100000) {
+				ref->memory[0x2010] = state->memory[0x2010] = 0x37;
+				changed = true;
+			}
+
+			i8080_run(ref, 5000);
+			i8080_run(state, 5000);
+
+			success = state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+		}
+		success = success && ref->mode == MODE_HLT && ref->memory[0x20F0] > 10;
+
+		// Each machine keeps its own routines, resetting another one leaves them be
+		reset8080(ref);
+		i8080MemoRoutine* pure = i8080_memoFind(state, 0x0800);
+		i8080MemoRoutine* impure = i8080_memoFind(state, 0x0820);
+		// The block cores turn memoisation off
+		if (state->core == CORE_BLOCK || state->core == CORE_JIT)
+			success = success && state->memo == MEMO_OFF && pure == NULL && i8080_memoFind(ref, 0x0800) == NULL;
+		else if (memo == MEMO_PROFILE)
+			success = success && pure != NULL && pure->impure == NULL && pure->repeats > 0 && pure->hits == 0 && impure != NULL && impure->impure != NULL;
+		else
+			success = success && pure != NULL && pure->impure == NULL && pure->hits > 0 && pure->misses > 0 && impure != NULL && impure->impure != NULL && impure->hits == 0
+				&& i8080_memoFind(ref, 0x0800) == NULL;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test memoised calls match the ROM code (core %s%s)\t: [%s]\n", getCoreStr(state->core), memo == MEMO_PROFILE ? ", profile" : "", success ? "OK" : "FAIL");
+	}
+
+	i8080_destroyState(ref);
+	reset8080(state);
+	state->memo = MEMO_OFF;
+	state->mode = MODE_TEST;
+	i8080_busMap(state, &i8080_flatMap);
+	return failedTests;
+}
+
+int utilTest_aot(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- AOT translation tests ---\n");
+
+	// A change to the generator or the program shows as a new fingerprint, the file written beside the log is the one to build in
+	const uint16_t entryPoints[] = { 0x0100, INTERRUPT_1, INTERRUPT_2 };
+	utilTest_memoProgram(state, CORE_SWITCH, MEMO_OFF);
+	uint32_t hash = 0;
+	bool success = i8080_aotTranslate(state, entryPoints, 3, "i8080_aot_test.c", "i8080_aotTestRun") && i8080_aotReadHash("i8080_aot_test.c", &hash)
+		&& hash == i8080_aotTestRunHash;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test AOT translation matches i8080_aot_test.c\t\t: [%s]\n", success ? "OK" : "FAIL");
+	if (!success)
+		fprintf(testLog, "\tFingerprint %08X, built in %08X: copy the new i8080_aot_test.c over src/i8080_aot_test.c\n", hash, i8080_aotTestRunHash);
+
+	// The translation has to stay with the switch core slice after slice, frame interrupts landing inside blocks included
+	i8080State* ref = i8080_createState();
+	utilTest_memoProgram(ref, CORE_SWITCH, MEMO_OFF);
+	utilTest_memoProgram(state, CORE_SWITCH, MEMO_OFF);
+	success = true;
+	while (success && ref->mode != MODE_HLT && ref->cyclesExecuted < 2000000) {
+		i8080_run(ref, 5000);
+		i8080_aotTestRun(state, 5000);
+
+		success = state->cyclesExecuted == ref->cyclesExecuted && utilTest_statesMatch(state, ref);
+	}
+	success = success && ref->mode == MODE_HLT && ref->memory[0x20F0] > 10;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test AOT translation in lockstep with switch, %lu cycles\t: [%s]\n", ref->cyclesExecuted, success ? "OK" : "FAIL");
+
+	i8080_destroyState(ref);
+	reset8080(state);
+	state->mode = MODE_TEST;
+	i8080_busMap(state, &i8080_flatMap);
+	return failedTests;
+}
+
+int utilTest_system(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- system tests ---\n");
+
+	// Each processor reads its index from its own port 0 and mixes the bytes of page 0x40 + index over and over
+	const uint8_t program[] = {
+		IN, 0x00, ADI, 0x40, MOV_HA, MVI_L, 0x00,
+		MOV_AM, ADD_L, RLC, XRA_B, MOV_MA, INR_B, INR_L, JMP, 0x07, 0x01
+	};
+	const int cpuCount = 4;
+	const int quantum = 1000;
+	const int quanta = 50;
+
+	i8080System* system = i8080_systemCreate(cpuCount, quantum);
+	memcpy(system->memory + 0x0100, program, sizeof(program));
+	for (int i = 0; i < cpuCount; i++) {
+		i8080State* cpu = system->cpus[i].state;
+		cpu->core = i % 3 == 0 ? CORE_SWITCH : i % 3 == 1 ? CORE_TABLE : CORE_THREADED;
+		cpu->inPorts[0] = i;
+		cpu->pc = 0x0100;
+	}
+	unsigned long cycles = i8080_systemRun(system, quanta / 2);
+	cycles += i8080_systemRun(system, quanta - quanta / 2);
+
+	// A lone state given the same budgets has to end the same, with the same page
+	i8080State* ref = i8080_createState();
+	bool success = cycles >= (unsigned long)cpuCount * quantum * quanta;
+	for (int i = 0; i < cpuCount && success; i++) {
+		reset8080(ref);
+		ref->mode = MODE_TEST;
+		i8080_boardAttach(ref, &i8080_bareBoard);
+		ref->core = CORE_SWITCH;
+		ref->idle.enabled = false;
+		ref->hle = HLE_OFF;
+		ref->inPorts[0] = i;
+		ref->pc = 0x0100;
+		ref->cyclesExecuted = 0;
+		memcpy(ref->memory + 0x0100, program, sizeof(program));
+		for (int q = 0; q < quanta; q++) {
+			unsigned long end = (unsigned long)(q + 1) * quantum;
+			if (ref->cyclesExecuted < end)
+				i8080_run(ref, (int)(end - ref->cyclesExecuted));
+		}
+
+		i8080State* cpu = system->cpus[i].state;
+		int page = (0x40 + i) << 8;
+		success = cpu->cyclesExecuted == ref->cyclesExecuted && system->cpus[i].cycles == ref->cyclesExecuted && cpu->pc == ref->pc && cpu->sp == ref->sp
+			&& i8080op_getPSW(cpu) == i8080op_getPSW(ref) && i8080op_getBC(cpu) == i8080op_getBC(ref) && i8080op_getDE(cpu) == i8080op_getDE(ref) && i8080op_getHL(cpu) == i8080op_getHL(ref)
+			&& memcmp(system->memory + page, ref->memory + page, 0x100) == 0;
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test system processors match lone states\t\t: [%s]\n", success ? "OK" : "FAIL");
+	i8080_destroyState(ref);
+	i8080_systemDestroy(system);
+
+	// Both processors write the region at 3000 from their ports: a store read back, a call with the stack in the region, a
+	// loop storing the count at 3001, complemented on the second, and a byte each at 3002 + index. Each has to read its own
+	// writes back, the first processor's held writes have to stand, and every run has to end the same
+	const uint8_t contend[] = {
+		IN, 0x01, MOV_LA, MVI_H, 0x30, SPHL,
+		IN, 0x00, STA, 0x00, 0x30, MVI_A, 0x00, LDA, 0x00, 0x30, MOV_BA,
+		CALL, 0x2C, 0x01,
+		IN, 0x02, MOV_CA, IN, 0x03, MOV_EA,
+		MOV_AC, XRA_E, STA, 0x01, 0x30, DCR_C, JNZ, 0x1A, 0x01,
+		IN, 0x04, MOV_LA, MVI_H, 0x30, IN, 0x00, MOV_MA, HLT,
+		RET
+	};
+	const uint8_t contendPorts[2][5] = { { 0x11, 0x40, 100, 0x00, 0x02 }, { 0x22, 0x80, 200, 0xFF, 0x03 } };
+	success = true;
+	for (int run = 0; run < 4 && success; run++) {
+		system = i8080_systemCreate(2, 10000);
+		// A return address read from the shared memory instead of the held writes lands on this HLT
+		system->memory[0x0000] = HLT;
+		memcpy(system->memory + 0x0100, contend, sizeof(contend));
+		success = i8080_systemAddRegion(system, 0x3000, 0x100) && !i8080_systemAddRegion(system, 0x30FF, 1);
+		for (int i = 0; i < 2; i++) {
+			memcpy(system->cpus[i].state->inPorts, contendPorts[i], sizeof(contendPorts[i]));
+			system->cpus[i].state->pc = 0x0100;
+		}
+		i8080_systemRun(system, 2);
+		for (int i = 0; i < 2; i++) {
+			const i8080State* cpu = system->cpus[i].state;
+			success = success && cpu->mode == MODE_HLT && cpu->pc == 0x012C && cpu->b == contendPorts[i][0]
+				&& system->cpus[i].heldWrites == 4 + (unsigned long)contendPorts[i][2];
+		}
+		success = success && system->regions[0].claims == 1 && system->regions[0].owner == SYSTEM_NO_OWNER
+			&& system->memory[0x3000] == 0x11 && system->memory[0x3001] == 0x01 && system->memory[0x3002] == 0x11 && system->memory[0x3003] == 0x22
+			&& system->memory[0x303E] == 0x14 && system->memory[0x307E] == 0x14;
+		i8080_systemDestroy(system);
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test system contended region\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	return failedTests;
+}
+
+// The handled page of the utilTest_bus map, reading as the low byte of the address mixed with 5A and noting its accesses
+static int busTestReads;
+static int busTestWrites;
+static uint16_t busTestAddress;
+static uint8_t busTestValue;
+
+static uint8_t busTestRead(i8080State* state, uint16_t address) {
+	busTestReads++;
+	return (address & 0xFF) ^ 0x5A;
+}
+
+static void busTestWrite(i8080State* state, uint16_t address, uint8_t value) {
+	busTestWrites++;
+	busTestAddress = address;
+	busTestValue = value;
+}
+
+// The code page of the utilTest_bus map, a program only its read handler serves: MVI A,41 INR A STA 0020 LXI H,0030 MVI M,99 HLT
+static const uint8_t busTestCode[] = { MVI_A, 0x41, INR_A, STA, 0x20, 0x00, LXI_H, 0x30, 0x00, MVI_M, 0x99, HLT };
+
+static uint8_t busTestCodeRead(i8080State* state, uint16_t address) {
+	return (address & 0xFF) < sizeof(busTestCode) ? busTestCode[address & 0xFF] : NOP;
+}
+
+static const i8080BusRegion busTestRegions[] = {
+	{ 0x0000, 0x8000, 0x0000, 0, NULL, NULL }, // RAM
+	{ 0x8000, 0x0100, 0x0000, 0, busTestRead, busTestWrite }, // the handled page
+	{ 0x8100, 0x0100, 0x0000, 0, busTestCodeRead, busTestWrite }, // the code page
+	{ 0xC000, 0x1000, 0x0000, 0x0100, NULL, NULL }, // page 00 of the RAM again every 0x100
+};
+
+static const i8080MemoryMap busTestMap = { "bus test", sizeof(busTestRegions) / sizeof(busTestRegions[0]), busTestRegions };
+
+int utilTest_bus(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- memory bus tests ---\n");
+
+	// Invaders RAM shows up again every 0x2000 up to FFFF, and the ROM drops the writes to it
+	reset8080(state);
+	i8080_busMap(state, &i8080_invadersMap);
+	state->memory[0x0100] = NOP;
+	i8080op_writeMemory(state, 0x6123, 0x77);
+	i8080op_writeMemory(state, 0x0100, 0x77);
+	bool success = state->memory[0x2123] == 0x77 && i8080op_readMemory(state, 0xE123) == 0x77 && *i8080_hostPointer(state, 0xA123) == 0x77
+		&& state->memory[0x0100] == NOP && i8080op_readMemory(state, 0x0100) == NOP && i8080_busReadOnly(state, 0x1FFE, 2) && !i8080_busReadOnly(state, 0x1FFF, 2);
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test bus invaders map\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// Reads the handled page and writes what it read back to it and through the window, then writes and reads an unmapped page
+	// The JIT compiles every block straight away so its native code takes the out of line paths
+	const uint8_t program[] = { LDA, 0x05, 0x80, STA, 0x06, 0x80, STA, 0x10, 0xC3, STA, 0x00, 0x90, LDA, 0x00, 0x90, MOV_BA, LDA, 0x10, 0xC0, HLT };
+	int hotThreshold = jit_hotThreshold;
+	jit_hotThreshold = 0;
+	for (int core = 0; core < CORE_COUNT; core++) {
+		reset8080(state);
+		state->mode = MODE_TEST;
+		i8080_busMap(state, &busTestMap);
+		state->core = core;
+		state->idle.enabled = false;
+		state->hle = HLE_OFF;
+		memcpy(state->memory + 0x0100, program, sizeof(program));
+		state->pc = 0x0100;
+		busTestReads = busTestWrites = 0;
+		state->interruptAccumulator = 0;
+		i8080_run(state, 1000);
+
+		success = state->mode == MODE_HLT && busTestReads == 1 && busTestWrites == 1 && busTestAddress == 0x8006 && busTestValue == 0x5F
+			&& state->memory[0x0010] == 0x5F && state->a == 0x5F && state->b == 0x00 && state->memory[0x9000] == 0x00;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test bus handled, mirrored and unmapped pages (core %s)\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+
+		// Code on a page with a read handler is fetched through the handler, not the memory behind the page
+		reset8080(state);
+		state->mode = MODE_TEST;
+		i8080_busMap(state, &busTestMap);
+		state->core = core;
+		state->idle.enabled = false;
+		state->hle = HLE_OFF;
+		memset(state->memory, HLT, 0x100);
+		state->pc = 0x8100;
+		state->interruptAccumulator = 0;
+		i8080_run(state, 1000);
+
+		success = state->mode == MODE_HLT && state->pc == 0x8100 + sizeof(busTestCode) && state->a == 0x42 && state->memory[0x0020] == 0x42
+			&& state->memory[0x0030] == 0x99;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test bus fetch through a read handler (core %s)\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+
+		// A block that writes an INR A over its own NOP runs the INR A: MVI A,3C STA 0107 MVI B,01 NOP HLT
+		const uint8_t overwrite[] = { MVI_A, INR_A, STA, 0x07, 0x01, MVI_B, 0x01, NOP, HLT };
+		reset8080(state);
+		state->mode = MODE_TEST;
+		state->core = core;
+		state->idle.enabled = false;
+		state->hle = HLE_OFF;
+		memcpy(state->memory + 0x0100, overwrite, sizeof(overwrite));
+		state->pc = 0x0100;
+		state->interruptAccumulator = 0;
+		i8080_run(state, 1000);
+
+		success = state->mode == MODE_HLT && state->pc == 0x0109 && state->a == INR_A + 1 && state->b == 0x01;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test block writing over its own code (core %s)\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+	jit_hotThreshold = hotThreshold;
+
+	// Every page knows the memory behind it, an unmapped page has none and stands for itself
+	success = i8080op_mirrorAddress(state, 0xC310) == 0x0010 && i8080op_mirrorAddress(state, 0x9012) == 0x9012 && i8080op_mirrorAddress(state, 0x7FFF) == 0x7FFF;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test bus i8080op_mirrorAddress\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	reset8080(state);
+	state->mode = MODE_TEST;
+	i8080_busMap(state, &i8080_flatMap);
+	return failedTests;
+}
+
+// A board raising RST 1 every 1000 cycles, for utilTest_board
+static const i8080Board boardTestFast = { "fast", &i8080_flatMap, 1000, 1, { INTERRUPT_1 }, NULL, NULL, { 0x0000, 64, 64 } };
+// Raises RST 1, 2 and 3 in turn, one every 1000 cycles
+static const i8080Board boardTestThree = { "three", &i8080_flatMap, 1000, 3, { INTERRUPT_1, INTERRUPT_2, INTERRUPT_3 }, NULL, NULL, { 0x0000, 64, 64 } };
+
+int utilTest_board(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+	fprintf(testLog, "\n--- board tests ---\n");
+
+	bool success = true;
+	for (int i = 0; i < BOARD_COUNT; i++) {
+		success = success && i8080_boardFind(i8080_boards[i]->name) == i8080_boards[i];
+	}
+	success = success && i8080_boardFind("unknown") == NULL;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test i8080_boardFind\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	// Shifts AB then CD into the shift register and reads it 3 bits down from the top, then makes a BDOS call and jumps to
+	// the warm boot with interrupts on
+	const uint8_t program[] = { MVI_A, 0xAB, OUT, 0x04, MVI_A, 0xCD, OUT, 0x04, MVI_A, 0x03, OUT, 0x02, IN, 0x03, MOV_BA, MVI_C, 0x09, CALL, 0x05, 0x00, EI, JMP, 0x00, 0x00 };
+	const i8080Board* boards[] = { &i8080_invadersBoard, &i8080_cpmBoard, &i8080_bareBoard };
+	for (int b = 0; b < 3; b++) {
+		for (int core = 0; core < CORE_COUNT; core++) {
+			i8080_boardAttach(state, boards[b]);
+			reset8080(state);
+			state->mode = MODE_TEST;
+			state->core = core;
+			state->idle.enabled = false;
+			state->hle = HLE_OFF;
+			memcpy(state->memory + 0x0100, program, sizeof(program));
+			state->pc = 0x0100;
+			i8080_run(state, 1000);
+
+			if (boards[b] == &i8080_cpmBoard) {
+				// Halted at the warm boot for good, as nothing raises an interrupt
+				unsigned long cycles = state->cyclesExecuted;
+				success = state->b == 0x00 && state->mode == MODE_HLT && state->pc == 0x0001 && state->sp == 0x0000
+					&& i8080_run(state, 2 * i8080_invadersBoard.interruptPeriod) == 0 && state->cyclesExecuted == cycles && state->mode == MODE_HLT;
+			}
+			else {
+				// No stubs at 0 and 5 to stop it, the run goes on through zeroed memory and round the program again
+				success = state->mode == MODE_TEST && state->memory[0x0005] == 0x00
+					&& state->b == (boards[b] == &i8080_invadersBoard ? ((0xCDAB >> 5) & 0xFF) : 0x00);
+			}
+			if (!success) { failedTests++; }
+			fprintf(testLog, "Test board %s (core %s)\t\t\t\t: [%s]\n", boards[b]->name, getCoreStr(core), success ? "OK" : "FAIL");
+		}
+	}
+
+	// Counts the RST 1 interrupts of a board raising one every 1000 cycles, the cores have to take them on its period
+	const uint8_t counting[] = { LXI_SP, 0x00, 0x24, EI, INX_D, JMP, 0x04, 0x01 };
+	const uint8_t handler[] = { INR_B, EI, RET };
+	uint8_t switchCount = 0;
+	for (int core = 0; core < CORE_COUNT; core++) {
+		i8080_boardAttach(state, &boardTestFast);
+		reset8080(state);
+		state->mode = MODE_TEST;
+		state->core = core;
+		state->idle.enabled = false;
+		state->hle = HLE_OFF;
+		memcpy(state->memory + INTERRUPT_1, handler, sizeof(handler));
+		memcpy(state->memory + 0x0100, counting, sizeof(counting));
+		state->pc = 0x0100;
+		i8080_run(state, 10000);
+		if (core == CORE_SWITCH)
+			switchCount = state->b;
+
+		success = state->b >= 9 && state->b == switchCount;
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test board interrupt period (core %s)\t\t\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+
+	// The same count on a board raising three interrupts, each handler counting its own. Every one has to come round in turn
+	const uint8_t handlers[] = { INR_B, EI, RET, 0, 0, 0, 0, 0, INR_C, EI, RET, 0, 0, 0, 0, 0, INR_L, EI, RET };
+	uint8_t switchCounts[3] = { 0 };
+	for (int core = 0; core < CORE_COUNT; core++) {
+		i8080_boardAttach(state, &boardTestThree);
+		reset8080(state);
+		state->mode = MODE_TEST;
+		state->core = core;
+		state->idle.enabled = false;
+		state->hle = HLE_OFF;
+		memcpy(state->memory + INTERRUPT_1, handlers, sizeof(handlers));
+		memcpy(state->memory + 0x0100, counting, sizeof(counting));
+		state->pc = 0x0100;
+		i8080_run(state, 10000);
+		if (core == CORE_SWITCH) {
+			switchCounts[0] = state->b;
+			switchCounts[1] = state->c;
+			switchCounts[2] = state->l;
+		}
+
+		success = state->l >= 3 && state->b - state->l <= 1 && state->b >= state->c && state->c >= state->l
+			&& state->b == switchCounts[0] && state->c == switchCounts[1] && state->l == switchCounts[2];
+		if (!success) { failedTests++; }
+		fprintf(testLog, "Test board interrupts in turn (core %s)\t\t\t: [%s]\n", getCoreStr(core), success ? "OK" : "FAIL");
+	}
+
+	// The interrupt timing is the machine's own, a reset starts it over rather than leaving it part way to the next interrupt
+	success = state->interruptAccumulator != 0;
+	reset8080(state);
+	success = success && state->interruptAccumulator == 0 && state->interruptIndex == 0;
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test reset clears the interrupt timing\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	i8080_boardAttach(state, &i8080_invadersBoard);
+	reset8080(state);
+	state->mode = MODE_TEST;
+	i8080_busMap(state, &i8080_flatMap);
+	return failedTests;
+}
+
+void utilTest_memoProgram(i8080State* state, int core, int memo) {
+	// Counts 0x800 passes, calling a routine that counts too, a pure one built on a nested call and one reading a port
+	const uint8_t program[] = {
+		LXI_SP, 0x00, 0x24,
+		EI,
+		CALL, 0x30, 0x08, CALL, 0x00, 0x08, CALL, 0x20, 0x08,
+		LDA, 0x02, 0x20, INR_A, STA, 0x02, 0x20, JNZ, 0x04, 0x01,
+		LDA, 0x03, 0x20, INR_A, STA, 0x03, 0x20, CPI, 0x08, JNZ, 0x04, 0x01,
+		DI,
+		HLT
+	};
+	// Mixes A with the byte at 2010 and stores the result at 2011, the stack is written and read back on the way
+	const uint8_t pure[] = { PUSH_H, LXI_H, 0x10, 0x20, MOV_EM, ADD_E, CALL, 0x10, 0x08, STA, 0x11, 0x20, POP_H, RET };
+	const uint8_t mix[] = { RLC, XRI, 0x5A, RET };
+	const uint8_t port[] = { IN, 0x01, RET };
+	// Leaves A at the next value of a counter, never the same inputs twice in a row
+	const uint8_t counter[] = { LDA, 0x00, 0x20, INR_A, STA, 0x00, 0x20, ANI, 0x03, RET };
+	// Counts the interrupts
+	const uint8_t handler[] = { PUSH_PSW, LDA, 0xF0, 0x20, INR_A, STA, 0xF0, 0x20, POP_PSW, EI, RET };
+
+	reset8080(state);
+	state->mode = MODE_NORMAL;
+	i8080_busMap(state, &i8080_invadersMap);
+	state->core = core;
+	state->memo = memo;
+	state->idle.enabled = false;
+	memcpy(state->memory + 0x0100, program, sizeof(program));
+	memcpy(state->memory + 0x0800, pure, sizeof(pure));
+	memcpy(state->memory + 0x0810, mix, sizeof(mix));
+	memcpy(state->memory + 0x0820, port, sizeof(port));
+	memcpy(state->memory + 0x0830, counter, sizeof(counter));
+	memcpy(state->memory + 0x0040, handler, sizeof(handler));
+	state->memory[INTERRUPT_1] = JMP; state->memory[INTERRUPT_1 + 1] = 0x40;
+	state->memory[INTERRUPT_2] = JMP; state->memory[INTERRUPT_2 + 1] = 0x40;
+	state->memory[0x2010] = 0x21;
+	state->inPorts[1] = 0x80;
+	state->pc = 0x0100;
+	state->cyclesExecuted = 0;
+}
+
+void utilTest_randomState(i8080State* state, uint32_t* seed, bool documentedOnly) {
+	for (int i = 0; i < i8080_MEMORY_SIZE; i++) {
+		do {
+			*seed = *seed * 1103515245 + 12345;
+			state->memory[i] = (*seed >> 16) & 0xFF;
+		} while (documentedOnly && strcmp(i8080_decompile(state->memory[i]), "unknown") == 0);
+	}
+	*seed = *seed * 1103515245 + 12345;
+	i8080op_putBC16(state, *seed >> 8);
+	*seed = *seed * 1103515245 + 12345;
+	i8080op_putDE16(state, *seed >> 8);
+	*seed = *seed * 1103515245 + 12345;
+	i8080op_putHL16(state, *seed >> 8);
+	*seed = *seed * 1103515245 + 12345;
+	state->a = *seed >> 16;
+	state->sp = 0x4000 + ((*seed >> 8) & 0x7FFF);
+	*seed = *seed * 1103515245 + 12345;
+	i8080op_putFlags(state, *seed >> 16);
+	SET_FLAG(state, FLAG_C, (*seed >> 24) & 1);
+	state->f.ien = 0;
+	state->f.isi = 0;
+	state->mode = MODE_TEST;
+	i8080_busMap(state, &i8080_flatMap);
+	state->pc = 0x1000;
+	state->waitCycles = 0;
+	state->cyclesExecuted = 0;
+}
+
+void utilTest_copyState(i8080State* dst, i8080State* src) {
+	// Keep the buffers, debug block, memo, HLE and core of the destination, and make it decode its copied memory afresh through
+	// a page table of its own built from the same map, on the same board with the same board registers
+	int core = dst->core;
+	uint8_t* memory = dst->memory;
+	struct i8080Bus* bus = dst->bus;
+	struct i8080MicroOp* microOps = dst->microOps;
+	struct i8080BlockCache* blockCache = dst->blockCache;
+	struct i8080Debug* debug = dst->debug;
+
+	*dst = *src;
+
+	dst->core = core;
+	dst->debug = debug;
+	dst->memory = memory;
+	dst->microOps = microOps;
+	dst->microOpsValid = false;
+	dst->blockCache = blockCache;
+	dst->blockCacheValid = false;
+	dst->bus = bus;
+	struct i8080Memo* memo = bus->memo;
+	struct i8080Hle* hle = bus->hle;
+	*dst->bus = *src->bus;
+	dst->bus->memo = memo;
+	dst->bus->hle = hle;
+	i8080_busMap(dst, src->bus->map);
+	memcpy(dst->memory, src->memory, i8080_MEMORY_SIZE);
+}
+
+int utilTest_aluTables(i8080State* state, FILE* testLog) {
+	int failedTests = 0;
+
+	bool success = i8080_buildAluTables();
+	if (!success) { failedTests++; }
+	fprintf(testLog, "\n--- ALU table tests ---\nTest i8080_buildAluTables\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+	if (!success)
+		return failedTests;
+
+	bool addMatches = true;
+	bool subMatches = true;
+	bool cmpMatches = true;
+	for (int carry = 0; carry < 2; carry++) {
+		for (int a = 0; a < 0x100; a++) {
+			for (int v = 0; v < 0x100; v++) {
+				state->f.psw = FLAG_ONE;
+				state->a = i8080op_addCarry8(state, a, v + carry);
+				i8080_acFlagSetAdd(state, state->a);
+				i8080op_setZSP(state, state->a);
+				if (i8080_aluTables->add[carry][a][v] != (((uint16_t)state->f.psw << 8) | state->a))
+					addMatches = false;
+
+				state->f.psw = FLAG_ONE;
+				state->a = i8080op_subCarry8(state, a - carry, v);
+				i8080_acFlagSetSub(state, state->a);
+				i8080op_setZSP(state, state->a);
+				if (i8080_aluTables->sub[carry][a][v] != (((uint16_t)state->f.psw << 8) | state->a))
+					subMatches = false;
+
+				if (carry == 0) {
+					state->f.psw = FLAG_ONE;
+					state->a = a;
+					i8080_acFlagSetCmp(state, v);
+					i8080op_setZSP(state, i8080op_subCarry8(state, a, v));
+					if ((ALU_FLAGS(i8080_aluTables->sub[0][a][v]) & ~FLAG_AC) != state->f.psw)
+						cmpMatches = false;
+				}
+			}
+		}
+	}
+	if (!addMatches) { failedTests++; }
+	fprintf(testLog, "Test ALU table add\t\t\t\t\t: [%s]\n", addMatches ? "OK" : "FAIL");
+	if (!subMatches) { failedTests++; }
+	fprintf(testLog, "Test ALU table sub\t\t\t\t\t: [%s]\n", subMatches ? "OK" : "FAIL");
+	if (!cmpMatches) { failedTests++; }
+	fprintf(testLog, "Test ALU table cmp\t\t\t\t\t: [%s]\n", cmpMatches ? "OK" : "FAIL");
+
+	// DAA leaves s, z and p alone, only the ac and c bits come from the table
+	success = true;
+	for (int flags = 0; flags < 4; flags++) {
+		for (int a = 0; a < 0x100; a++) {
+			uint8_t c = flags & 1;
+			uint8_t ac = flags >> 1;
+			state->f.psw = FLAG_ONE | (c ? FLAG_C : 0) | (ac ? FLAG_AC : 0);
+			state->a = a;
+			if ((state->a & 0xF) > 0x9 || ac)
+				state->a = state->a + 6;
+			i8080_acFlagSetInc(state, state->a);
+			if (c)
+				state->a = i8080op_addCarry8(state, state->a, 0x60);
+			uint16_t expected = ((uint16_t)(state->f.psw & (FLAG_AC | FLAG_C)) << 8) | state->a;
+			if (i8080_aluTables->daa[c][ac][a] != expected)
+				success = false;
+		}
+	}
+	if (!success) { failedTests++; }
+	fprintf(testLog, "Test ALU table daa\t\t\t\t\t: [%s]\n", success ? "OK" : "FAIL");
+
+	return failedTests;
+}
+
+bool utilTest_statesMatch(i8080State* a, i8080State* b) {
+	return a->pc == b->pc && a->sp == b->sp && a->mode == b->mode && a->a == b->a &&
+		i8080op_getBC(a) == i8080op_getBC(b) && i8080op_getDE(a) == i8080op_getDE(b) && i8080op_getHL(a) == i8080op_getHL(b) &&
+		i8080op_getPSW(a) == i8080op_getPSW(b) && GET_FLAG(a, FLAG_C) == GET_FLAG(b, FLAG_C) && a->f.ien == b->f.ien && a->f.isi == b->f.isi &&
+		memcmp(a->memory, b->memory, i8080_MEMORY_SIZE) == 0;
 }
 
 void utilTest_prepStack(i8080State* state, uint16_t newSp) {
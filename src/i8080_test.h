@@ -9,15 +9,70 @@ Test protocol function. Massive single opcode test for each opcode
 
 
 #include "i8080.h"
+#include "i8080_jit.h"
+#include "i8080_fused.h"
+#include "i8080_wide.h"
+#include "i8080_system.h"
+#include "i8080_aot.h"
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sfml/System/Clock.h>
 
 /* Test fuction defs */
 // Runs a batch test on the program to check each opcode
 void i8080_testProtocol(i8080State* state);
+// Runs the single opcode tests on the core selected in the state. Returns the number of failed tests
+int utilTest_instructions(i8080State* state, FILE* testLog);
+// Checks the disassembler, and runs every documented opcode from pseudo random states to check it does no more than its entry of I8080_OPCODE_LIST says. Returns the number of failed tests
+int utilTest_opcodeList(i8080State* state, FILE* testLog);
+// Runs every documented opcode from identical pseudo random states on the switch core and the given core and compares the results. Returns the number of failed tests
+int utilTest_coreEquivalence(i8080State* state, FILE* testLog, int core);
+// Runs every pair of I8080_FUSED_LIST from pseudo random states on the switch core and the fused core, checking the pair was fused and the results are the same. Returns the number of failed tests
+int utilTest_fusedPairs(i8080State* state, FILE* testLog);
+// Runs a program waiting on its interrupt handler on every core with the idle loop skip on, beside the switch core running every instruction, and checks both end in the same place and cycles were skipped. Returns the number of failed tests
+int utilTest_idleLoop(i8080State* state, FILE* testLog);
+// Runs a program that halts with interrupts on through every core and the wide core, checking one run sleeps from interrupt to interrupt the same way on each, and that a halt with interrupts off stays halted without using time. Returns the number of failed tests
+int utilTest_haltSleep(i8080State* state, FILE* testLog);
+// Runs pseudo random programs with the accurate timing on every core beside the fast switch core, and checks where the accurate timing places IN/OUT and the interrupt acknowledge. Returns the number of failed tests
+int utilTest_timing(i8080State* state, FILE* testLog);
+// Runs a program calling the invaders routines of the HLE registry on every core with HLE on, in lockstep with the switch core running the ROM code, under HLE_VERIFY, and with the code of a routine changed. Returns the number of failed tests
+int utilTest_hle(i8080State* state, FILE* testLog);
+// Loads the program of utilTest_hle into the state, in test mode with the given core and HLE mode
+void utilTest_hleProgram(i8080State* state, int core, int hle);
+// Runs a program calling a pure, an impure and a changing routine on every core with memoisation on, in lockstep with the switch core running every call, and under MEMO_PROFILE. Returns the number of failed tests
+int utilTest_memo(i8080State* state, FILE* testLog);
+// Loads the program of utilTest_memo into the ROM of the state, in normal mode with the given core and memoisation mode
+void utilTest_memoProgram(i8080State* state, int core, int memo);
+// Translates the utilTest_memo program again and checks it gives i8080_aot_test.c, then runs that in lockstep with the
+// switch core. Returns the number of failed tests
+int utilTest_aot(i8080State* state, FILE* testLog);
+// Defined by i8080_aot_test.c, the translation of the utilTest_memo program from 0100 and the two frame interrupts
+int i8080_aotTestRun(i8080State* state, int cycleBudget);
+extern const uint32_t i8080_aotTestRunHash;
+// Runs a system of processors on their own host threads, each working on its own page beside a lone state running the same
+// quanta, and two processors writing one contended region in the same quantum. Returns the number of failed tests
+int utilTest_system(i8080State* state, FILE* testLog);
+// Checks the mirrored RAM and the protected ROM of the invaders map, and runs a program over a map with a handled page, a
+// mirrored window and unmapped pages, and one fetched through a read handler, on every core. Returns the number of failed tests
+int utilTest_bus(i8080State* state, FILE* testLog);
+// Runs the invaders shift register and the CP/M stubs on every core, checks the bare board leaves both out, that a board
+// raising no interrupts leaves a halted processor halted, that the cores take interrupts on the period of the board and
+// raise each of three in turn, and that a reset clears the interrupt timing. Returns the number of failed tests
+int utilTest_board(i8080State* state, FILE* testLog);
+// Runs every documented opcode and pseudo random programs on the wide core, each lane beside a copy of it on the switch core, and compares the results. Returns the number of failed tests
+int utilTest_wideCore(i8080State* state, FILE* testLog);
+// Checks every entry of the ALU tables against the addCarry8/subCarry8 and acFlagSet helpers. Returns the number of failed tests
+int utilTest_aluTables(i8080State* state, FILE* testLog);
+// Fills the state with pseudo random memory, registers and flags, with the pc at 0x1000 in test mode on the flat map. documentedOnly keeps undocumented opcodes out of memory
+void utilTest_randomState(i8080State* state, uint32_t* seed, bool documentedOnly);
+// Copies the registers, flags and memory of src into dst, keeping the buffers, debug block and core of dst, with the page table of dst built from the map of src on the same board
+void utilTest_copyState(i8080State* dst, i8080State* src);
+// Returns if the registers, flags, mode and memory of both states are the same
+bool utilTest_statesMatch(i8080State* a, i8080State* b);
 // Preps the state for the next test opcode
 void utilTest_prepNext(i8080State* state, uint8_t opcode, uint8_t byte1, uint8_t byte2);
 // Preps the stack
@@ -0,0 +1,104 @@
+#pragma once
+/*
+
+i8080_thread.h
+
+Host threads and atomics for i8080System, over the Win32 API under MSVC and over pthreads and the GCC atomic builtins
+everywhere else. The atomics are full barriers, the system only uses them at its synchronisations and region claims
+
+*/
+
+#include "i8080_util.h"
+
+#if defined(_MSC_VER)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef HANDLE i8080Thread;
+typedef LPTHREAD_START_ROUTINE i8080ThreadProc;
+// Declares a function a thread can be started on, returning I8080_THREAD_END
+#define I8080_THREAD_PROC(name, arg) DWORD WINAPI name(LPVOID arg)
+#define I8080_THREAD_END 0
+
+I8080_INLINE bool i8080_threadStart(i8080Thread* thread, i8080ThreadProc proc, void* arg) {
+	*thread = CreateThread(NULL, 0, proc, arg, 0, NULL);
+	return *thread != NULL;
+}
+
+I8080_INLINE void i8080_threadJoin(i8080Thread thread) {
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+I8080_INLINE void i8080_threadYield(void) {
+	SwitchToThread();
+}
+
+I8080_INLINE int i8080_hostCores(void) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+}
+
+I8080_INLINE long i8080_atomicLoad(volatile long* p) {
+	return InterlockedCompareExchange(p, 0, 0);
+}
+
+I8080_INLINE void i8080_atomicStore(volatile long* p, long v) {
+	InterlockedExchange(p, v);
+}
+
+// Returns the value after the increment
+I8080_INLINE long i8080_atomicIncrement(volatile long* p) {
+	return InterlockedIncrement(p);
+}
+
+// Sets *p to desired if it holds expected, returns whether it did
+I8080_INLINE bool i8080_atomicSwap(volatile long* p, long expected, long desired) {
+	return InterlockedCompareExchange(p, desired, expected) == expected;
+}
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+typedef pthread_t i8080Thread;
+typedef void* (*i8080ThreadProc)(void*);
+// Declares a function a thread can be started on, returning I8080_THREAD_END
+#define I8080_THREAD_PROC(name, arg) void* name(void* arg)
+#define I8080_THREAD_END NULL
+
+I8080_INLINE bool i8080_threadStart(i8080Thread* thread, i8080ThreadProc proc, void* arg) {
+	return pthread_create(thread, NULL, proc, arg) == 0;
+}
+
+I8080_INLINE void i8080_threadJoin(i8080Thread thread) {
+	pthread_join(thread, NULL);
+}
+
+I8080_INLINE void i8080_threadYield(void) {
+	sched_yield();
+}
+
+I8080_INLINE int i8080_hostCores(void) {
+	return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
+
+I8080_INLINE long i8080_atomicLoad(volatile long* p) {
+	return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+
+I8080_INLINE void i8080_atomicStore(volatile long* p, long v) {
+	__atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+// Returns the value after the increment
+I8080_INLINE long i8080_atomicIncrement(volatile long* p) {
+	return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST);
+}
+
+// Sets *p to desired if it holds expected, returns whether it did
+I8080_INLINE bool i8080_atomicSwap(volatile long* p, long expected, long desired) {
+	return __atomic_compare_exchange_n(p, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+#endif
@@ -13,12 +13,43 @@ Utility functions and types
 
 //Memory size of the i8080
 #define i8080_MEMORY_SIZE 65536
+//Size of the write protected ROM at the start of memory
+#define i8080_ROM_SIZE 0x2000
 
 // Boolean info
 #define true 1
 #define false 0
 #define bool unsigned char
 
+// Cache line size the hot part of the state is laid out for
+#define I8080_CACHE_LINE 64
+#if defined(_MSC_VER)
+#define I8080_CACHE_ALIGNED __declspec(align(I8080_CACHE_LINE))
+#else
+#define I8080_CACHE_ALIGNED __attribute__((aligned(I8080_CACHE_LINE)))
+#endif
+
+// Small functions defined in headers
+#if defined(_MSC_VER)
+#define I8080_INLINE static __inline
+#else
+#define I8080_INLINE static inline
+#endif
+
+// Globals each host thread keeps its own copy of
+#if defined(_MSC_VER)
+#define I8080_THREAD_LOCAL __declspec(thread)
+#else
+#define I8080_THREAD_LOCAL __thread
+#endif
+
+// A register pair laid over its two 8 bit registers, so the pair can be read and written as one native 16 bit word
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define I8080_PAIR(hi, lo, pair) union { struct { uint8_t hi; uint8_t lo; }; uint16_t pair; }
+#else
+#define I8080_PAIR(hi, lo, pair) union { struct { uint8_t lo; uint8_t hi; }; uint16_t pair; }
+#endif
+
 // Const defs
 #define MHZ 1000000.0f
 #define MICROSECONDS_IN_SECOND 1000000.0f
@@ -42,6 +73,20 @@ Utility functions and types
 #define INTERRUPT_6 0x0030
 #define INTERRUPT_7 0x0038
 
+// Flag bits of the PSW byte, bits 3 and 5 always read 0 and bit 1 always reads 1
+#define FLAG_S		0b10000000
+#define FLAG_Z		0b01000000
+#define FLAG_AC		0b00010000
+#define FLAG_P		0b00000100
+#define FLAG_ONE	0b00000010
+#define FLAG_C		0b00000001
+#define FLAG_MASK	(FLAG_S | FLAG_Z | FLAG_AC | FLAG_P | FLAG_C)
+
+// Reads one flag of the PSW as 0 or 1
+#define GET_FLAG(state, flag) (((state)->f.psw & (flag)) != 0)
+// Sets one flag of the PSW from bit 0 of v, the way assigning to the old one bit fields did
+#define SET_FLAG(state, flag, v) ((state)->f.psw = ((v) & 1) ? ((state)->f.psw | (flag)) : ((state)->f.psw & ~(flag)))
+
 // typedefs
 #define UINT8_MAX 0xFF
 typedef unsigned char uint8_t;
@@ -65,20 +110,14 @@ typedef struct prevInstruction {
 	char* statusString;
 } prevInstruction;
 
-typedef struct bufferedPort {
+// An out port as the cores write it, the history the stats view shows is in the debug block
+typedef struct outPort {
 	uint8_t val;
 	bool portFilled;
-	uint8_t buffer[BUFFERED_OUT_PORT_LEN];
-} bufferedPort;
+} outPort;
 
 typedef struct flagRegister {
-	unsigned int s : 1; // sign flag
-	unsigned int z : 1; // zero flag
-	unsigned int ac : 1; // auxiliary carry flag
-	unsigned int p : 1; // parity flag
-	unsigned int c : 1; // carry flag
-	unsigned int zero : 1; // always zero, bits 3 and 5
-	unsigned int one : 1; // always one, bit 1
+	uint8_t psw; // flag byte as PUSH PSW stores it, S Z 0 AC 0 P 1 C. Use GET_FLAG and SET_FLAG for single flags
 	unsigned int ien : 1; // Is the interrupt system enabled?
 	unsigned int isi; // Are we currently interrupted?
 	unsigned int rx : 1; // Are we reading this tick?
@@ -89,37 +128,71 @@ typedef struct videoMemoryInfo {
 	uint16_t width;
 	uint16_t height;
 } videoMemoryInfo;
-typedef struct i8080State {
+// Idle loop the cores fast forward through, found by i8080_idleDetect
+typedef struct i8080IdleLoop {
+	bool enabled; // look for idle loops and skip them
+	bool seen; // the pc has been on the head since the loop was found, in this run
+	int head; // address the loop starts at, -1 if there is none
+	int cycles; // cycles of one pass round the loop
+	unsigned long skippedCycles; // cycles fast forwarded over since the last reset
+	// Registers the last time the pc was on the head. A pass that leaves them as they were will leave them so until the next interrupt
+	unsigned long seenAt; // cyclesExecuted at the time, which keeps counting over the halts a run sleeps through
+	uint16_t bc, de, hl, sp;
+	uint8_t a, psw, lazyFlags, lazyResult, lazyOperand;
+} i8080IdleLoop;
+// Debug data, statistics and front end settings, none of which an uninstrumented run reads. Allocated apart from the
+// state by init8080 so it does not spread the registers of many machines over more cache lines
+typedef struct i8080Debug {
+	char* statusString;
+	unsigned int opcodeUse[0x100]; // times each opcode has run
+	unsigned long fusedPairs; // instruction pairs run as one by the fused core, a dispatch saved each
+	char outPortHistory[NUMBER_OF_PORTS][BUFFERED_OUT_PORT_LEN]; // the last values written to each port as letters from 'a', for the stats view
+	struct videoMemoryInfo vid;
+	prevInstruction previousInstructions[INSTRUCTION_TRACE_LEN];
+} i8080Debug;
+
+// Aligned to a cache line, with the registers, flags, memory pointers and cycle count every instruction touches in the first one
+typedef struct I8080_CACHE_ALIGNED i8080State {
 	// registers
 	uint8_t a;
-	uint8_t b;
-	uint8_t c;
-	uint8_t d;
-	uint8_t e;
-	uint8_t h;
-	uint8_t l;
+	I8080_PAIR(b, c, bc);
+	I8080_PAIR(d, e, de);
+	I8080_PAIR(h, l, hl);
 	uint16_t sp;
 	uint16_t pc;
+	struct flagRegister f;
+	uint8_t lazyFlags; // LAZY_ rule s, z, p and ac still have to be built with, LAZY_NONE when f is up to date
+	uint8_t lazyResult; // result the s, z and p flags come from
+	uint8_t lazyOperand; // accumulator and operand of an ANA or'd together, its ac flag comes from them
+	// switches the run loops check, in the bytes before the pointers
+	bool traced; // run the instrumented cores, keeping the opcode use table, status string and instruction trace of the debug block up to date and logging every instruction
+	uint8_t hle; // i8080HleMode
+	uint8_t memo; // i8080MemoMode
+	uint8_t timing; // i8080Timing, how finely i8080_run accounts the cycles
+	bool microOpsValid;
 	// memory
 	uint8_t* memory;
-	int memorySize;
+	struct i8080Bus* bus; // page table every memory access goes through, see i8080_bus.h
+	struct i8080BlockCache* blockCache; // decoded basic blocks
+	unsigned long cyclesExecuted;
+	struct i8080MicroOp* microOps; // predecoded ROM, one entry per address
+	//status
+	int mode;
+	int haltedFrom; // mode an interrupt waking the processor from MODE_HLT puts it back in
+	int core;
+	bool blockCacheValid;
 	// timing
 	float clockFreqMHz;
 	int waitCycles;
-	//status
-	int mode;
-	char* statusString;
-	// structs
-	struct flagRegister f;
-	struct videoMemoryInfo vid;
+	unsigned int interruptAccumulator; // cycles since the last frame interrupt
+	uint8_t interruptIndex; // entry of the board's interrupts the next frame interrupt raises
+	struct i8080IdleLoop idle;
 	// ports
 	uint8_t inPorts[NUMBER_OF_PORTS];
-	bufferedPort outPorts[NUMBER_OF_PORTS];
-	// debug
-	unsigned long cyclesExecuted;
-	unsigned int opcodeUse[0x100];
-	prevInstruction previousInstructions[INSTRUCTION_TRACE_LEN];
-	
+	outPort outPorts[NUMBER_OF_PORTS];
+	unsigned long ioCycle; // cycle the last IN or OUT reached the bus on, see i8080Timing
+	// cold
+	struct i8080Debug* debug;
 } i8080State;
 
 enum i8080Mode {
@@ -130,257 +203,63 @@ enum i8080Mode {
 	MODE_TEST
 };
 
-enum i8080Opcode {
-	// Instr	Code
-	NOP			= 0x00,
-	LXI_B		= 0x01,
-	STAX_B		= 0x02,
-	INX_B		= 0x03,
-	INR_B		= 0x04,
-	DCR_B		= 0x05,
-	MVI_B		= 0x06,
-	RLC			= 0x07,
-	DAD_B		= 0x09,
-	LDAX_B		= 0x0a,
-	DCX_B		= 0x0b,
-	INR_C		= 0x0c,
-	DCR_C		= 0x0d,
-	MVI_C		= 0x0e,
-	RRC			= 0x0f,
-	LXI_D		= 0x11,
-	STAX_D		= 0x12,
-	INX_D		= 0x13,
-	INR_D		= 0x14,
-	DCR_D		= 0x15,
-	MVI_D		= 0x16,
-	RAL			= 0x17,
-	DAD_D		= 0x19,
-	LDAX_D		= 0x1a,
-	DCX_D		= 0x1b,
-	INR_E		= 0x1c,
-	DCR_E		= 0x1d,
-	MVI_E		= 0x1e,
-	RAR			= 0x1f,
-	LXI_H		= 0x21,
-	SHLD		= 0x22,
-	INX_H		= 0x23,
-	INR_H		= 0x24,
-	DCR_H		= 0x25,
-	MVI_H		= 0x26,
-	DAA			= 0x27,
-	DAD_H		= 0x29,
-	LHLD		= 0x2a,
-	DCX_H		= 0x2b,
-	INR_L		= 0x2c,
-	DCR_L		= 0x2d,
-	MVI_L		= 0x2e,
-	CMA			= 0x2f,
-	LXI_SP		= 0x31,
-	STA			= 0x32,
-	INX_SP		= 0x33,
-	INR_M		= 0x34,
-	DCR_M		= 0x35,
-	MVI_M		= 0x36,
-	STC			= 0x37,
-	DAD_SP		= 0x39,
-	LDA			= 0x3a,
-	DCX_SP		= 0x3b,
-	INR_A		= 0x3c,
-	DCR_A		= 0x3d,
-	MVI_A		= 0x3e,
-	CMC			= 0x3f,
-	MOV_BB		= 0x40,
-	MOV_BC		= 0x41,
-	MOV_BD		= 0x42,
-	MOV_BE		= 0x43,
-	MOV_BH		= 0x44,
-	MOV_BL		= 0x45,
-	MOV_BM		= 0x46,
-	MOV_BA		= 0x47,
-	MOV_CB		= 0x48,
-	MOV_CC		= 0x49,
-	MOV_CD		= 0x4a,
-	MOV_CE		= 0x4b,
-	MOV_CH		= 0x4c,
-	MOV_CL		= 0x4d,
-	MOV_CM		= 0x4e,
-	MOV_CA		= 0x4f,
-	MOV_DB		= 0x50,
-	MOV_DC		= 0x51,
-	MOV_DD		= 0x52,
-	MOV_DE		= 0x53,
-	MOV_DH		= 0x54,
-	MOV_DL		= 0x55,
-	MOV_DM		= 0x56,
-	MOV_DA		= 0x57,
-	MOV_EB		= 0x58,
-	MOV_EC		= 0x59,
-	MOV_ED		= 0x5a,
-	MOV_EE		= 0x5b,
-	MOV_EH		= 0x5c,
-	MOV_EL		= 0x5d,
-	MOV_EM		= 0x5e,
-	MOV_EA		= 0x5f,
-	MOV_HB		= 0x60,
-	MOV_HC		= 0x61,
-	MOV_HD		= 0x62,
-	MOV_HE		= 0x63,
-	MOV_HH		= 0x64,
-	MOV_HL		= 0x65,
-	MOV_HM		= 0x66,
-	MOV_HA		= 0x67,
-	MOV_LB		= 0x68,
-	MOV_LC		= 0x69,
-	MOV_LD		= 0x6a,
-	MOV_LE		= 0x6b,
-	MOV_LH		= 0x6c,
-	MOV_LL		= 0x6d,
-	MOV_LM		= 0x6e,
-	MOV_LA		= 0x6f,
-	MOV_MB		= 0x70,
-	MOV_MC		= 0x71,
-	MOV_MD		= 0x72,
-	MOV_ME		= 0x73,
-	MOV_MH		= 0x74,
-	MOV_ML		= 0x75,
-	HLT			= 0x76,
-	MOV_MA		= 0x77,
-	MOV_AB		= 0x78,
-	MOV_AC		= 0x79,
-	MOV_AD		= 0x7a,
-	MOV_AE		= 0x7b,
-	MOV_AH		= 0x7c,
-	MOV_AL		= 0x7d,
-	MOV_AM		= 0x7e,
-	MOV_AA		= 0x7f,
-	ADD_B		= 0x80,
-	ADD_C		= 0x81,
-	ADD_D		= 0x82,
-	ADD_E		= 0x83,
-	ADD_H		= 0x84,
-	ADD_L		= 0x85,
-	ADD_M		= 0x86,
-	ADD_A		= 0x87,
-	ADC_B		= 0x88,
-	ADC_C		= 0x89,
-	ADC_D		= 0x8a,
-	ADC_E		= 0x8b,
-	ADC_H		= 0x8c,
-	ADC_L		= 0x8d,
-	ADC_M		= 0x8e,
-	ADC_A		= 0x8f,
-	SUB_B		= 0x90,
-	SUB_C		= 0x91,
-	SUB_D		= 0x92,
-	SUB_E		= 0x93,
-	SUB_H		= 0x94,
-	SUB_L		= 0x95,
-	SUB_M		= 0x96,
-	SUB_A		= 0x97,
-	SBB_B		= 0x98,
-	SBB_C		= 0x99,
-	SBB_D		= 0x9a,
-	SBB_E		= 0x9b,
-	SBB_H		= 0x9c,
-	SBB_L		= 0x9d,
-	SBB_M		= 0x9e,
-	SBB_A		= 0x9f,
-	ANA_B		= 0xa0,
-	ANA_C		= 0xa1,
-	ANA_D		= 0xa2,
-	ANA_E		= 0xa3,
-	ANA_H		= 0xa4,
-	ANA_L		= 0xa5,
-	ANA_M		= 0xa6,
-	ANA_A		= 0xa7,
-	XRA_B		= 0xa8,
-	XRA_C		= 0xa9,
-	XRA_D		= 0xaa,
-	XRA_E		= 0xab,
-	XRA_H		= 0xac,
-	XRA_L		= 0xad,
-	XRA_M		= 0xae,
-	XRA_A		= 0xaf,
-	ORA_B		= 0xb0,
-	ORA_C		= 0xb1,
-	ORA_D		= 0xb2,
-	ORA_E		= 0xb3,
-	ORA_H		= 0xb4,
-	ORA_L		= 0xb5,
-	ORA_M		= 0xb6,
-	ORA_A		= 0xb7,
-	CMP_B		= 0xb8,
-	CMP_C		= 0xb9,
-	CMP_D		= 0xba,
-	CMP_E		= 0xbb,
-	CMP_H		= 0xbc,
-	CMP_L		= 0xbd,
-	CMP_M		= 0xbe,
-	CMP_A		= 0xbf,
-	RNZ			= 0xc0,
-	POP_B		= 0xc1,
-	JNZ			= 0xc2,
-	JMP			= 0xc3,
-	CNZ			= 0xc4,
-	PUSH_B		= 0xc5,
-	ADI			= 0xc6,
-	RST_0		= 0xc7,
-	RZ			= 0xc8,
-	RET			= 0xc9,
-	JZ			= 0xca,
-	CZ			= 0xcc,
-	CALL		= 0xcd,
-	ACI			= 0xce,
-	RST_1		= 0xcf,
-	RNC			= 0xd0,
-	POP_D		= 0xd1,
-	JNC			= 0xd2,
-	OUT			= 0xd3,
-	CNC			= 0xd4,
-	PUSH_D		= 0xd5,
-	SUI			= 0xd6,
-	RST_2		= 0xd7,
-	RC			= 0xd8,
-	JC			= 0xda,
-	IN			= 0xdb,
-	CC			= 0xdc,
-	SBI			= 0xde,
-	RST_3		= 0xdf,
-	RPO			= 0xe0,
-	POP_H		= 0xe1,
-	JPO			= 0xe2,
-	XTHL		= 0xe3,
-	CPO			= 0xe4,
-	PUSH_H		= 0xe5,
-	ANI			= 0xe6,
-	RST_4		= 0xe7,
-	RPE			= 0xe8,
-	PCHL		= 0xe9,
-	JPE			= 0xea,
-	XCHG		= 0xeb,
-	CPE			= 0xec,
-	XRI			= 0xee,
-	RST_5		= 0xef,
-	RP			= 0xf0,
-	POP_PSW		= 0xf1,
-	JP			= 0xf2,
-	DI			= 0xf3,
-	CP			= 0xf4,
-	PUSH_PSW	= 0xf5,
-	ORI			= 0xf6,
-	RST_6		= 0xf7,
-	RM			= 0xf8,
-	SPHL		= 0xf9,
-	JM			= 0xfa,
-	EI			= 0xfb,
-	CM			= 0xfc,
-	CPI			= 0xfe,
-	RST_7		= 0xff
+enum i8080Core {
+	CORE_SWITCH,
+	CORE_TABLE,
+	CORE_THREADED,
+	CORE_PREDECODED,
+	CORE_BLOCK,
+	CORE_JIT,
+	CORE_FUSED,
+	CORE_COUNT
 };
 
-// Instruction set paramaters: { <byte length of instruction> , <cycle length of instruction> , <cycle length of failed instruction> }
+// How i8080_run accounts time. Both run the same instruction code
+enum i8080Timing {
+	TIMING_FAST, // instruction level on the selected core, the clock only matters at interrupts and the end of the budget. IN/OUT are stamped with the cycle count as of the start of their instruction, or of their block on the block cores, and acknowledging an interrupt takes no time
+	TIMING_ACCURATE // one instruction at a time through the switch or the handler table with the bus cycles placed within it: IN/OUT reach the bus on the first T-state of their I/O M-cycle and acknowledging an interrupt takes the 11 T-states of the RST it jams onto the bus. Idle loops are not skipped
+};
+
+// Whether the cores hand known ROM routines to native code, see i8080_hle.h
+enum i8080HleMode {
+	HLE_OFF, // every instruction of the ROM runs
+	HLE_ON, // the routines of the registry run natively where their code is found
+	HLE_VERIFY // the routines run through the ROM code and natively on a copy of the state, and the two are compared
+};
+
+// Whether the cores record and replay calls to pure ROM subroutines, see i8080_memo.h
+enum i8080MemoMode {
+	MEMO_OFF, // calls run as they are
+	MEMO_PROFILE, // calls into the ROM are recorded and checked for purity, none are replayed
+	MEMO_ON // recorded as under MEMO_PROFILE, and calls matching a held result of a pure routine are replayed
+};
+
+// How the ac flag of a deferred flag update is built. s, z and p always come from the result
+enum i8080LazyFlags {
+	LAZY_NONE,
+	LAZY_ADD, // ac set when the low nibble of the result is zero: ADD, ADC, INR and DCR M
+	LAZY_SUB, // ac set when the low nibble of the result is not zero: SUB, SBB
+	LAZY_DCR, // ac clear when the low nibble of the result is F: DCR
+	LAZY_ANA, // ac is bit 3 of the or'd operands: ANA
+	LAZY_LOGIC // ac cleared: XRA, ORA, and CMP whose ac works out to 0 in the one bit field
+};
+
+#include "i8080_opcodes.h"
+
+// The opcodes by name, the undocumented ones as UNDOC_<hex>
+#define OPCODE_ENUM(hex, name, ...) name = 0x##hex,
+enum i8080Opcode { I8080_OPCODE_LIST(OPCODE_ENUM) };
+#undef OPCODE_ENUM
+
+// Instruction set paramaters: { <byte length of instruction> , <cycle length of instruction> , <cycle length of failed instruction> }, from I8080_OPCODE_LIST
 extern const uint8_t instructionParams[0x100][3];
 
+// Everything I8080_OPCODE_LIST holds on each opcode
+extern const i8080OpcodeInfo i8080_opcodeInfo[0x100];
+
+// S, Z and P flag bits for every 8 bit result, ready to be or'ed into the PSW
+extern const uint8_t i8080_zspTable[0x100];
+
 // Loads the contents of a file into the buffer at offset given. Assumes buffer already exists
 void loadFile(const char* file, unsigned char* buffer, int bufferSize, int offset);
 
@@ -399,6 +278,18 @@ int getConsoleLine(char* buf, int bufLen);
 // Returns the MODE in a human-readable format
 const char* getModeStr(int mode);
 
+// Returns the CORE in a human-readable format
+const char* getCoreStr(int core);
+
+// Returns the TIMING in a human-readable format
+const char* getTimingStr(int timing);
+
+// Returns the HLE mode in a human-readable format
+const char* getHleStr(int hle);
+
+// Returns the memoisation mode in a human-readable format
+const char* getMemoStr(int memo);
+
 // Checks if a memory index is in range of the memory buffer
 bool i8080_boundsCheckMemIndex(i8080State* state, int index);
 
@@ -444,5 +335,11 @@ char* i8080_decToBin(uint16_t n);
 // Fills the buffer with the mneumonic for the opcode
 const char* i8080_decompile(uint8_t opcode);
 
+// Longest text i8080_disassemble writes, with the terminating '\0'
+#define I8080_DISASSEMBLY_LEN 16
+
+// Writes the instruction with its operands into the buffer, as "MVI B,12", "JMP 1A32" or "IN 01". Returns the buffer
+char* i8080_disassemble(char* buffer, uint8_t opcode, uint8_t byte1, uint8_t byte2);
+
 // Triggers a breakpoint condition
 void breakpoint(i8080State* state, const char* reason);
\ No newline at end of file
@@ -0,0 +1,653 @@
+/*
+
+i8080_wide.c
+
+Wide core. Runs up to WIDE_LANES independent machines side by side with their registers laid out one array per register
+
+*/
+
+#include "i8080_wide.h"
+
+#include <string.h>
+
+// 16 lanes a vector on SSE2, the baseline of every x86-64 host, and on NEON. AVX2 would need the project built for it
+#if ((defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && WIDE_LANES % 16 == 0)
+#include <emmintrin.h>
+#define WIDE_STEP 16
+typedef __m128i wideVec;
+I8080_INLINE wideVec wideLoad(const uint8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+I8080_INLINE void wideStore(uint8_t* p, wideVec v) { _mm_storeu_si128((__m128i*)p, v); }
+I8080_INLINE wideVec wideSplat(uint8_t b) { return _mm_set1_epi8((char)b); }
+I8080_INLINE wideVec wideAnd(wideVec a, wideVec b) { return _mm_and_si128(a, b); }
+I8080_INLINE wideVec wideOr(wideVec a, wideVec b) { return _mm_or_si128(a, b); }
+I8080_INLINE wideVec wideXor(wideVec a, wideVec b) { return _mm_xor_si128(a, b); }
+I8080_INLINE wideVec wideAndNot(wideVec a, wideVec b) { return _mm_andnot_si128(a, b); }
+I8080_INLINE wideVec wideAdd(wideVec a, wideVec b) { return _mm_add_epi8(a, b); }
+I8080_INLINE wideVec wideSub(wideVec a, wideVec b) { return _mm_sub_epi8(a, b); }
+I8080_INLINE wideVec wideEq(wideVec a, wideVec b) { return _mm_cmpeq_epi8(a, b); }
+I8080_INLINE wideVec wideLess(wideVec a, wideVec b) { return _mm_andnot_si128(_mm_cmpeq_epi8(_mm_max_epu8(a, b), a), _mm_set1_epi8(-1)); }
+I8080_INLINE wideVec wideBlend(wideVec mask, wideVec v, wideVec old) { return _mm_or_si128(_mm_and_si128(mask, v), _mm_andnot_si128(mask, old)); }
+// SSE2 only shifts 16 bit lanes, the bits that cross into the next byte are masked off
+#define WIDE_SHR(v, n) _mm_and_si128(_mm_srli_epi16((v), (n)), _mm_set1_epi8((char)(0xFF >> (n))))
+#define WIDE_SHL(v, n) _mm_and_si128(_mm_slli_epi16((v), (n)), _mm_set1_epi8((char)((0xFF << (n)) & 0xFF)))
+#elif ((defined(__ARM_NEON) || defined(_M_ARM64)) && WIDE_LANES % 16 == 0)
+#include <arm_neon.h>
+#define WIDE_STEP 16
+typedef uint8x16_t wideVec;
+I8080_INLINE wideVec wideLoad(const uint8_t* p) { return vld1q_u8(p); }
+I8080_INLINE void wideStore(uint8_t* p, wideVec v) { vst1q_u8(p, v); }
+I8080_INLINE wideVec wideSplat(uint8_t b) { return vdupq_n_u8(b); }
+I8080_INLINE wideVec wideAnd(wideVec a, wideVec b) { return vandq_u8(a, b); }
+I8080_INLINE wideVec wideOr(wideVec a, wideVec b) { return vorrq_u8(a, b); }
+I8080_INLINE wideVec wideXor(wideVec a, wideVec b) { return veorq_u8(a, b); }
+I8080_INLINE wideVec wideAndNot(wideVec a, wideVec b) { return vbicq_u8(b, a); }
+I8080_INLINE wideVec wideAdd(wideVec a, wideVec b) { return vaddq_u8(a, b); }
+I8080_INLINE wideVec wideSub(wideVec a, wideVec b) { return vsubq_u8(a, b); }
+I8080_INLINE wideVec wideEq(wideVec a, wideVec b) { return vceqq_u8(a, b); }
+I8080_INLINE wideVec wideLess(wideVec a, wideVec b) { return vcltq_u8(a, b); }
+I8080_INLINE wideVec wideBlend(wideVec mask, wideVec v, wideVec old) { return vbslq_u8(mask, v, old); }
+#define WIDE_SHR(v, n) vshrq_n_u8((v), (n))
+#define WIDE_SHL(v, n) vshlq_n_u8((v), (n))
+#else
+// One lane at a time through the same code, for other hosts and lane counts that are not a multiple of 16
+#define WIDE_STEP 1
+typedef uint8_t wideVec;
+I8080_INLINE wideVec wideLoad(const uint8_t* p) { return *p; }
+I8080_INLINE void wideStore(uint8_t* p, wideVec v) { *p = v; }
+I8080_INLINE wideVec wideSplat(uint8_t b) { return b; }
+I8080_INLINE wideVec wideAnd(wideVec a, wideVec b) { return a & b; }
+I8080_INLINE wideVec wideOr(wideVec a, wideVec b) { return a | b; }
+I8080_INLINE wideVec wideXor(wideVec a, wideVec b) { return a ^ b; }
+I8080_INLINE wideVec wideAndNot(wideVec a, wideVec b) { return (uint8_t)(~a & b); }
+I8080_INLINE wideVec wideAdd(wideVec a, wideVec b) { return (uint8_t)(a + b); }
+I8080_INLINE wideVec wideSub(wideVec a, wideVec b) { return (uint8_t)(a - b); }
+I8080_INLINE wideVec wideEq(wideVec a, wideVec b) { return a == b ? 0xFF : 0; }
+I8080_INLINE wideVec wideLess(wideVec a, wideVec b) { return a < b ? 0xFF : 0; }
+I8080_INLINE wideVec wideBlend(wideVec mask, wideVec v, wideVec old) { return (uint8_t)((mask & v) | (~mask & old)); }
+#define WIDE_SHR(v, n) ((uint8_t)((v) >> (n)))
+#define WIDE_SHL(v, n) ((uint8_t)((v) << (n)))
+#endif
+
+#define WIDE_REG_M 6
+#define WIDE_REG_A 7
+
+// WIDE_STEP lanes at a time. The lanes outside the group keep their old value through the blend so the loops stay free of branches
+#define WIDE_VECTOR_LOOP for (int i = 0; i < WIDE_LANES; i += WIDE_STEP)
+// One lane at a time, for the 16 bit registers
+#define WIDE_LANE_LOOP for (int i = 0; i < WIDE_LANES; i++)
+#define WIDE_BLEND(i, v, old) (wide->mask[i] ? (v) : (old))
+
+// Register pairs by the 2 bit pair field of the opcode, B D H. The high byte row is twice the field, the low byte row follows it
+#define WIDE_PAIR(rp, i) (((uint16_t)wide->r[(rp) * 2][i] << 8) | wide->r[(rp) * 2 + 1][i])
+#define WIDE_HL(i) WIDE_PAIR(2, i)
+
+#define WIDE_READ(i, address) i8080_busRead(wide->machines[i], (address))
+#define WIDE_WRITE(i, address, v) i8080op_writeMemory(wide->machines[i], (address), (v))
+
+// The s, z and p bits of each result, as i8080_zspTable holds them: parity folds the byte onto its lowest bit, and a zero
+// result keeps p clear
+I8080_INLINE wideVec wideZsp(wideVec r) {
+	wideVec x = wideXor(r, WIDE_SHR(r, 4));
+	x = wideXor(x, WIDE_SHR(x, 2));
+	x = wideXor(x, WIDE_SHR(x, 1));
+	wideVec zero = wideEq(r, wideSplat(0));
+	wideVec p = wideAndNot(zero, WIDE_SHL(wideAndNot(x, wideSplat(1)), 2));
+	return wideOr(wideOr(wideAnd(r, wideSplat(FLAG_S)), wideAnd(zero, wideSplat(FLAG_Z))), p);
+}
+
+static void wideLoadLane(i8080Wide* wide, int lane) {
+	i8080State* state = wide->machines[lane];
+	i8080op_resolveFlags(state);
+	wide->r[0][lane] = state->b;
+	wide->r[1][lane] = state->c;
+	wide->r[2][lane] = state->d;
+	wide->r[3][lane] = state->e;
+	wide->r[4][lane] = state->h;
+	wide->r[5][lane] = state->l;
+	wide->r[WIDE_REG_A][lane] = state->a;
+	wide->psw[lane] = state->f.psw;
+	wide->pc[lane] = state->pc;
+	wide->sp[lane] = state->sp;
+	wide->accumulator[lane] = state->interruptAccumulator;
+}
+
+static void wideStoreLane(i8080Wide* wide, int lane) {
+	i8080State* state = wide->machines[lane];
+	state->b = wide->r[0][lane];
+	state->c = wide->r[1][lane];
+	state->d = wide->r[2][lane];
+	state->e = wide->r[3][lane];
+	state->h = wide->r[4][lane];
+	state->l = wide->r[5][lane];
+	state->a = wide->r[WIDE_REG_A][lane];
+	state->f.psw = wide->psw[lane];
+	state->pc = wide->pc[lane];
+	state->sp = wide->sp[lane];
+	state->interruptAccumulator = wide->accumulator[lane];
+}
+
+// Runs one instruction of one lane on the scalar core of its machine. Returns the cycles it took
+static int widePeel(i8080Wide* wide, int lane) {
+	i8080State* state = wide->machines[lane];
+	wideStoreLane(wide, lane);
+	int cycles = i8080_executeInstruction(state);
+	i8080op_resolveFlags(state);
+	wideLoadLane(wide, lane);
+	wide->peeled++;
+	return cycles;
+}
+
+// checkInterrupts for one lane
+static void wideInterrupt(i8080Wide* wide, int lane) {
+	i8080State* state = wide->machines[lane];
+	wideStoreLane(wide, lane);
+	checkInterrupts(state);
+	wideLoadLane(wide, lane);
+}
+
+// i8080_haltSleep for one halted lane, on its own interrupt timing. Returns whether the lane woke
+static bool wideSleep(i8080Wide* wide, int lane, int* used, int cycleBudget) {
+	i8080State* state = wide->machines[lane];
+	int slept = i8080_haltSleep(state, wide->accumulator[lane], cycleBudget - used[lane]);
+	used[lane] += slept;
+	wide->accumulator[lane] += slept;
+	return state->mode != MODE_HLT;
+}
+
+// ADD ADC SUB SBB ANA XRA ORA CMP of wide->operand into A, by the 3 bit operation field, with the flags i8080alu_add and
+// i8080alu_sub give. XRI and ORI clear the carry, XRA and ORA keep it
+static void wideAlu(i8080Wide* wide, uint8_t operation, bool immediate) {
+	uint8_t keep = (uint8_t)~(FLAG_S | FLAG_Z | FLAG_AC | FLAG_P | ((immediate || operation == 4) ? FLAG_C : 0));
+
+	WIDE_VECTOR_LOOP {
+		wideVec mask = wideLoad(wide->mask + i);
+		wideVec a = wideLoad(wide->r[WIDE_REG_A] + i);
+		wideVec v = wideLoad(wide->operand + i);
+		wideVec psw = wideLoad(wide->psw + i);
+		wideVec carry = wideAnd(psw, wideSplat(FLAG_C));
+		wideVec result;
+		wideVec flags;
+
+		switch (operation) {
+		case 0: // ADD
+		case 1: // ADC, the operand and carry are added first
+			result = wideAdd(a, operation == 1 ? wideAdd(v, carry) : v);
+			flags = wideOr(wideAnd(wideLess(result, a), wideSplat(FLAG_C)), wideAnd(wideEq(wideAnd(result, wideSplat(0xF)), wideSplat(0)), wideSplat(FLAG_AC)));
+			flags = wideOr(flags, wideOr(wideZsp(result), wideSplat(FLAG_ONE)));
+			break;
+		case 2: // SUB
+		case 3: // SBB, the borrow is taken from A first
+		case 7: // CMP, which leaves ac clear and A as it was
+			a = operation == 3 ? wideSub(a, carry) : a;
+			result = wideSub(a, v);
+			flags = wideAnd(wideLess(a, v), wideSplat(FLAG_C));
+			if (operation != 7)
+				flags = wideOr(flags, wideAndNot(wideEq(wideAnd(result, wideSplat(0xF)), wideSplat(0)), wideSplat(FLAG_AC)));
+			flags = wideOr(flags, wideOr(wideZsp(result), wideSplat(FLAG_ONE)));
+			if (operation == 7)
+				result = a;
+			break;
+		case 4: // ANA, ac from bit 3 of either input
+			result = wideAnd(a, v);
+			flags = wideOr(wideOr(wideAnd(psw, wideSplat(keep)), wideZsp(result)), WIDE_SHL(wideAnd(wideOr(a, v), wideSplat(0x08)), 1));
+			break;
+		default: // XRA, ORA
+			result = operation == 5 ? wideXor(a, v) : wideOr(a, v);
+			flags = wideOr(wideAnd(psw, wideSplat(keep)), wideZsp(result));
+			break;
+		}
+
+		wideStore(wide->r[WIDE_REG_A] + i, wideBlend(mask, result, wideLoad(wide->r[WIDE_REG_A] + i)));
+		wideStore(wide->psw + i, wideBlend(mask, flags, psw));
+	}
+}
+
+// Whether each lane meets the 3 bit condition field of a conditional jump or call, NZ Z NC C PO PE P M
+static void wideCondition(i8080Wide* wide, uint8_t condition) {
+	static const uint8_t conditionFlags[4] = { FLAG_Z, FLAG_C, FLAG_P, FLAG_S };
+	uint8_t flag = conditionFlags[condition >> 1];
+	uint8_t wanted = (condition & 1) ? flag : 0;
+	WIDE_VECTOR_LOOP {
+		wideStore(wide->taken + i, wideEq(wideAnd(wideLoad(wide->psw + i), wideSplat(flag)), wideSplat(wanted)));
+	}
+}
+
+// Runs the instruction on every lane in the mask and moves their pc on. Returns false without touching any lane if the wide core does not cover the opcode
+static bool wideExecute(i8080Wide* wide, uint8_t opcode, uint8_t byte1, uint8_t byte2) {
+	uint16_t address = ((uint16_t)byte2 << 8) | byte1;
+	uint8_t dst = (opcode >> 3) & 7;
+	uint8_t src = opcode & 7;
+	uint8_t rp = (opcode >> 4) & 3;
+	uint8_t length = i8080_getInstructionLength(opcode);
+	bool jumps = false;
+
+	memset(wide->taken, 0xFF, WIDE_LANES);
+
+	if (opcode >= MOV_BB && opcode <= MOV_AA && opcode != HLT) {
+		if (src == WIDE_REG_M) {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					wide->r[dst][i] = WIDE_READ(i, WIDE_HL(i));
+			}
+		}
+		else if (dst == WIDE_REG_M) {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					WIDE_WRITE(i, WIDE_HL(i), wide->r[src][i]);
+			}
+		}
+		else {
+			WIDE_VECTOR_LOOP {
+				wideStore(wide->r[dst] + i, wideBlend(wideLoad(wide->mask + i), wideLoad(wide->r[src] + i), wideLoad(wide->r[dst] + i)));
+			}
+		}
+	}
+	else if (opcode >= ADD_B && opcode <= CMP_A) {
+		if (src == WIDE_REG_M) {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					wide->operand[i] = WIDE_READ(i, WIDE_HL(i));
+			}
+		}
+		else {
+			memcpy(wide->operand, wide->r[src], WIDE_LANES);
+		}
+		wideAlu(wide, dst, false);
+	}
+	else if ((opcode & 0xC7) == ADI) {
+		memset(wide->operand, byte1, WIDE_LANES);
+		wideAlu(wide, dst, true);
+	}
+	else if ((opcode & 0xC7) == MVI_B) {
+		if (dst == WIDE_REG_M) {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					WIDE_WRITE(i, WIDE_HL(i), byte1);
+			}
+		}
+		else {
+			WIDE_VECTOR_LOOP {
+				wideStore(wide->r[dst] + i, wideBlend(wideLoad(wide->mask + i), wideSplat(byte1), wideLoad(wide->r[dst] + i)));
+			}
+		}
+	}
+	else if ((opcode & 0xC6) == INR_B) {
+		// INR and DCR, ac as the interpreter sets it: INR and DCR M on a zero low nibble, DCR on anything but 0xF
+		bool decrement = opcode & 1;
+		uint8_t keep = (uint8_t)~(FLAG_S | FLAG_Z | FLAG_AC | FLAG_P);
+		if (dst == WIDE_REG_M) {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (!wide->mask[i])
+					continue;
+				uint8_t v = WIDE_READ(i, WIDE_HL(i)) + (decrement ? -1 : 1);
+				wide->psw[i] = (wide->psw[i] & keep) | i8080_zspTable[v] | ((v & 0xF) == 0 ? FLAG_AC : 0);
+				WIDE_WRITE(i, WIDE_HL(i), v);
+			}
+		}
+		else {
+			WIDE_VECTOR_LOOP {
+				wideVec mask = wideLoad(wide->mask + i);
+				wideVec v = wideLoad(wide->r[dst] + i);
+				v = decrement ? wideSub(v, wideSplat(1)) : wideAdd(v, wideSplat(1));
+				wideVec ac = wideEq(wideAnd(v, wideSplat(0xF)), wideSplat(decrement ? 0xF : 0));
+				ac = decrement ? wideAndNot(ac, wideSplat(FLAG_AC)) : wideAnd(ac, wideSplat(FLAG_AC));
+				wideVec psw = wideLoad(wide->psw + i);
+				wideVec flags = wideOr(wideOr(wideAnd(psw, wideSplat(keep)), wideZsp(v)), ac);
+				wideStore(wide->psw + i, wideBlend(mask, flags, psw));
+				wideStore(wide->r[dst] + i, wideBlend(mask, v, wideLoad(wide->r[dst] + i)));
+			}
+		}
+	}
+	else if ((opcode & 0xCF) == LXI_B || (opcode & 0xC7) == INX_B || (opcode & 0xCF) == DAD_B) {
+		// LXI, INX, DCX and DAD, SP in place of a pair for the last pair field
+		WIDE_LANE_LOOP {
+			uint16_t pair = rp == 3 ? wide->sp[i] : WIDE_PAIR(rp, i);
+			uint32_t sum = 0;
+			if ((opcode & 0xCF) == LXI_B)
+				pair = address;
+			else if ((opcode & 0xCF) == INX_B)
+				pair = pair + 1;
+			else if ((opcode & 0xCF) == DCX_B)
+				pair = pair - 1;
+			else {
+				sum = (uint32_t)WIDE_HL(i) + pair;
+				wide->psw[i] = WIDE_BLEND(i, (wide->psw[i] & ~FLAG_C) | (uint8_t)(sum >> 16), wide->psw[i]);
+				wide->r[4][i] = WIDE_BLEND(i, (uint8_t)(sum >> 8), wide->r[4][i]);
+				wide->r[5][i] = WIDE_BLEND(i, (uint8_t)sum, wide->r[5][i]);
+				continue;
+			}
+			if (rp == 3) {
+				wide->sp[i] = WIDE_BLEND(i, pair, wide->sp[i]);
+			}
+			else {
+				wide->r[rp * 2][i] = WIDE_BLEND(i, (uint8_t)(pair >> 8), wide->r[rp * 2][i]);
+				wide->r[rp * 2 + 1][i] = WIDE_BLEND(i, (uint8_t)pair, wide->r[rp * 2 + 1][i]);
+			}
+		}
+	}
+	else if ((opcode & 0xCF) == PUSH_B) {
+		for (int i = 0; i < WIDE_LANES; i++) {
+			if (!wide->mask[i])
+				continue;
+			uint16_t v = rp == 3 ? ((uint16_t)wide->r[WIDE_REG_A][i] << 8) | wide->psw[i] : WIDE_PAIR(rp, i);
+			WIDE_WRITE(i, wide->sp[i] - 1, v >> 8);
+			WIDE_WRITE(i, wide->sp[i] - 2, v & 0xFF);
+			wide->sp[i] -= 2;
+		}
+	}
+	else if ((opcode & 0xCF) == POP_B) {
+		for (int i = 0; i < WIDE_LANES; i++) {
+			if (!wide->mask[i])
+				continue;
+			uint8_t low = WIDE_READ(i, wide->sp[i]);
+			uint8_t high = WIDE_READ(i, wide->sp[i] + 1);
+			wide->sp[i] += 2;
+			if (rp == 3) {
+				wide->r[WIDE_REG_A][i] = high;
+				wide->psw[i] = (low & FLAG_MASK) | FLAG_ONE;
+			}
+			else {
+				wide->r[rp * 2][i] = high;
+				wide->r[rp * 2 + 1][i] = low;
+			}
+		}
+	}
+	else if (opcode == JMP || (opcode & 0xC7) == JNZ) {
+		if (opcode != JMP)
+			wideCondition(wide, dst);
+		WIDE_LANE_LOOP {
+			wide->pc[i] = WIDE_BLEND(i, wide->taken[i] ? address : (uint16_t)(wide->pc[i] + length), wide->pc[i]);
+			wide->taken[i] = 0xFF; // a jump costs the same taken or not
+		}
+		jumps = true;
+	}
+	else if (opcode == CALL || (opcode & 0xC7) == CNZ) {
+		if (opcode != CALL)
+			wideCondition(wide, dst);
+		for (int i = 0; i < WIDE_LANES; i++) {
+			if (!wide->mask[i])
+				continue;
+			uint16_t next = wide->pc[i] + length;
+			if (wide->taken[i]) {
+				WIDE_WRITE(i, wide->sp[i] - 1, next >> 8);
+				WIDE_WRITE(i, wide->sp[i] - 2, next & 0xFF);
+				wide->sp[i] -= 2;
+				next = address;
+			}
+			wide->pc[i] = next;
+		}
+		jumps = true;
+	}
+	else if (opcode == RET || (opcode & 0xC7) == RNZ) {
+		// Ends the interrupt of the machine as i8080op_executeRET does
+		if (opcode != RET)
+			wideCondition(wide, dst);
+		for (int i = 0; i < WIDE_LANES; i++) {
+			if (!wide->mask[i])
+				continue;
+			if (wide->taken[i]) {
+				uint8_t low = WIDE_READ(i, wide->sp[i]);
+				uint8_t high = WIDE_READ(i, (uint16_t)(wide->sp[i] + 1));
+				wide->sp[i] += 2;
+				wide->pc[i] = ((uint16_t)high << 8) | low;
+				wide->machines[i]->f.isi = 0;
+			}
+			else {
+				wide->pc[i] += length;
+			}
+		}
+		jumps = true;
+	}
+	else if ((opcode & 0xC7) == RST_0) {
+		for (int i = 0; i < WIDE_LANES; i++) {
+			if (!wide->mask[i])
+				continue;
+			uint16_t next = wide->pc[i] + length;
+			WIDE_WRITE(i, wide->sp[i] - 1, next >> 8);
+			WIDE_WRITE(i, wide->sp[i] - 2, next & 0xFF);
+			wide->sp[i] -= 2;
+			wide->pc[i] = opcode & 0x38;
+		}
+		jumps = true;
+	}
+	else if (opcode == PCHL) {
+		WIDE_LANE_LOOP {
+			wide->pc[i] = WIDE_BLEND(i, WIDE_HL(i), wide->pc[i]);
+		}
+		jumps = true;
+	}
+	else if (opcode == SPHL) {
+		WIDE_LANE_LOOP {
+			wide->sp[i] = WIDE_BLEND(i, WIDE_HL(i), wide->sp[i]);
+		}
+	}
+	else {
+		uint8_t* a = wide->r[WIDE_REG_A];
+		uint8_t* psw = wide->psw;
+		switch (opcode) {
+		case NOP:
+			break;
+		case STAX_B:
+		case STAX_D:
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					WIDE_WRITE(i, WIDE_PAIR(rp, i), a[i]);
+			}
+			break;
+		case LDAX_B:
+		case LDAX_D:
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					a[i] = WIDE_READ(i, WIDE_PAIR(rp, i));
+			}
+			break;
+		case STA:
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					WIDE_WRITE(i, address, a[i]);
+			}
+			break;
+		case LDA:
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (wide->mask[i])
+					a[i] = WIDE_READ(i, address);
+			}
+			break;
+		case SHLD:
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (!wide->mask[i])
+					continue;
+				WIDE_WRITE(i, address, wide->r[5][i]);
+				WIDE_WRITE(i, (uint16_t)(address + 1), wide->r[4][i]);
+			}
+			break;
+		case LHLD:
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (!wide->mask[i])
+					continue;
+				wide->r[5][i] = WIDE_READ(i, address);
+				wide->r[4][i] = WIDE_READ(i, (uint16_t)(address + 1));
+			}
+			break;
+		case RLC:
+		case RRC:
+		case RAL:
+		case RAR:
+		case CMA:
+		case STC:
+		case CMC:
+			WIDE_VECTOR_LOOP {
+				wideVec mask = wideLoad(wide->mask + i);
+				wideVec va = wideLoad(a + i);
+				wideVec vpsw = wideLoad(psw + i);
+				wideVec carry = wideAnd(vpsw, wideSplat(FLAG_C));
+				wideVec result = va;
+				switch (opcode) {
+				case RLC: // the carry and bit 0 take bit 7
+					carry = WIDE_SHR(va, 7);
+					result = wideOr(WIDE_SHL(va, 1), carry);
+					break;
+				case RRC: // the carry and bit 7 take bit 0
+					carry = wideAnd(va, wideSplat(1));
+					result = wideOr(WIDE_SHR(va, 1), WIDE_SHL(carry, 7));
+					break;
+				case RAL: // through the carry
+					result = wideOr(WIDE_SHL(va, 1), carry);
+					carry = WIDE_SHR(va, 7);
+					break;
+				case RAR: // bit 7 stays as it was
+					result = wideOr(WIDE_SHR(va, 1), wideAnd(va, wideSplat(0x80)));
+					carry = wideAnd(va, wideSplat(1));
+					break;
+				case CMA:
+					result = wideXor(va, wideSplat(0xFF));
+					break;
+				case STC:
+					carry = wideSplat(FLAG_C);
+					break;
+				case CMC:
+					carry = wideXor(carry, wideSplat(FLAG_C));
+					break;
+				}
+				wideStore(a + i, wideBlend(mask, result, va));
+				wideStore(psw + i, wideBlend(mask, wideOr(wideAnd(vpsw, wideSplat((uint8_t)~FLAG_C)), carry), vpsw));
+			}
+			break;
+		case XCHG:
+			WIDE_VECTOR_LOOP {
+				wideVec mask = wideLoad(wide->mask + i);
+				wideVec d = wideLoad(wide->r[2] + i);
+				wideVec e = wideLoad(wide->r[3] + i);
+				wideVec h = wideLoad(wide->r[4] + i);
+				wideVec l = wideLoad(wide->r[5] + i);
+				wideStore(wide->r[2] + i, wideBlend(mask, h, d));
+				wideStore(wide->r[3] + i, wideBlend(mask, l, e));
+				wideStore(wide->r[4] + i, wideBlend(mask, d, h));
+				wideStore(wide->r[5] + i, wideBlend(mask, e, l));
+			}
+			break;
+		default:
+			// Ports, interrupt enables, HLT, XTHL, DAA and the undocumented opcodes go to the scalar core
+			return false;
+		}
+	}
+
+	if (!jumps) {
+		WIDE_LANE_LOOP {
+			wide->pc[i] = WIDE_BLEND(i, (uint16_t)(wide->pc[i] + length), wide->pc[i]);
+		}
+	}
+	return true;
+}
+
+bool i8080_wideInit(i8080Wide* wide, i8080State** machines, int lanes) {
+	if (lanes < 0 || lanes > WIDE_LANES) {
+		log_error("Wide core asked for %i lanes, it has %i", lanes, WIDE_LANES);
+		return false;
+	}
+
+	memset(wide, 0, sizeof(i8080Wide));
+	wide->lanes = lanes;
+	for (int i = 0; i < lanes; i++)
+		wide->machines[i] = machines[i];
+	return true;
+}
+
+long i8080_runWide(i8080Wide* wide, int cycleBudget) {
+	int used[WIDE_LANES];
+	uint8_t running[WIDE_LANES]; // 0xFF for the lanes still running, 0 for the rest
+	uint8_t opcodes[WIDE_LANES] = { 0 };
+	uint8_t bytes1[WIDE_LANES] = { 0 };
+	uint8_t bytes2[WIDE_LANES] = { 0 };
+	unsigned int periods[WIDE_LANES];
+	// Lanes whose instruction bytes have to be fetched again: all of them at first, then the ones that ran or took an interrupt.
+	// Memory only changes under a lane's own instructions, so one that sat a step out still has its bytes
+	uint8_t stale[WIDE_LANES];
+	memset(stale, 0xFF, WIDE_LANES);
+
+	for (int i = 0; i < WIDE_LANES; i++) {
+		used[i] = 0;
+		running[i] = i < wide->lanes ? 0xFF : 0;
+		if (!running[i])
+			continue;
+		periods[i] = wide->machines[i]->bus->board->interruptPeriod;
+
+		// Finish off any instruction a previous i8080_cpuTick left part way through, as i8080_run does
+		i8080State* state = wide->machines[i];
+		used[i] = state->waitCycles;
+		wideLoadLane(wide, i);
+		wide->accumulator[i] += state->waitCycles;
+		state->waitCycles = 0;
+		if (state->mode == MODE_HLT && !wideSleep(wide, i, used, cycleBudget))
+			running[i] = 0;
+	}
+
+	for (;;) {
+		// Each lane takes its own frame interrupt before its next instruction, the lane furthest behind leads the step
+		int leader = -1;
+		for (int i = 0; i < wide->lanes; i++) {
+			if (running[i] && used[i] >= cycleBudget)
+				running[i] = 0;
+			if (!running[i])
+				continue;
+			if (wide->accumulator[i] >= periods[i]) {
+				wideInterrupt(wide, i);
+				stale[i] = 0xFF;
+			}
+			if (stale[i])
+				opcodes[i] = i8080_fetchAt(wide->machines[i], wide->pc[i], &bytes1[i], &bytes2[i]);
+			if (leader == -1 || used[i] < used[leader])
+				leader = i;
+		}
+		if (leader == -1)
+			break;
+
+		// Every lane on the same instruction bytes joins the step, wherever its pc is
+		uint8_t opcode = opcodes[leader];
+		uint8_t byte1 = bytes1[leader];
+		uint8_t byte2 = bytes2[leader];
+		WIDE_VECTOR_LOOP {
+			wideVec same = wideAnd(wideEq(wideLoad(opcodes + i), wideSplat(opcode)), wideEq(wideLoad(bytes1 + i), wideSplat(byte1)));
+			same = wideAnd(same, wideEq(wideLoad(bytes2 + i), wideSplat(byte2)));
+			wideStore(wide->mask + i, wideAnd(same, wideLoad(running + i)));
+		}
+		memcpy(stale, wide->mask, WIDE_LANES);
+
+		if (wideExecute(wide, opcode, byte1, byte2)) {
+			int cycles = i8080_getInstructionClockCycles(opcode);
+			int failedCycles = i8080_getFailedInstructionClockCycles(opcode);
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (!wide->mask[i])
+					continue;
+				int laneCycles = wide->taken[i] ? cycles : failedCycles;
+				used[i] += laneCycles;
+				wide->accumulator[i] += laneCycles;
+				wide->laneInstructions++;
+			}
+		}
+		else {
+			for (int i = 0; i < WIDE_LANES; i++) {
+				if (!wide->mask[i])
+					continue;
+				int laneCycles = widePeel(wide, i);
+				used[i] += laneCycles;
+				wide->accumulator[i] += laneCycles;
+
+				// A halted lane sleeps as i8080_run would, a panicked one stops
+				i8080State* state = wide->machines[i];
+				if ((state->mode == MODE_HLT && !wideSleep(wide, i, used, cycleBudget)) || state->mode == MODE_PANIC)
+					running[i] = 0;
+			}
+		}
+		wide->steps++;
+	}
+
+	long cyclesUsed = 0;
+	for (int i = 0; i < wide->lanes; i++) {
+		wideStoreLane(wide, i);
+		wide->machines[i]->cyclesExecuted += used[i];
+		cyclesUsed += used[i];
+	}
+
+	return cyclesUsed;
+}
@@ -0,0 +1,50 @@
+#pragma once
+/*
+
+i8080_wide.h
+
+Wide core. Runs up to WIDE_LANES independent machines side by side with their registers laid out one array per register,
+one entry per machine. Each step picks the lane furthest behind and runs its instruction on every lane sitting on the same
+instruction bytes, with a mask for the lanes that are not, so lanes that branch apart regroup wherever their code meets
+again. The 8 bit register and flag work runs on 16 lanes a vector with SSE2 or NEON intrinsics when WIDE_LANES is a
+multiple of 16, and the same code one lane at a time otherwise. Ports, EI/DI, HLT, XTHL, DAA and the undocumented opcodes
+are peeled off to the scalar core of each machine one lane at a time
+
+*/
+
+#include "i8080.h"
+
+// Lanes per wide core, anything from 8 to 32 can be set in the preprocessor definitions of the project
+#ifndef WIDE_LANES
+#define WIDE_LANES 16
+#endif
+
+typedef struct i8080Wide {
+	int lanes; // machines in use, up to WIDE_LANES
+	i8080State* machines[WIDE_LANES]; // memory, ports, interrupt enable and mode stay in the machine
+
+	// Registers of every lane, loaded from the machines at the start of i8080_runWide and stored back at the end
+	uint8_t r[8][WIDE_LANES]; // indexed by the 3 bit register field of the opcode, B C D E H L (M) A. Row 6 is unused
+	uint8_t psw[WIDE_LANES];
+	uint16_t pc[WIDE_LANES];
+	uint16_t sp[WIDE_LANES];
+
+	// Cycles since the last frame interrupt of every lane, loaded and stored with the registers
+	unsigned int accumulator[WIDE_LANES];
+
+	// Scratch for one step
+	uint8_t mask[WIDE_LANES]; // 0xFF for the lanes running this instruction, 0 for the rest
+	uint8_t operand[WIDE_LANES]; // the ALU operand of each lane
+	uint8_t taken[WIDE_LANES]; // 0 for the lanes whose conditional call fell through, so they take the failed cycle count
+
+	// Counters, never cleared by the core
+	unsigned long steps; // instructions run as a group, however many lanes were in it
+	unsigned long laneInstructions; // instructions run by lanes inside a group
+	unsigned long peeled; // instructions handed to the scalar core
+} i8080Wide;
+
+// Sets the wide core up over the machines, which must stay allocated while it runs. The lanes start with no interrupt pending. Returns false if there are more than WIDE_LANES
+bool i8080_wideInit(i8080Wide* wide, i8080State** machines, int lanes);
+
+// Runs every lane for cycleBudget cycles, as i8080_run would run each machine on its own with its own interrupt timing. A halted lane sleeps until its next interrupt as i8080_run does, and stops early if none can wake it or it panics. Returns the cycles run over all lanes
+long i8080_runWide(i8080Wide* wide, int cycleBudget);